@@ -16,6 +16,7 @@
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 
+#include <AudioInjectorManager.h>
 #include <AvatarHashMap.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
@@ -47,6 +48,7 @@ Agent::Agent(const QByteArray& packet) :
 
     DependencyManager::set<ResourceCacheSharedItems>();
     DependencyManager::set<SoundCache>();
+    DependencyManager::set<AudioInjectorManager>();
 }
 
 void Agent::readPendingDatagrams() {
@@ -216,4 +218,7 @@ void Agent::aboutToFinish() {
     
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
     DependencyManager::get<EntityScriptingInterface>()->setEntityTree(NULL);
+
+    // stop the injector thread while the node list it sends through is still around
+    DependencyManager::destroy<AudioInjectorManager>();
 }
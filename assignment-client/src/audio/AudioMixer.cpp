@@ -36,6 +36,8 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonValue>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
 #include <QtCore/QThread>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
@@ -46,10 +48,12 @@
 #include <Node.h>
 #include <OctreeConstants.h>
 #include <PacketHeaders.h>
+#include <PerfStat.h>
 #include <SharedUtil.h>
 #include <StDev.h>
 #include <UUID.h>
 
+#include "AudioMixKernels.h"
 #include "AudioRingBuffer.h"
 #include "AudioMixerClientData.h"
 #include "AudioMixerDatagramProcessor.h"
@@ -61,6 +65,7 @@
 const float LOUDNESS_TO_DISTANCE_RATIO = 0.00001f;
 const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.18f;
 const float DEFAULT_NOISE_MUTING_THRESHOLD = 0.003f;
+const float AUDIBLE_SOURCE_GRID_CELL_SIZE = 8.0f; // meters
 const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
@@ -87,6 +92,10 @@ AudioMixer::AudioMixer(const QByteArray& packet) :
     _sumMixes(0),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
+    _nextListenerToMix(0),
+    _numMixThreads(std::max(QThread::idealThreadCount(), 1)),
+    _audibleSourceGrid(AUDIBLE_SOURCE_GRID_CELL_SIZE),
+    _maxFrameSourceLoudness(0.0f),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _timeSpentPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _timeSpentPerHashMatchCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -99,40 +108,18 @@ AudioMixer::AudioMixer(const QByteArray& packet) :
 const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
 const float RADIUS_OF_HEAD = 0.076f;
 
-int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                         const QUuid& streamUUID,
-                                                         PositionalAudioStream* streamToAdd,
-                                                         AvatarAudioStream* listeningNodeStream) {
-    // If repetition with fade is enabled:
-    // If streamToAdd could not provide a frame (it was starved), then we'll mix its previously-mixed frame
-    // This is preferable to not mixing it at all since that's equivalent to inserting silence.
-    // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
-    // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
-    // This improves the perceived quality of the audio slightly.
+int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerBuffers& buffers,
+                                                         AudioMixerClientData* listenerNodeData,
+                                                         const AudioMixerSource& source,
+                                                         AvatarAudioStream* listeningNodeStream,
+                                                         const QVector<bool>& listenerZoneSettings) {
+    PositionalAudioStream* streamToAdd = source.stream;
 
-    bool showDebug = false;  // (randFloat() < 0.05f);
-
-    float repeatedFrameFadeFactor = 1.0f;
+    // the source was prepared for this frame by prepareSourcesForFrame, so we know it has a frame to mix that isn't
+    // silent, and if it's a repeat of its last frame, how much to fade it
+    float repeatedFrameFadeFactor = source.repeatedFrameFadeFactor;
 
-    if (!streamToAdd->lastPopSucceeded()) {
-        if (_streamSettings._repetitionWithFade && !streamToAdd->getLastPopOutput().isNull()) {
-            // reptition with fade is enabled, and we do have a valid previous frame to repeat.
-            // calculate its fade factor, which depends on how many times it's already been repeated.
-            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(streamToAdd->getConsecutiveNotMixedCount() - 1);
-            if (repeatedFrameFadeFactor == 0.0f) {
-                return 0;
-            }
-        } else {
-            return 0;
-        }
-    }
-
-    // at this point, we know streamToAdd's last pop output is valid
-
-    // if the frame we're about to mix is silent, bail
-    if (streamToAdd->getLastPopOutputLoudness() == 0.0f) {
-        return 0;
-    }
+    bool showDebug = false;  // (randFloat() < 0.05f);
 
     float bearingRelativeAngleToSource = 0.0f;
     float attenuationCoefficient = 1.0f;
@@ -156,8 +143,6 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         return 0;
     }
 
-    ++_sumMixes;
-
     if (streamToAdd->getType() == PositionalAudioStream::Injector) {
         attenuationCoefficient *= reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
         if (showDebug) {
@@ -193,11 +178,12 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         attenuationCoefficient *= offAxisCoefficient;
     }
 
+    // the first zone setting whose source zone holds the source and whose listener zone holds the listener applies
     float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
-    for (int i = 0; i < _zonesSettings.length(); ++i) {
-        if (_audioZones[_zonesSettings[i].source].contains(streamToAdd->getPosition()) &&
-            _audioZones[_zonesSettings[i].listener].contains(listeningNodeStream->getPosition())) {
-            attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
+    for (int i = source.firstZoneSetting; i <= source.lastZoneSetting; ++i) {
+        int zoneSetting = _frameSourceZoneSettings[i];
+        if (listenerZoneSettings[zoneSetting]) {
+            attenuationPerDoublingInDistance = _zonesSettings[zoneSetting].coefficient;
             break;
         }
     }
@@ -250,7 +236,7 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         qDebug() << "bearingRelativeAngleToSource: " << bearingRelativeAngleToSource << " numSamplesDelay: " << numSamplesDelay;
     }
 
-    AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd->getLastPopOutput();
+    const int16_t* sourceSamples = _frameSourceSamples.constData() + source.firstSample;
 
     if (!streamToAdd->isStereo()) {
         // this is a mono stream, which means it gets full attenuation and spatialization
@@ -267,7 +253,6 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         // Mono input to stereo output (item 1 above)
         int OUTPUT_SAMPLES_PER_INPUT_SAMPLE = 2;
         int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        int maxOutputIndex = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
 
         // attenuation and fade applied to all samples (item 2 above)
         float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
@@ -275,81 +260,25 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         // determine which side is weak and delayed (item 3 above)
         bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
 
-        // since we're converting from mono to stereo, we'll use these two indices to step through
-        // the output samples. we'll increment each index independently in the loop
-        int leftDestinationIndex = 0;
-        int rightDestinationIndex = 1;
-
-        // One of our two channels will be delayed (determined below). We'll use this index to step
-        // through filling in our output with the historical samples for the delayed channel.  (item 4 above)
-        int delayedChannelHistoricalAudioOutputIndex;
-
-        // All samples will be attenuated by at least this much
-        float leftSideAttenuation = attenuationAndFade;
-        float rightSideAttenuation = attenuationAndFade;
-
         // The weak/delayed channel will be attenuated by this additional amount
         float attenuationAndWeakChannelRatioAndFade = attenuationAndFade * weakChannelAmplitudeRatio;
 
-        // Now, based on the determination of which side is weak and delayed, set up our true starting point
-        // for our indexes, as well as the appropriate attenuation for each channel
-        if (rightSideWeakAndDelayed) {
-            delayedChannelHistoricalAudioOutputIndex = rightDestinationIndex;
-            rightSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            rightDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        } else {
-            delayedChannelHistoricalAudioOutputIndex = leftDestinationIndex;
-            leftSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            leftDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        }
-
-        // If there was a sample delay for this stream, we need to pull samples prior to the official start of the input
-        // and stick those samples at the beginning of the output. We only need to loop through this for the weak/delayed
-        // side, since the normal side is fully handled below. (item 4 above)
-        if (numSamplesDelay > 0) {
-
-            // TODO: delayStreamSourceSamples may be inside the last frame written if the ringbuffer is completely full
-            // maybe make AudioRingBuffer have 1 extra frame in its buffer
-            AudioRingBuffer::ConstIterator delayStreamSourceSamples = streamPopOutput - numSamplesDelay;
-
-            for (int i = 0; i < numSamplesDelay; i++) {
-                int16_t originalHistoricalSample = *delayStreamSourceSamples;
-
-                _preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample
-                                                                                 * attenuationAndWeakChannelRatioAndFade;
-                ++delayStreamSourceSamples; // move our input pointer
-                delayedChannelHistoricalAudioOutputIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE; // move our output sample
-            }
-        }
-
-        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation
-        for (int inputSample = 0; inputSample < inputSampleCount; inputSample++) {
-            int16_t originalSample = streamPopOutput[inputSample];
-            int16_t leftSideSample = originalSample * leftSideAttenuation;
-            int16_t rightSideSample = originalSample * rightSideAttenuation;
+        float leftSideAttenuation = rightSideWeakAndDelayed ? attenuationAndFade : attenuationAndWeakChannelRatioAndFade;
+        float rightSideAttenuation = rightSideWeakAndDelayed ? attenuationAndWeakChannelRatioAndFade : attenuationAndFade;
+        int leftSideDelay = rightSideWeakAndDelayed ? 0 : numSamplesDelay;
+        int rightSideDelay = rightSideWeakAndDelayed ? numSamplesDelay : 0;
 
-            // since we might be delayed, don't write beyond our maxOutputIndex
-            if (leftDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[leftDestinationIndex] += leftSideSample;
-            }
-            if (rightDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[rightDestinationIndex] += rightSideSample;
-            }
-
-            leftDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-            rightDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        }
+        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation.
+        // The delayed channel starts with the samples from before the official start of the input, which were copied
+        // ahead of it (item 4 above)
+        AudioMixKernels::spreadMonoToStereo(buffers.preMixSamples, sourceSamples, inputSampleCount,
+                                            leftSideAttenuation, leftSideDelay, rightSideAttenuation, rightSideDelay);
 
     } else {
-        int stereoDivider = streamToAdd->isStereo() ? 1 : 2;
-
-       float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+        float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
 
-        for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-            _preMixSamples[s] = glm::clamp(_preMixSamples[s] + (int)(streamPopOutput[s / stereoDivider] * attenuationAndFade),
-                                            AudioConstants::MIN_SAMPLE_VALUE,
-                                           AudioConstants::MAX_SAMPLE_VALUE);
-        }
+        AudioMixKernels::accumulateWithGain(buffers.preMixSamples, sourceSamples, attenuationAndFade,
+                                            AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
     }
 
     if (!sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter()) {
@@ -407,59 +336,179 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         }
 
         // Get our per listener/source data so we can get our filter
-        AudioFilterHSF1s& penumbraFilter = listenerNodeData->getListenerSourcePairData(streamUUID)->getPenumbraFilter();
+        AudioFilterHSF1s& penumbraFilter = listenerNodeData->getListenerSourcePairData(source.streamUUID)->getPenumbraFilter();
 
         // set the gain on both filter channels
         penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
         penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
-        penumbraFilter.render(_preMixSamples, _preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
+        penumbraFilter.render(buffers.preMixSamples, buffers.preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
     }
 
-    // Actually mix the _preMixSamples into the _mixSamples here.
-    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-        _mixSamples[s] = glm::clamp(_mixSamples[s] + _preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
-                                    AudioConstants::MAX_SAMPLE_VALUE);
-    }
+    // Actually mix the preMixSamples into the mixSamples here.
+    AudioMixKernels::accumulate(buffers.mixSamples, buffers.preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
     return 1;
 }
 
-int AudioMixer::prepareMixForListeningNode(Node* node) {
+int AudioMixer::prepareMixForListeningNode(Node* node, AudioMixerBuffers& buffers) {
     AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
     AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
 
     // zero out the client mix for this node
-    memset(_preMixSamples, 0, sizeof(_preMixSamples));
-    memset(_mixSamples, 0, sizeof(_mixSamples));
+    memset(buffers.preMixSamples, 0, sizeof(buffers.preMixSamples));
+    memset(buffers.mixSamples, 0, sizeof(buffers.mixSamples));
 
     // loop through all other nodes that have sufficient audio to mix
     int streamsMixed = 0;
 
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        if (otherNode->getLinkedData()) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
+    // no source can be heard from further away than the loudest source of this frame at the audibility threshold,
+    // so only the sources in the grid cells within that distance need to be considered
+    float maxAudibleDistance = _maxFrameSourceLoudness / _minAudibilityThreshold;
 
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
+    // which zones hold the listener is the same for all of its sources
+    QVector<bool> listenerZoneSettings(_zonesSettings.size());
+    for (int i = 0; i < _zonesSettings.size(); ++i) {
+        listenerZoneSettings[i] = _audioZones.value(_zonesSettings[i].listener).contains(nodeAudioStream->getPosition());
+    }
 
-            const QHash<QUuid, PositionalAudioStream*>& otherNodeAudioStreams = otherNodeClientData->getAudioStreams();
-            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
-            for (i = otherNodeAudioStreams.constBegin(); i != otherNodeAudioStreams.constEnd(); i++) {
-                PositionalAudioStream* otherNodeStream = i.value();
-                QUuid streamUUID = i.key();
+    // we may be on a mixing thread, so this only reads the grid of sources built for this frame
+    _audibleSourceGrid.eachWithinRadius(nodeAudioStream->getPosition(), maxAudibleDistance,
+                                        [&](const AudioMixerSource& source, const glm::vec3& position, float distance) {
+        if (source.node != node || source.stream->shouldLoopbackForNode()) {
+            streamsMixed += addStreamToMixForListeningNodeWithStream(buffers, listenerNodeData, source,
+                                                                     nodeAudioStream, listenerZoneSettings);
+        }
+    });
+
+    return streamsMixed;
+}
 
-                if (otherNodeStream->getType() == PositionalAudioStream::Microphone) {
-                    streamUUID = otherNode->getUUID();
+void AudioMixer::prepareSourcesForFrame() {
+    PerformanceTimer perfTimer("prepareSourcesForFrame");
+
+    _audibleSourceGrid.clear();
+    _maxFrameSourceLoudness = 0.0f;
+    _frameSourceSamples.resize(0);
+    _frameSourceZoneSettings.resize(0);
+
+    foreach (const SharedNodePointer& node, _frameNodes) {
+        AudioMixerClientData* nodeData = (AudioMixerClientData*) node->getLinkedData();
+
+        const QHash<QUuid, PositionalAudioStream*>& audioStreams = nodeData->getAudioStreams();
+        QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
+        for (i = audioStreams.constBegin(); i != audioStreams.constEnd(); i++) {
+            PositionalAudioStream* stream = i.value();
+
+            // If repetition with fade is enabled:
+            // If the stream could not provide a frame (it was starved), then we'll mix its previously-mixed frame
+            // This is preferable to not mixing it at all since that's equivalent to inserting silence.
+            // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
+            // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
+            // This improves the perceived quality of the audio slightly.
+            float repeatedFrameFadeFactor = 1.0f;
+            if (!stream->lastPopSucceeded()) {
+                if (!_streamSettings._repetitionWithFade || stream->getLastPopOutput().isNull()) {
+                    continue;
+                }
+                repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(stream->getConsecutiveNotMixedCount() - 1);
+                if (repeatedFrameFadeFactor == 0.0f) {
+                    continue;
                 }
+            }
+
+            // if the frame we're about to mix is silent, skip the stream
+            if (stream->getLastPopOutputLoudness() == 0.0f) {
+                continue;
+            }
 
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, streamUUID,
-                                                                             otherNodeStream, nodeAudioStream);
+            AudioMixerSource source;
+            source.node = node.data();
+            source.stream = stream;
+            source.streamUUID = (stream->getType() == PositionalAudioStream::Microphone) ? node->getUUID() : i.key();
+            source.repeatedFrameFadeFactor = repeatedFrameFadeFactor;
+
+            // copy the frame out of the ring buffer once for all of the listeners, mono frames along with the samples
+            // before them that a phase delay can reach back to
+            // TODO: the samples before the frame may be inside the last frame written if the ringbuffer is completely
+            // full, maybe make AudioRingBuffer have 1 extra frame in its buffer
+            AudioRingBuffer::ConstIterator streamPopOutput = stream->getLastPopOutput();
+            int numSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+            if (!stream->isStereo()) {
+                streamPopOutput = streamPopOutput - SAMPLE_PHASE_DELAY_AT_90;
+                numSamples = SAMPLE_PHASE_DELAY_AT_90 + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+            }
+            int firstCopiedSample = _frameSourceSamples.size();
+            _frameSourceSamples.resize(firstCopiedSample + numSamples);
+            streamPopOutput.readSamples(_frameSourceSamples.data() + firstCopiedSample, numSamples);
+            source.firstSample = firstCopiedSample + (stream->isStereo() ? 0 : SAMPLE_PHASE_DELAY_AT_90);
+
+            // note the zone settings that apply to the stream as a source, so listeners only check their own zones
+            source.firstZoneSetting = _frameSourceZoneSettings.size();
+            for (int j = 0; j < _zonesSettings.size(); ++j) {
+                if (_audioZones.value(_zonesSettings[j].source).contains(stream->getPosition())) {
+                    _frameSourceZoneSettings.append(j);
                 }
             }
+            source.lastZoneSetting = _frameSourceZoneSettings.size() - 1;
+
+            _audibleSourceGrid.insert(stream->getPosition(), source);
+            _maxFrameSourceLoudness = std::max(_maxFrameSourceLoudness, stream->getLastPopOutputTrailingLoudness());
         }
-    });
+    }
+}
 
-    return streamsMixed;
+class AudioMixerWorker : public QRunnable {
+public:
+    AudioMixerWorker(AudioMixer* mixer, AudioMixerBuffers& buffers, QSemaphore& finished) :
+        _mixer(mixer),
+        _buffers(buffers),
+        _finished(finished) {}
+
+    virtual void run() {
+        _mixer->mixClaimedListeners(_buffers);
+        _finished.release();
+    }
+
+private:
+    AudioMixer* _mixer;
+    AudioMixerBuffers& _buffers;
+    QSemaphore& _finished;
+};
+
+void AudioMixer::mixListenersForFrame() {
+    PerformanceTimer perfTimer("mixListenersForFrame");
+
+    int numListeners = _frameListeners.size();
+
+    _frameListenerMixes.resize(numListeners * AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+    _frameListenerStreamsMixed.resize(numListeners);
+    _nextListenerToMix.store(0);
+
+    // the frame thread mixes too, so we only need helpers for the remaining threads
+    int numHelpers = qMin(_numMixThreads, numListeners) - 1;
+
+    QSemaphore helpersFinished;
+    for (int i = 1; i <= numHelpers; ++i) {
+        _mixThreadPool.start(new AudioMixerWorker(this, _mixBuffers[i], helpersFinished));
+    }
+
+    mixClaimedListeners(_mixBuffers[0]);
+
+    // join with the helpers before we send, so that every mix for this frame is complete
+    if (numHelpers > 0) {
+        helpersFinished.acquire(numHelpers);
+    }
+}
+
+void AudioMixer::mixClaimedListeners(AudioMixerBuffers& buffers) {
+    int numListeners = _frameListeners.size();
+    int listenerIndex;
+
+    while ((listenerIndex = _nextListenerToMix.fetchAndAddRelaxed(1)) < numListeners) {
+        _frameListenerStreamsMixed[listenerIndex] = prepareMixForListeningNode(_frameListeners[listenerIndex].data(), buffers);
+        memcpy(_frameListenerMixes.data() + (listenerIndex * AudioConstants::NETWORK_FRAME_SAMPLES_STEREO),
+               buffers.mixSamples, AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+    }
 }
 
 void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
@@ -708,6 +757,10 @@ void AudioMixer::run() {
     // check the settings object to see if we have anything we can parse out
     parseSettingsObject(settingsObject);
 
+    // setup the scratch buffers and the helper threads we'll use to mix listeners in parallel
+    _mixBuffers.resize(_numMixThreads);
+    _mixThreadPool.setMaxThreadCount(std::max(_numMixThreads - 1, 1));
+
     int nextFrame = 0;
     QElapsedTimer timer;
     timer.start();
@@ -795,58 +848,84 @@ void AudioMixer::run() {
                     nodeList->writeDatagram(packet, node);
                 }
 
+                _frameNodes.append(node);
+
                 if (node->getType() == NodeType::Agent && node->getActiveSocket()
                     && nodeData->getAvatarAudioStream()) {
+                    _frameListeners.append(node);
+                }
+            }
+        });
 
-                    int streamsMixed = prepareMixForListeningNode(node.data());
-
-                    char* mixDataAt;
-                    if (streamsMixed > 0) {
-                        // pack header
-                        int numBytesMixPacketHeader = nodeList->populatePacketHeader(clientMixBuffer, PacketTypeMixedAudio);
-                        mixDataAt = clientMixBuffer + numBytesMixPacketHeader;
-
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        memcpy(mixDataAt, &sequence, sizeof(quint16));
-                        mixDataAt  += sizeof(quint16);
-
-                        // pack mixed audio samples
-                        memcpy(mixDataAt, _mixSamples, AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                        mixDataAt += AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                    } else {
-                        // pack header
-                        int numBytesPacketHeader = nodeList->populatePacketHeader(clientMixBuffer, PacketTypeSilentAudioFrame);
-                        mixDataAt = clientMixBuffer + numBytesPacketHeader;
-
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        memcpy(mixDataAt, &sequence, sizeof(quint16));
-                        mixDataAt += sizeof(quint16);
-
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        memcpy(mixDataAt, &numSilentSamples, sizeof(quint16));
-                        mixDataAt += sizeof(quint16);
-                    }
-
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
+        // every stream has popped its frame for this frame, prepare the ones that could be heard and index them by position
+        prepareSourcesForFrame();
+
+        // and mix them for all of the listeners
+        mixListenersForFrame();
+
+        // hand every packet for this frame to the kernel together
+        nodeList->beginDatagramBatch();
+
+        for (int listenerIndex = 0; listenerIndex < _frameListeners.size(); ++listenerIndex) {
+            const SharedNodePointer& node = _frameListeners[listenerIndex];
+            AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
+
+            int streamsMixed = _frameListenerStreamsMixed[listenerIndex];
+
+            char* mixDataAt;
+            if (streamsMixed > 0) {
+                // pack header
+                int numBytesMixPacketHeader = nodeList->populatePacketHeader(clientMixBuffer, PacketTypeMixedAudio);
+                mixDataAt = clientMixBuffer + numBytesMixPacketHeader;
+
+                // pack sequence number
+                quint16 sequence = nodeData->getOutgoingSequenceNumber();
+                memcpy(mixDataAt, &sequence, sizeof(quint16));
+                mixDataAt  += sizeof(quint16);
+
+                // pack mixed audio samples
+                memcpy(mixDataAt, _frameListenerMixes.constData() + (listenerIndex * AudioConstants::NETWORK_FRAME_SAMPLES_STEREO),
+                       AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+                mixDataAt += AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+            } else {
+                // pack header
+                int numBytesPacketHeader = nodeList->populatePacketHeader(clientMixBuffer, PacketTypeSilentAudioFrame);
+                mixDataAt = clientMixBuffer + numBytesPacketHeader;
+
+                // pack sequence number
+                quint16 sequence = nodeData->getOutgoingSequenceNumber();
+                memcpy(mixDataAt, &sequence, sizeof(quint16));
+                mixDataAt += sizeof(quint16);
+
+                // pack number of silent audio samples
+                quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+                memcpy(mixDataAt, &numSilentSamples, sizeof(quint16));
+                mixDataAt += sizeof(quint16);
+            }
 
-                    // send mixed audio packet
-                    nodeList->writeDatagram(clientMixBuffer, mixDataAt - clientMixBuffer, node);
-                    nodeData->incrementOutgoingMixedAudioSequenceNumber();
+            // Send audio environment
+            sendAudioEnvironmentPacket(node);
 
-                    // send an audio stream stats packet if it's time
-                    if (_sendAudioStreamStats) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                        _sendAudioStreamStats = false;
-                    }
+            // send mixed audio packet
+            nodeList->writeDatagram(clientMixBuffer, mixDataAt - clientMixBuffer, node);
+            nodeData->incrementOutgoingMixedAudioSequenceNumber();
 
-                    ++_sumListeners;
-                }
+            // send an audio stream stats packet if it's time
+            if (_sendAudioStreamStats) {
+                nodeData->sendAudioStreamStatsPackets(node);
+                _sendAudioStreamStats = false;
             }
-        });
+
+            _sumMixes += streamsMixed;
+            ++_sumListeners;
+        }
+
+        nodeList->sendDatagramBatch();
+
+        // don't hold on to any nodes past this frame
+        _audibleSourceGrid.clear();
+        _frameNodes.clear();
+        _frameListeners.clear();
 
         ++_numStatFrames;
 
@@ -1019,6 +1098,16 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
 
+        const QString MIXING_THREADS = "mixing_threads";
+        if (audioEnvGroupObject[MIXING_THREADS].isString()) {
+            bool ok = false;
+            int numMixThreads = audioEnvGroupObject[MIXING_THREADS].toString().toInt(&ok);
+            if (ok && numMixThreads > 0) {
+                _numMixThreads = numMixThreads;
+            }
+        }
+        qDebug() << "Mixing listeners on" << _numMixThreads << "thread(s)";
+
         const QString FILTER_KEY = "enable_filter";
         if (audioEnvGroupObject[FILTER_KEY].isBool()) {
             _enableFilter = audioEnvGroupObject[FILTER_KEY].toBool();
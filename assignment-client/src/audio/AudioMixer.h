@@ -12,8 +12,11 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <QtCore/QThreadPool>
+
 #include <AABox.h>
 #include <AudioRingBuffer.h>
+#include <SpatialHashGrid.h>
 #include <ThreadedAssignment.h>
 
 class PositionalAudioStream;
@@ -24,6 +27,35 @@ const int SAMPLE_PHASE_DELAY_AT_90 = 20;
 
 const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 
+/// scratch space used to build the mix for a single listener, one set per mixing thread
+struct AudioMixerBuffers {
+    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
+    // data from a phase delay as well as an entire network buffer
+    int16_t preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+
+    // client samples capacity is larger than what will be sent to optimize mixing
+    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
+    int16_t mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+};
+
+/// a stream with a frame to mix, indexed by position in the audible source grid, along with everything about it that
+/// doesn't depend on the listener, worked out once per frame
+struct AudioMixerSource {
+    Node* node;
+    QUuid streamUUID;
+    PositionalAudioStream* stream;
+
+    // offset of the frame in the frame's source samples, mono frames are preceded by the samples needed for phase delay
+    int firstSample;
+
+    // fade applied to a frame being repeated for a starved stream
+    float repeatedFrameFadeFactor;
+
+    // range of the entries in the frame's source zone settings, the zone settings whose source zone holds the stream
+    int firstZoneSetting;
+    int lastZoneSetting;
+};
+
 /// Handles assignments of type AudioMixer - mixing streams of audio and re-distributing to various clients.
 class AudioMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -43,25 +75,30 @@ public slots:
     static const InboundAudioStream::Settings& getStreamSettings() { return _streamSettings; }
 
 private:
-    /// adds one stream to the mix for a listening node
-    int addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                    const QUuid& streamUUID,
-                                                    PositionalAudioStream* streamToAdd,
-                                                    AvatarAudioStream* listeningNodeStream);
+    friend class AudioMixerWorker;
 
-    /// prepares and sends a mix to one Node
-    int prepareMixForListeningNode(Node* node);
+    /// adds one stream to the mix for a listening node, listenerZoneSettings flags the zone settings whose listener zone
+    /// holds the listener
+    int addStreamToMixForListeningNodeWithStream(AudioMixerBuffers& buffers,
+                                                    AudioMixerClientData* listenerNodeData,
+                                                    const AudioMixerSource& source,
+                                                    AvatarAudioStream* listeningNodeStream,
+                                                    const QVector<bool>& listenerZoneSettings);
 
-    /// Send Audio Environment packet for a single node
-    void sendAudioEnvironmentPacket(SharedNodePointer node);
+    /// prepares a mix for one Node in the given buffers, returns the number of streams mixed
+    int prepareMixForListeningNode(Node* node, AudioMixerBuffers& buffers);
 
-    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
-    // data from a phase delay as well as an entire network buffer
-    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    /// prepares every stream with an audible frame for mixing and indexes it by its position
+    void prepareSourcesForFrame();
 
-    // client samples capacity is larger than what will be sent to optimize mixing
-    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
-    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    /// mixes every listener collected for this frame, spread across the mixing threads
+    void mixListenersForFrame();
+
+    /// mixes listeners claimed from _nextListenerToMix until there are none left
+    void mixClaimedListeners(AudioMixerBuffers& buffers);
+
+    /// Send Audio Environment packet for a single node
+    void sendAudioEnvironmentPacket(SharedNodePointer node);
 
     void perSecondActions();
 
@@ -101,6 +138,28 @@ private:
 
     bool _sendAudioStreamStats;
 
+    // one set of scratch buffers per mixing thread, the frame thread always uses the first
+    QVector<AudioMixerBuffers> _mixBuffers;
+
+    // nodes and listeners snapshotted at the start of each frame so mixing threads never touch the NodeHash
+    QVector<SharedNodePointer> _frameNodes;
+    QVector<SharedNodePointer> _frameListeners;
+
+    // output of the mix for each entry in _frameListeners
+    QVector<int16_t> _frameListenerMixes;
+    QVector<int> _frameListenerStreamsMixed;
+    QAtomicInt _nextListenerToMix;
+
+    QThreadPool _mixThreadPool;
+    int _numMixThreads;
+
+    SpatialHashGrid<AudioMixerSource> _audibleSourceGrid;
+    float _maxFrameSourceLoudness;
+
+    // the frames of the sources in the grid copied out of their ring buffers, and the zone settings they match
+    QVector<int16_t> _frameSourceSamples;
+    QVector<int> _frameSourceZoneSettings;
+
     // stats
     MovingMinMaxAvg<int> _datagramsReadPerCallStats;     // update with # of datagrams read for each readPendingDatagrams call
     MovingMinMaxAvg<quint64> _timeSpentPerCallStats;     // update with usecs spent inside each readPendingDatagrams call
@@ -18,7 +18,8 @@
 
 AudioMixerDatagramProcessor::AudioMixerDatagramProcessor(QUdpSocket& nodeSocket, QThread* previousNodeSocketThread) :
     _nodeSocket(nodeSocket),
-    _previousNodeSocketThread(previousNodeSocketThread)
+    _previousNodeSocketThread(previousNodeSocketThread),
+    _datagramBatcher(nodeSocket, 0, DatagramBatcher::MAX_BATCHED_DATAGRAMS)
 {
     
 }
@@ -43,5 +44,16 @@ void AudioMixerDatagramProcessor::readPendingDatagrams() {
         
         // emit the signal to tell AudioMixer it needs to process a packet
         emit packetRequiresProcessing(incomingPacket, senderSockAddr);
+        
+        // the first read goes through the socket so that it keeps notifying us, the rest of what is waiting
+        // comes off in as few recvmmsg calls as possible
+        int numRead = 0;
+        while ((numRead = _datagramBatcher.readDatagrams()) > 0) {
+            for (int i = 0; i < numRead; i++) {
+                emit packetRequiresProcessing(QByteArray(_datagramBatcher.getReadDatagram(i),
+                                                         _datagramBatcher.getReadDatagramSize(i)),
+                                              _datagramBatcher.getReadDatagramSender(i));
+            }
+        }
     }
 }
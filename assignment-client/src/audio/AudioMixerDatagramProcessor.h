@@ -15,6 +15,8 @@
 #include <qobject.h>
 #include <qudpsocket.h>
 
+#include <DatagramBatcher.h>
+
 class AudioMixerDatagramProcessor : public QObject {
     Q_OBJECT
 public:
@@ -27,6 +29,7 @@ signals:
 private:
     QUdpSocket& _nodeSocket;
     QThread* _previousNodeSocketThread;
+    DatagramBatcher _datagramBatcher;
 };
 
 #endif // hifi_AudioMixerDatagramProcessor_h
\ No newline at end of file
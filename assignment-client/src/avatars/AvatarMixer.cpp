@@ -21,6 +21,7 @@
 #include <LogHandler.h>
 #include <NodeList.h>
 #include <PacketHeaders.h>
+#include <PerfStat.h>
 #include <SharedUtil.h>
 #include <UUID.h>
 #include <TryLocker.h>
@@ -33,6 +34,11 @@ const QString AVATAR_MIXER_LOGGING_NAME = "avatar-mixer";
 const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60; 
 const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / (float) AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) * 1000;
 
+const float AVATAR_GRID_CELL_SIZE = 8.0f; // meters
+
+// how many avatars past a receiver's full rate distance get a chance to be sent to it each frame
+const int NUM_FAR_AVATARS_SAMPLED_PER_FRAME = 32;
+
 AvatarMixer::AvatarMixer(const QByteArray& packet) :
     ThreadedAssignment(packet),
     _broadcastThread(),
@@ -42,7 +48,8 @@ AvatarMixer::AvatarMixer(const QByteArray& packet) :
     _sumListeners(0),
     _numStatFrames(0),
     _sumBillboardPackets(0),
-    _sumIdentityPackets(0)
+    _sumIdentityPackets(0),
+    _avatarGrid(AVATAR_GRID_CELL_SIZE)
 {
     // make sure we hear about node kills so we can tell the other nodes
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
@@ -63,6 +70,7 @@ const float BILLBOARD_AND_IDENTITY_SEND_PROBABILITY = 1.0f / 300.0f;
 //    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
 //       if the avatar is not in view or in the keyhole.
 void AvatarMixer::broadcastAvatarData() {
+    PerformanceTimer perfTimer("broadcastAvatarData");
     
     int idleTime = QDateTime::currentMSecsSinceEpoch() - _lastFrameTimestamp;
     
@@ -129,6 +137,20 @@ void AvatarMixer::broadcastAvatarData() {
     std::random_device randomDevice;
     std::mt19937 generator(randomDevice());
     std::uniform_real_distribution<float> distribution;
+
+    // index every avatar by position once for this frame, so that each receiver can skip straight to who is near them
+    _avatarGrid.clear();
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+        if (nodeData) {
+            // wait for the position rather than leave the avatar out of the frame for every receiver
+            QMutexLocker lock(&nodeData->getMutex());
+            _avatarGrid.insert(nodeData->getAvatar().getPosition(), node);
+        }
+    });
+
+    // hand every packet for this frame to the kernel together
+    nodeList->beginDatagramBatch();
     
     nodeList->eachMatchingNode(
         [&](const SharedNodePointer& node)->bool {
@@ -218,128 +240,157 @@ void AvatarMixer::broadcastAvatarData() {
                 nodeData->incrementNumFramesSinceFRDAdjustment();
             }
 
+            // sends the data for one other avatar to this node, as long as it has something new for them
+            auto sendOtherAvatar = [&](const SharedNodePointer& otherNode) {
+                AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
+                MutexTryLocker lock(otherNodeData->getMutex());
+                if (!lock.isLocked()) {
+                    return;
+                }
+
+                PacketSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
+                PacketSequenceNumber lastSeqFromSender = otherNode->getLastSequenceNumberForPacketType(PacketTypeAvatarData);
+
+                if (lastSeqToReceiver > lastSeqFromSender) {
+                    // Did we somehow get out of order packets from the sender?
+                    // We don't expect this to happen - in RELEASE we add this to a trackable stat
+                    // and in DEBUG we crash on the assert
+                    
+                    otherNodeData->incrementNumOutOfOrderSends();
+
+                    assert(false);
+                }
+                
+                // make sure we haven't already sent this data from this sender to this receiver
+                // or that somehow we haven't sent
+                if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
+                    ++numAvatarsHeldBack;
+                    return;
+                } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
+                    // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
+                    ++numAvatarsWithSkippedFrames;
+                } 
+                
+                // we're going to send this avatar
+                
+                // increment the number of avatars sent to this reciever
+                nodeData->incrementNumAvatarsSentLastFrame();
+                
+                // set the last sent sequence number for this sender on the receiver
+                nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(), lastSeqFromSender);
+
+                // the sender's data is serialized at most once per received packet and shared by every receiver.
+                // Only joint changes go to receivers that were sent the previous packet, the rest get every joint
+                bool sendAll = lastSeqToReceiver == 0 || (PacketSequenceNumber)(lastSeqFromSender - lastSeqToReceiver) != 1;
+                const QByteArray& avatarByteArray = otherNodeData->getSerializedAvatarData(otherNode->getUUID(),
+                                                                                           lastSeqFromSender, sendAll);
+                
+                if (avatarByteArray.size() + mixedAvatarByteArray.size() > MAX_PACKET_SIZE) {
+                    nodeList->writeDatagram(mixedAvatarByteArray, node);
+
+                    numAvatarDataBytes += mixedAvatarByteArray.size();
+                        
+                    // reset the packet
+                    mixedAvatarByteArray.resize(numPacketHeaderBytes);
+                }
+                    
+                // copy the avatar into the mixedAvatarByteArray packet
+                mixedAvatarByteArray.append(avatarByteArray);
+                    
+                // if the receiving avatar has just connected make sure we send out the mesh and billboard
+                // for this avatar (assuming they exist)
+                bool forceSend = !nodeData->checkAndSetHasReceivedFirstPackets();
+                    
+                // we will also force a send of billboard or identity packet
+                // if either has changed in the last frame
+                    
+                if (otherNodeData->getBillboardChangeTimestamp() > 0
+                    && (forceSend
+                        || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
+                        || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+                    QByteArray billboardPacket = nodeList->byteArrayWithPopulatedHeader(PacketTypeAvatarBillboard);
+                    billboardPacket.append(otherNode->getUUID().toRfc4122());
+                    billboardPacket.append(otherNodeData->getAvatar().getBillboard());
+
+                    nodeList->writeDatagram(billboardPacket, node);
+                        
+                    ++_sumBillboardPackets;
+                }
+                    
+                if (otherNodeData->getIdentityChangeTimestamp() > 0
+                    && (forceSend
+                        || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
+                        || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+                            
+                    QByteArray identityPacket = nodeList->byteArrayWithPopulatedHeader(PacketTypeAvatarIdentity);
+                        
+                    QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
+                    individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
+                    identityPacket.append(individualData);
+                    
+                    nodeList->writeDatagram(identityPacket, node);
+                            
+                    ++_sumIdentityPackets;
+                }
+            };
+
             // this is an AGENT we have received head data from
             // send back a packet with other active node data to this node
-            nodeList->eachMatchingNode(
-                [&](const SharedNodePointer& otherNode)->bool {
-                    if (!otherNode->getLinkedData()) {
-                        return false;
-                    }
+
+            //  Decide whether to send each avatar's data based on it's distance from us
+            //  The full rate distance is the distance at which EVERY update will be sent for this avatar
+            //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
+            float fullRateDistance = nodeData->getFullRateDistance();
+
+            // every avatar in the cells the full rate distance reaches is considered on its own
+            _avatarGrid.eachCellWithinRadius(myPosition, fullRateDistance, [&](const AvatarGrid::Cell& cell) {
+                _avatarGrid.eachEntryInCell(cell, [&](const SharedNodePointer& otherNode, const glm::vec3& otherPosition)->bool {
                     if (otherNode->getUUID() == node->getUUID()) {
-                        return false;
+                        return true;
                     }
 
-                    return true;
-                },
-                [&](const SharedNodePointer& otherNode) {
                     ++numOtherAvatars;
-                    
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    MutexTryLocker lock(otherNodeData->getMutex());
-                    if (!lock.isLocked()) {
-                        return;
-                    }
-                    
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    //  Decide whether to send this avatar's data based on it's distance from us
-                    
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    glm::vec3 otherPosition = otherAvatar.getPosition();
+
                     float distanceToAvatar = glm::length(myPosition - otherPosition);
 
                     // potentially update the max full rate distance for this frame
                     maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
 
-                    if (distanceToAvatar != 0.0f 
-                        && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
-                        return;
+                    if (distanceToAvatar > fullRateDistance
+                        && distribution(generator) > (fullRateDistance / distanceToAvatar)) {
+                        return true;
                     }
 
-                    PacketSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
-                    PacketSequenceNumber lastSeqFromSender = otherNode->getLastSequenceNumberForPacketType(PacketTypeAvatarData);
+                    sendOtherAvatar(otherNode);
+                    return true;
+                });
+            });
 
-                    if (lastSeqToReceiver > lastSeqFromSender) {
-                        // Did we somehow get out of order packets from the sender?
-                        // We don't expect this to happen - in RELEASE we add this to a trackable stat
-                        // and in DEBUG we crash on the assert
-                        
-                        otherNodeData->incrementNumOutOfOrderSends();
+            // past those cells only a fixed size sample of the avatars, starting at a random one, gets a chance to be sent.
+            // Their chance is scaled up by how many avatars each of them stands for, so that on average a far avatar is
+            // sent as often as if every one of them had been rolled for
+            int numEntries = _avatarGrid.getNumEntries();
+            int numToSample = std::min(numEntries, NUM_FAR_AVATARS_SAMPLED_PER_FRAME);
+            if (numToSample > 0) {
+                float sampleScale = (float)numEntries / (float)numToSample;
+                std::uniform_int_distribution<int> firstEntryDistribution(0, numEntries - 1);
+
+                _avatarGrid.eachEntryFrom(firstEntryDistribution(generator), numToSample,
+                    [&](const SharedNodePointer& otherNode, const glm::vec3& otherPosition, const AvatarGrid::Cell& cell) {
+                        if (_avatarGrid.getMinDistanceToCell(myPosition, cell) <= fullRateDistance) {
+                            return; // this cell was gone through above
+                        }
 
-                        assert(false);
-                    }
-                    
-                    // make sure we haven't already sent this data from this sender to this receiver
-                    // or that somehow we haven't sent
-                    if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
-                        ++numAvatarsHeldBack;
-                        return;
-                    } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
-                        // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
-                        ++numAvatarsWithSkippedFrames;
-                    } 
-                    
-                    // we're going to send this avatar
-                    
-                    // increment the number of avatars sent to this reciever
-                    nodeData->incrementNumAvatarsSentLastFrame();
-                    
-                    // set the last sent sequence number for this sender on the receiver
-                    nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(), 
-                        otherNode->getLastSequenceNumberForPacketType(PacketTypeAvatarData));
+                        ++numOtherAvatars;
 
-                    QByteArray avatarByteArray;
-                    avatarByteArray.append(otherNode->getUUID().toRfc4122());
-                    avatarByteArray.append(otherAvatar.toByteArray());
-                    
-                    if (avatarByteArray.size() + mixedAvatarByteArray.size() > MAX_PACKET_SIZE) {
-                        nodeList->writeDatagram(mixedAvatarByteArray, node);
+                        float distanceToAvatar = glm::length(myPosition - otherPosition);
+                        maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
 
-                        numAvatarDataBytes += mixedAvatarByteArray.size();
-                            
-                        // reset the packet
-                        mixedAvatarByteArray.resize(numPacketHeaderBytes);
-                    }
-                        
-                    // copy the avatar into the mixedAvatarByteArray packet
-                    mixedAvatarByteArray.append(avatarByteArray);
-                        
-                    // if the receiving avatar has just connected make sure we send out the mesh and billboard
-                    // for this avatar (assuming they exist)
-                    bool forceSend = !nodeData->checkAndSetHasReceivedFirstPackets();
-                        
-                    // we will also force a send of billboard or identity packet
-                    // if either has changed in the last frame
-                        
-                    if (otherNodeData->getBillboardChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
-                            || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
-                        QByteArray billboardPacket = nodeList->byteArrayWithPopulatedHeader(PacketTypeAvatarBillboard);
-                        billboardPacket.append(otherNode->getUUID().toRfc4122());
-                        billboardPacket.append(otherNodeData->getAvatar().getBillboard());
-
-                        nodeList->writeDatagram(billboardPacket, node);
-                            
-                        ++_sumBillboardPackets;
-                    }
-                        
-                    if (otherNodeData->getIdentityChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                            || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
-                                
-                        QByteArray identityPacket = nodeList->byteArrayWithPopulatedHeader(PacketTypeAvatarIdentity);
-                            
-                        QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
-                        individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
-                        identityPacket.append(individualData);
-                        
-                        nodeList->writeDatagram(identityPacket, node);
-                                
-                        ++_sumIdentityPackets;
-                    }
-            });
+                        if (distribution(generator) * distanceToAvatar <= fullRateDistance * sampleScale) {
+                            sendOtherAvatar(otherNode);
+                        }
+                    });
+            }
             
             // send the last packet
             nodeList->writeDatagram(mixedAvatarByteArray, node);
@@ -359,6 +410,11 @@ void AvatarMixer::broadcastAvatarData() {
             }
         }
     );
+
+    nodeList->sendDatagramBatch();
+
+    // don't hold on to any nodes until the next frame
+    _avatarGrid.clear();
     
     _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
 }
@@ -15,6 +15,7 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <SpatialHashGrid.h>
 #include <ThreadedAssignment.h>
 
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
@@ -52,6 +53,9 @@ private:
     float _maxKbpsPerNode = 0.0f;
 
     QTimer* _broadcastTimer = nullptr;
+
+    typedef SpatialHashGrid<SharedNodePointer> AvatarGrid;
+    AvatarGrid _avatarGrid;
 };
 
 #endif // hifi_AvatarMixer_h
@@ -16,9 +16,29 @@
 int AvatarMixerClientData::parseData(const QByteArray& packet) {
     // compute the offset to the data payload
     int offset = numBytesForPacketHeader(packet);
+
+    // whatever we serialized for this avatar is now out of date
+    _serializedAvatarDelta.isValid = false;
+    _serializedAvatarFull.isValid = false;
+
     return _avatar.parseDataAtOffset(packet, offset);
 }
 
+const QByteArray& AvatarMixerClientData::getSerializedAvatarData(const QUuid& nodeUUID,
+                                                                 PacketSequenceNumber lastReceivedSequenceNumber,
+                                                                 bool sendAll) {
+    SerializedAvatarData& serialized = sendAll ? _serializedAvatarFull : _serializedAvatarDelta;
+    if (!serialized.isValid || serialized.sequenceNumber != lastReceivedSequenceNumber) {
+        serialized.data = nodeUUID.toRfc4122();
+        serialized.data.append(_avatar.toByteArray(sendAll));
+
+        serialized.sequenceNumber = lastReceivedSequenceNumber;
+        serialized.isValid = true;
+    }
+
+    return serialized.data;
+}
+
 bool AvatarMixerClientData::checkAndSetHasReceivedFirstPackets() {
     bool oldValue = _hasReceivedFirstPackets;
     _hasReceivedFirstPackets = true;
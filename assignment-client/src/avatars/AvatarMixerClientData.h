@@ -41,6 +41,13 @@ public:
         { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
     Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) { _lastBroadcastSequenceNumbers.erase(nodeUUID); }
 
+    /// returns the UUID prefixed avatar data for this avatar, only re-serializing it when the given
+    /// sequence number differs from the one it was last serialized for or new avatar data has been parsed.
+    /// Pass sendAll for a receiver that didn't get the previous data, it gets every joint instead of the joints
+    /// that changed.
+    const QByteArray& getSerializedAvatarData(const QUuid& nodeUUID, PacketSequenceNumber lastReceivedSequenceNumber,
+                                              bool sendAll);
+
     quint64 getBillboardChangeTimestamp() const { return _billboardChangeTimestamp; }
     void setBillboardChangeTimestamp(quint64 billboardChangeTimestamp) { _billboardChangeTimestamp = billboardChangeTimestamp; }
     
@@ -80,6 +87,14 @@ private:
 
     std::unordered_map<QUuid, PacketSequenceNumber, UUIDHasher> _lastBroadcastSequenceNumbers;
 
+    struct SerializedAvatarData {
+        QByteArray data;
+        PacketSequenceNumber sequenceNumber = DEFAULT_SEQUENCE_NUMBER;
+        bool isValid = false;
+    };
+    SerializedAvatarData _serializedAvatarDelta;
+    SerializedAvatarData _serializedAvatarFull;
+
     bool _hasReceivedFirstPackets = false;
     quint64 _billboardChangeTimestamp = 0;
     quint64 _identityChangeTimestamp = 0;
@@ -19,6 +19,7 @@
 #include <UUID.h>
 
 #include "OctreeSendThread.h"
+#include "OctreeServer.h"
 
 OctreeQueryNode::OctreeQueryNode() :
     _viewSent(false),
@@ -100,7 +101,16 @@ void OctreeQueryNode::initializeOctreeSendThread(OctreeServer* myServer, const S
     
     // we want to be notified when the thread finishes
     connect(_octreeSendThread, &GenericThread::finished, this, &OctreeQueryNode::sendThreadFinished);
-    _octreeSendThread->initialize(true);
+
+    // clients are normally sent to by the server's pool of send workers, only fall back to a thread of our
+    // own if the pool hasn't been started yet
+    OctreeSendScheduler* sendScheduler = myServer->getSendScheduler();
+    if (sendScheduler) {
+        _octreeSendThread->initialize(false);
+        sendScheduler->addSender(_octreeSendThread);
+    } else {
+        _octreeSendThread->initialize(true);
+    }
 }
 
 bool OctreeQueryNode::packetIsDuplicate() const {
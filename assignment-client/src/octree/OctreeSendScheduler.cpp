@@ -0,0 +1,207 @@
+//
+//  OctreeSendScheduler.cpp
+//  assignment-client/src/octree
+//
+//  Created on 2015-06-08.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <GenericThread.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "OctreeSendScheduler.h"
+#include "OctreeSendThread.h"
+#include "OctreeServer.h"
+#include "OctreeServerConsts.h"
+
+// limits how long writers to the tree can be held off by a single slice of senders
+const int MAX_SENDERS_PER_SLICE = 8;
+
+class OctreeSendWorker : public GenericThread {
+public:
+    OctreeSendWorker(OctreeSendScheduler* scheduler) : _scheduler(scheduler) { }
+
+protected:
+    virtual bool process() { return _scheduler->processNextSlice(); }
+
+private:
+    OctreeSendScheduler* _scheduler;
+};
+
+OctreeSendScheduler::OctreeSendScheduler(OctreeServer* myServer, int numWorkers) :
+    _myServer(myServer),
+    _numWorkers(std::max(numWorkers, 1)),
+    _isShuttingDown(false)
+{
+}
+
+OctreeSendScheduler::~OctreeSendScheduler() {
+    terminate();
+}
+
+void OctreeSendScheduler::initialize() {
+    for (int i = 0; i < _numWorkers; i++) {
+        OctreeSendWorker* worker = new OctreeSendWorker(this);
+        worker->setObjectName(QString("Octree Send Worker %1").arg(i));
+        worker->initialize(true);
+        _workers.append(worker);
+    }
+}
+
+void OctreeSendScheduler::terminate() {
+    _sendersMutex.lock();
+    _isShuttingDown = true;
+    _sendersChanged.wakeAll();
+    _sendersMutex.unlock();
+
+    foreach (OctreeSendWorker* worker, _workers) {
+        worker->terminate();
+        delete worker;
+    }
+    _workers.clear();
+}
+
+void OctreeSendScheduler::addSender(OctreeSendThread* sender) {
+    QMutexLocker locker(&_sendersMutex);
+    ScheduledSender scheduledSender = { sender, usecTimestampNow(), false };
+    _senders.append(scheduledSender);
+    _sendersChanged.wakeAll();
+}
+
+void OctreeSendScheduler::removeSender(OctreeSendThread* sender) {
+    QMutexLocker locker(&_sendersMutex);
+    forever {
+        int senderIndex = -1;
+        for (int i = 0; i < _senders.size(); i++) {
+            if (_senders[i].sender == sender) {
+                senderIndex = i;
+                break;
+            }
+        }
+        if (senderIndex == -1) {
+            return;
+        }
+        if (!_senders[senderIndex].isSending) {
+            _senders.remove(senderIndex);
+            return;
+        }
+        // a worker is in the middle of an interval for this sender, wait for it to hand the sender back
+        _sendersChanged.wait(&_sendersMutex);
+    }
+}
+
+bool OctreeSendScheduler::viewsOverlap(OctreeSendThread* first, OctreeSendThread* second) {
+    OctreeQueryNode* firstData = first->getNodeData();
+    OctreeQueryNode* secondData = second->getNodeData();
+    if (!firstData || !secondData) {
+        return false;
+    }
+
+    // approximate the second view by the sphere around the middle of its frustum
+    ViewFrustum& firstView = firstData->getCurrentViewFrustum();
+    ViewFrustum& secondView = secondData->getCurrentViewFrustum();
+    float secondRadius = secondView.getFarClip() * 0.5f;
+    glm::vec3 secondCenter = secondView.getPosition() + secondView.getDirection() * secondRadius;
+    return firstView.sphereInFrustum(secondCenter, secondRadius) != ViewFrustum::OUTSIDE;
+}
+
+bool OctreeSendScheduler::processNextSlice() {
+    QVector<OctreeSendThread*> slice;
+    quint64 sliceStart = 0;
+
+    _sendersMutex.lock();
+    forever {
+        if (_isShuttingDown) {
+            _sendersMutex.unlock();
+            return false;
+        }
+
+        // the sender that is most overdue leads the slice
+        int leaderIndex = -1;
+        for (int i = 0; i < _senders.size(); i++) {
+            if (!_senders[i].isSending
+                    && (leaderIndex == -1 || _senders[i].nextSendTime < _senders[leaderIndex].nextSendTime)) {
+                leaderIndex = i;
+            }
+        }
+
+        if (leaderIndex == -1) {
+            _sendersChanged.wait(&_sendersMutex);
+            continue;
+        }
+
+        sliceStart = usecTimestampNow();
+        quint64 nextSendTime = _senders[leaderIndex].nextSendTime;
+        if (nextSendTime > sliceStart) {
+            unsigned long msecsToWait = (nextSendTime - sliceStart + USECS_PER_MSEC - 1) / USECS_PER_MSEC;
+            _sendersChanged.wait(&_sendersMutex, msecsToWait);
+            continue;
+        }
+
+        ScheduledSender& leader = _senders[leaderIndex];
+        leader.isSending = true;
+        slice.append(leader.sender);
+
+        // any other due sender looking at the same part of the tree can encode under the same read lock
+        for (int i = 0; i < _senders.size() && slice.size() < MAX_SENDERS_PER_SLICE; i++) {
+            ScheduledSender& other = _senders[i];
+            if (!other.isSending && other.nextSendTime <= sliceStart && viewsOverlap(leader.sender, other.sender)) {
+                other.isSending = true;
+                slice.append(other.sender);
+            }
+        }
+        break;
+    }
+    _sendersMutex.unlock();
+
+    // nothing can be encoded until the tree is loaded, so don't hold off the persist thread while it loads
+    bool treeIsLocked = _myServer->isInitialLoadComplete();
+    if (treeIsLocked) {
+        quint64 lockWaitStart = usecTimestampNow();
+        _myServer->getOctree()->lockForRead();
+        quint64 lockWaitEnd = usecTimestampNow();
+        OctreeServer::trackTreeWaitTime((float)(lockWaitEnd - lockWaitStart));
+    }
+
+    quint64 lockHoldStart = usecTimestampNow();
+    QVector<bool> stillSending;
+    foreach (OctreeSendThread* sender, slice) {
+        stillSending.append(sender->sendInterval(treeIsLocked));
+    }
+
+    if (treeIsLocked) {
+        _myServer->getOctree()->unlock();
+        OctreeServer::trackTreeHoldTime((float)(usecTimestampNow() - lockHoldStart));
+    }
+
+    // the packets encoded under the lock go out once writers can get at the tree again
+    foreach (OctreeSendThread* sender, slice) {
+        sender->sendQueuedPackets();
+    }
+
+    QMutexLocker locker(&_sendersMutex);
+    for (int i = 0; i < slice.size(); i++) {
+        for (int senderIndex = 0; senderIndex < _senders.size(); senderIndex++) {
+            if (_senders[senderIndex].sender == slice[i]) {
+                if (stillSending[i]) {
+                    _senders[senderIndex].nextSendTime = sliceStart + OCTREE_SEND_INTERVAL_USECS;
+                    _senders[senderIndex].isSending = false;
+                } else {
+                    _senders.remove(senderIndex);
+
+                    // let the owner clean up the sender, this is done while holding the mutex so that removeSender()
+                    // can not return and allow the sender to be deleted before we are done with it
+                    emit slice[i]->finished();
+                }
+                break;
+            }
+        }
+    }
+    _sendersChanged.wakeAll();
+
+    return true;
+}
@@ -0,0 +1,69 @@
+//
+//  OctreeSendScheduler.h
+//  assignment-client/src/octree
+//
+//  Created on 2015-06-08.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Runs the OctreeSendThreads of every connected client on a fixed set of worker threads
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendScheduler_h
+#define hifi_OctreeSendScheduler_h
+
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+class OctreeSendThread;
+class OctreeSendWorker;
+class OctreeServer;
+
+/// Schedules non-threaded OctreeSendThreads by their next send deadline across a bounded number of worker threads.
+/// Each worker takes the most overdue client along with any other due clients whose views overlap it, and encodes
+/// all of them under a single read lock of the octree. Their packets are sent once the lock is released.
+class OctreeSendScheduler {
+public:
+    OctreeSendScheduler(OctreeServer* myServer, int numWorkers);
+    ~OctreeSendScheduler();
+
+    /// starts the worker threads
+    void initialize();
+
+    /// stops the worker threads, blocking until any in progress sends complete
+    void terminate();
+
+    int getNumWorkers() const { return _workers.size(); }
+
+    /// adds a sender, it will be processed every OCTREE_SEND_INTERVAL_USECS until it returns false or is removed
+    void addSender(OctreeSendThread* sender);
+
+    /// removes a sender, blocking while a worker is in the middle of sending for it
+    void removeSender(OctreeSendThread* sender);
+
+    /// called by the workers, sends one interval for a slice of due senders, returns false once terminated
+    bool processNextSlice();
+
+private:
+    struct ScheduledSender {
+        OctreeSendThread* sender;
+        quint64 nextSendTime;
+        bool isSending;
+    };
+
+    static bool viewsOverlap(OctreeSendThread* first, OctreeSendThread* second);
+
+    OctreeServer* _myServer;
+    int _numWorkers;
+    QVector<OctreeSendWorker*> _workers;
+
+    QMutex _sendersMutex;
+    QWaitCondition _sendersChanged;
+    QVector<ScheduledSender> _senders;
+    bool _isShuttingDown;
+};
+
+#endif // hifi_OctreeSendScheduler_h
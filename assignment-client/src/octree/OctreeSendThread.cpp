@@ -27,7 +27,9 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
     _nodeUUID(node->getUUID()),
     _packetData(),
     _nodeMissingCount(0),
-    _isShuttingDown(false)
+    _isShuttingDown(false),
+    _isQueueingPackets(false),
+    _isSpecialPacketDeferred(false)
 {
     QString safeServerName("Octree");
     
@@ -45,6 +47,11 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
 }
 
 OctreeSendThread::~OctreeSendThread() {
+    // make sure no send worker is still using us
+    if (_myServer && _myServer->getSendScheduler()) {
+        _myServer->getSendScheduler()->removeSender(this);
+    }
+
     QString safeServerName("Octree");
     if (_myServer) {
         safeServerName = _myServer->getMyServerName();
@@ -65,14 +72,39 @@ void OctreeSendThread::setIsShuttingDown() {
 
 
 bool OctreeSendThread::process() {
+    quint64  start = usecTimestampNow();
+
+    if (!sendInterval(false)) {
+        return false; // exit early if we're shutting down
+    }
+
+    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
+    if (isStillRunning()) {
+        // dynamically sleep until we need to fire off the next set of octree elements
+        int elapsed = (usecTimestampNow() - start);
+        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
+
+        if (usecToSleep > 0) {
+            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
+            usleep(usecToSleep);
+        } else {
+            const int MIN_USEC_TO_SLEEP = 1;
+            usleep(MIN_USEC_TO_SLEEP);
+        }
+    }
+
+    return isStillRunning();  // keep running till they terminate us
+}
+
+bool OctreeSendThread::sendInterval(bool treeIsLocked) {
+    PerformanceTimer perfTimer("sendInterval");
+
     if (_isShuttingDown) {
         return false; // exit early if we're shutting down
     }
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
-
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
@@ -85,31 +117,41 @@ bool OctreeSendThread::process() {
             // Sometimes the node data has not yet been linked, in which case we can't really do anything
             if (nodeData && !nodeData->isShuttingDown()) {
                 bool viewFrustumChanged = nodeData->updateCurrentViewFrustum();
-                packetDistributor(nodeData, viewFrustumChanged);
+
+                // packets are held back while the caller holds the tree, so that writers don't wait on the network
+                _isQueueingPackets = treeIsLocked;
+                packetDistributor(nodeData, viewFrustumChanged, treeIsLocked);
+                _isQueueingPackets = false;
             }
         }
     }
 
-    if (_isShuttingDown) {
-        return false; // exit early if we're shutting down
-    }
+    return !_isShuttingDown;
+}
 
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
+void OctreeSendThread::sendQueuedPackets() {
+    foreach (const QByteArray& packet, _queuedPackets) {
+        DependencyManager::get<NodeList>()->writeDatagram(packet, _node);
+    }
+    _queuedPackets.clear();
 
-        if (usecToSleep > 0) {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            usleep(usecToSleep);
-        } else {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usleep(MIN_USEC_TO_SLEEP);
+    if (_isSpecialPacketDeferred) {
+        _isSpecialPacketDeferred = false;
+        OctreeQueryNode* nodeData = getNodeData();
+        if (nodeData && !nodeData->isShuttingDown()) {
+            int specialPacketsSent;
+            _myServer->sendSpecialPacket(_node, nodeData, specialPacketsSent);
+            nodeData->resetOctreePacket();   // because nodeData's _sequenceNumber has changed
         }
     }
+}
 
-    return isStillRunning();  // keep running till they terminate us
+void OctreeSendThread::writePacket(const char* data, int size) {
+    if (_isQueueingPackets) {
+        _queuedPackets.append(QByteArray(data, size));
+    } else {
+        DependencyManager::get<NodeList>()->writeDatagram(data, size, _node);
+    }
 }
 
 quint64 OctreeSendThread::_usleepTime = 0;
@@ -180,12 +222,12 @@ int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytes
 
             // actually send it
             OctreeServer::didCallWriteDatagram(this);
-            DependencyManager::get<NodeList>()->writeDatagram((char*) statsMessage, statsMessageLength, _node);
+            writePacket((char*) statsMessage, statsMessageLength);
             packetSent = true;
         } else {
             // not enough room in the packet, send two packets
             OctreeServer::didCallWriteDatagram(this);
-            DependencyManager::get<NodeList>()->writeDatagram((char*) statsMessage, statsMessageLength, _node);
+            writePacket((char*) statsMessage, statsMessageLength);
 
             // since a stats message is only included on end of scene, don't consider any of these bytes "wasted", since
             // there was nothing else to send.
@@ -214,7 +256,7 @@ int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytes
             packetsSent++;
 
             OctreeServer::didCallWriteDatagram(this);
-            DependencyManager::get<NodeList>()->writeDatagram((char*)nodeData->getPacket(), nodeData->getPacketLength(), _node);
+            writePacket((char*)nodeData->getPacket(), nodeData->getPacketLength());
             packetSent = true;
 
             thisWastedBytes = MAX_PACKET_SIZE - nodeData->getPacketLength();
@@ -243,7 +285,7 @@ int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytes
         if (nodeData->isPacketWaiting() && !nodeData->isShuttingDown()) {
             // just send the octree packet
             OctreeServer::didCallWriteDatagram(this);
-            DependencyManager::get<NodeList>()->writeDatagram((char*)nodeData->getPacket(), nodeData->getPacketLength(), _node);
+            writePacket((char*)nodeData->getPacket(), nodeData->getPacketLength());
             packetSent = true;
 
             int thisWastedBytes = MAX_PACKET_SIZE - nodeData->getPacketLength();
@@ -281,7 +323,7 @@ int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytes
 }
 
 /// Version of octree element distributor that sends the deepest LOD level at once
-int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged) {
+int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged, bool treeIsLocked) {
         
     OctreeServer::didPacketDistributor(this);
 
@@ -407,10 +449,13 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
             bool lastNodeDidntFit = false; // assume each node fits
             if (!nodeData->elementBag.isEmpty()) {
                 
-                quint64 lockWaitStart = usecTimestampNow();
-                _myServer->getOctree()->lockForRead();
-                quint64 lockWaitEnd = usecTimestampNow();
-                lockWaitElapsedUsec = (float)(lockWaitEnd - lockWaitStart);
+                // when the caller holds the tree for the whole interval its wait has already been tracked
+                if (!treeIsLocked) {
+                    quint64 lockWaitStart = usecTimestampNow();
+                    _myServer->getOctree()->lockForRead();
+                    quint64 lockWaitEnd = usecTimestampNow();
+                    lockWaitElapsedUsec = (float)(lockWaitEnd - lockWaitStart);
+                }
                 quint64 encodeStart = usecTimestampNow();
 
                 OctreeElement* subTree = nodeData->elementBag.extract();
@@ -484,7 +529,9 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 }
 
                 nodeData->stats.encodeStopped();
-                _myServer->getOctree()->unlock();
+                if (!treeIsLocked) {
+                    _myServer->getOctree()->unlock();
+                }
             } else {
                 // If the bag was empty then we didn't even attempt to encode, and so we know the bytesWritten were 0
                 bytesWritten = 0;
@@ -573,18 +620,23 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         // send the environment packet
         // TODO: should we turn this into a while loop to better handle sending multiple special packets
         if (_myServer->hasSpecialPacketToSend(_node) && !nodeData->isShuttingDown()) {
-            int specialPacketsSent;
-            trueBytesSent += _myServer->sendSpecialPacket(_node, nodeData, specialPacketsSent);
-            nodeData->resetOctreePacket();   // because nodeData's _sequenceNumber has changed
-            truePacketsSent += specialPacketsSent;
-            packetsSentThisInterval += specialPacketsSent;
+            if (_isQueueingPackets) {
+                // the server writes these itself, so they wait until sendQueuedPackets()
+                _isSpecialPacketDeferred = true;
+            } else {
+                int specialPacketsSent;
+                trueBytesSent += _myServer->sendSpecialPacket(_node, nodeData, specialPacketsSent);
+                nodeData->resetOctreePacket();   // because nodeData's _sequenceNumber has changed
+                truePacketsSent += specialPacketsSent;
+                packetsSentThisInterval += specialPacketsSent;
+            }
         }
 
         // Re-send packets that were nacked by the client
         while (nodeData->hasNextNackedPacket() && packetsSentThisInterval < maxPacketsPerInterval) {
             const QByteArray* packet = nodeData->getNextNackedPacket();
             if (packet) {
-                DependencyManager::get<NodeList>()->writeDatagram(*packet, _node);
+                writePacket(packet->constData(), packet->size());
                 truePacketsSent++;
                 packetsSentThisInterval++;
 
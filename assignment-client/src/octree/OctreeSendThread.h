@@ -31,6 +31,16 @@ public:
     
     void setIsShuttingDown();
 
+    /// sends this interval's worth of packets to the client, returns false once the client is shutting down.
+    /// \param bool treeIsLocked true if the caller already holds a read lock on the octree for the whole interval, the
+    /// packets are then queued until the caller releases the lock and calls sendQueuedPackets()
+    bool sendInterval(bool treeIsLocked);
+
+    /// sends the packets queued by sendInterval() while the octree was locked
+    void sendQueuedPackets();
+
+    OctreeQueryNode* getNodeData() const { return _node ? static_cast<OctreeQueryNode*>(_node->getLinkedData()) : NULL; }
+
     static quint64 _totalBytes;
     static quint64 _totalWastedBytes;
     static quint64 _totalPackets;
@@ -48,12 +58,17 @@ private:
     QUuid _nodeUUID;
 
     int handlePacketSend(OctreeQueryNode* nodeData, int& trueBytesSent, int& truePacketsSent);
-    int packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged);
+    int packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged, bool treeIsLocked);
+    void writePacket(const char* data, int size);
 
     OctreePacketData _packetData;
     
     int _nodeMissingCount;
     bool _isShuttingDown;
+
+    bool _isQueueingPackets;
+    QVector<QByteArray> _queuedPackets;
+    bool _isSpecialPacketDeferred;
 };
 
 #endif // hifi_OctreeSendThread_h
@@ -57,6 +57,8 @@ int OctreeServer::_longTreeWait = 0;
 int OctreeServer::_shortTreeWait = 0;
 int OctreeServer::_noTreeWait = 0;
 
+SimpleMovingAverage OctreeServer::_averageTreeHoldTime(MOVING_AVERAGE_SAMPLE_COUNTS);
+
 SimpleMovingAverage OctreeServer::_averageNodeWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 
 SimpleMovingAverage OctreeServer::_averageCompressAndWriteTime(MOVING_AVERAGE_SAMPLE_COUNTS);
@@ -103,6 +105,8 @@ void OctreeServer::resetSendingStats() {
     _shortTreeWait = 0;
     _noTreeWait = 0;
 
+    _averageTreeHoldTime.reset();
+
     _averageNodeWaitTime.reset();
 
     _averageCompressAndWriteTime.reset();
@@ -231,6 +235,10 @@ OctreeServer::OctreeServer(const QByteArray& packet) :
     _jurisdictionSender(NULL),
     _octreeInboundPacketProcessor(NULL),
     _persistThread(NULL),
+    _sendScheduler(NULL),
+    _sendThreads(0),
+    _persistJournalInterval(0),
+    _persistCompactInterval(OctreePersistThread::DEFAULT_COMPACT_INTERVAL),
     _started(time(0)),
     _startedUSecs(usecTimestampNow())
 {
@@ -276,6 +284,9 @@ OctreeServer::~OctreeServer() {
         _persistThread->deleteLater();
     }
 
+    delete _sendScheduler;
+    _sendScheduler = NULL;
+
     delete _jurisdiction;
     _jurisdiction = NULL;
 
@@ -507,6 +518,12 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          (double)_averageTreeExtraLongWaitTime.getAverage(),
                                          (double)(extraLongVsTotal * AS_PERCENT), _extraLongTreeWait);
 
+        // how long a send worker keeps the tree from writers, encoding a slice of clients
+        float averageTreeHoldTime = getAverageTreeHoldTime();
+        statsString += QString().sprintf("     Average tree lock hold per send:"
+                                         "    %9.2f usecs                 samples: %12d \r\n\r\n",
+                                         (double)averageTreeHoldTime, _averageTreeHoldTime.getSampleCount());
+
         // encode
         float averageEncodeTime = getAverageEncodeTime();
         statsString += QString().sprintf("                 Average encode time:    %9.2f usecs\r\n", (double)averageEncodeTime);
@@ -1049,6 +1066,13 @@ void OctreeServer::readConfiguration() {
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
         qDebug() << "persistInterval=" << _persistInterval;
 
+        _persistJournalInterval = OctreePersistThread::DEFAULT_JOURNAL_INTERVAL;
+        readOptionInt(QString("persistJournalInterval"), settingsSectionObject, _persistJournalInterval);
+        qDebug() << "persistJournalInterval=" << _persistJournalInterval;
+
+        readOptionInt(QString("persistCompactInterval"), settingsSectionObject, _persistCompactInterval);
+        qDebug() << "persistCompactInterval=" << _persistCompactInterval;
+
         bool noBackup;
         readOptionBool(QString("NoBackup"), settingsSectionObject, noBackup);
         _wantBackup = !noBackup;
@@ -1091,6 +1115,13 @@ void OctreeServer::readConfiguration() {
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d",
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
+    // clients are sent to from a pool of worker threads, no larger than the number of cores
+    readOptionInt(QString("sendThreads"), settingsSectionObject, _sendThreads);
+    if (_sendThreads <= 0 || _sendThreads > QThread::idealThreadCount()) {
+        _sendThreads = std::max(QThread::idealThreadCount(), 1);
+    }
+    qDebug("sendThreads=%d", _sendThreads);
+
 
     readAdditionalConfiguration(settingsSectionObject);
 }
@@ -1116,6 +1147,9 @@ void OctreeServer::run() {
     // read the configuration from either the payload or the domain server configuration
     readConfiguration();
 
+    _sendScheduler = new OctreeSendScheduler(this, _sendThreads);
+    _sendScheduler->initialize();
+
     beforeRun(); // after payload has been processed
 
     connect(nodeList.data(), SIGNAL(nodeAdded(SharedNodePointer)), SLOT(nodeAdded(SharedNodePointer)));
@@ -1142,7 +1176,8 @@ void OctreeServer::run() {
 
         // now set up PersistThread
         _persistThread = new OctreePersistThread(_tree, _persistFilename, _persistInterval,
-                                                 _wantBackup, _settings, _debugTimestampNow, _persistAsFileType);
+                                                 _wantBackup, _settings, _debugTimestampNow, _persistAsFileType,
+                                                 _persistJournalInterval, _persistCompactInterval);
         if (_persistThread) {
             _persistThread->initialize(true);
         }
@@ -1246,6 +1281,10 @@ void OctreeServer::aboutToFinish() {
         forceNodeShutdown(node);
     });
 
+    if (_sendScheduler) {
+        _sendScheduler->terminate();
+    }
+
     if (_persistThread) {
         _persistThread->aboutToFinish();
         _persistThread->terminating();
@@ -1402,6 +1441,7 @@ void OctreeServer::sendStatsPacket() {
     statsObject2[baseName + QString(".2.outbound.timing.1.avgLoopTime")] = getAverageLoopTime();
     statsObject2[baseName + QString(".2.outbound.timing.2.avgInsideTime")] = getAverageInsideTime();
     statsObject2[baseName + QString(".2.outbound.timing.3.avgTreeLockTime")] = getAverageTreeWaitTime();
+    statsObject2[baseName + QString(".2.outbound.timing.3.avgTreeHoldTime")] = getAverageTreeHoldTime();
     statsObject2[baseName + QString(".2.outbound.timing.4.avgEncodeTime")] = getAverageEncodeTime();
     statsObject2[baseName + QString(".2.outbound.timing.5.avgCompressAndWriteTime")] = getAverageCompressAndWriteTime();
     statsObject2[baseName + QString(".2.outbound.timing.5.avgSendTime")] = getAveragePacketSendingTime();
@@ -22,6 +22,7 @@
 #include <EnvironmentData.h>
 
 #include "OctreePersistThread.h"
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
@@ -58,6 +59,8 @@ public:
 
     bool isInitialLoadComplete() const { return (_persistThread) ? _persistThread->isInitialLoadComplete() : true; }
     bool isPersistEnabled() const { return (_persistThread) ? true : false; }
+
+    OctreeSendScheduler* getSendScheduler() { return _sendScheduler; }
     quint64 getLoadElapsedTime() const { return (_persistThread) ? _persistThread->getLoadElapsedTime() : 0; }
 
     // Subclasses must implement these methods
@@ -89,6 +92,9 @@ public:
     static void trackTreeWaitTime(float time);
     static float getAverageTreeWaitTime() { return _averageTreeWaitTime.getAverage(); }
 
+    static void trackTreeHoldTime(float time) { _averageTreeHoldTime.updateAverage(time); }
+    static float getAverageTreeHoldTime() { return _averageTreeHoldTime.getAverage(); }
+
     static void trackNodeWaitTime(float time) { _averageNodeWaitTime.updateAverage(time); }
     static float getAverageNodeWaitTime() { return _averageNodeWaitTime.getAverage(); }
 
@@ -170,8 +176,12 @@ protected:
     JurisdictionSender* _jurisdictionSender;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
     OctreePersistThread* _persistThread;
+    OctreeSendScheduler* _sendScheduler;
+    int _sendThreads;
     
     int _persistInterval;
+    int _persistJournalInterval;
+    int _persistCompactInterval;
     bool _wantBackup;
     QString _backupExtensionFormat;
     int _backupInterval;
@@ -206,6 +216,8 @@ protected:
     static int _shortTreeWait;
     static int _noTreeWait;
 
+    static SimpleMovingAverage _averageTreeHoldTime;
+
     static SimpleMovingAverage _averageNodeWaitTime;
 
     static SimpleMovingAverage _averageCompressAndWriteTime;
@@ -20,7 +20,8 @@
 
 OctreeServerDatagramProcessor::OctreeServerDatagramProcessor(QUdpSocket& nodeSocket, QThread* previousNodeSocketThread) :
     _nodeSocket(nodeSocket),
-    _previousNodeSocketThread(previousNodeSocketThread)
+    _previousNodeSocketThread(previousNodeSocketThread),
+    _datagramBatcher(nodeSocket, 0, DatagramBatcher::MAX_BATCHED_DATAGRAMS)
 {
     
 }
@@ -42,14 +43,28 @@ void OctreeServerDatagramProcessor::readPendingDatagrams() {
         // just get this packet off the stack
         _nodeSocket.readDatagram(incomingPacket.data(), incomingPacket.size(),
                                   senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
-                                  
-        PacketType packetType = packetTypeForPacket(incomingPacket);
-        if (packetType == PacketTypePing) {
-            DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, incomingPacket);
-            return; // don't emit
-        }
         
-        // emit the signal to tell AudioMixer it needs to process a packet
-        emit packetRequiresProcessing(incomingPacket, senderSockAddr);
+        processDatagram(incomingPacket, senderSockAddr);
+        
+        // the first read goes through the socket so that it keeps notifying us, the rest of what is waiting
+        // comes off in as few recvmmsg calls as possible
+        int numRead = 0;
+        while ((numRead = _datagramBatcher.readDatagrams()) > 0) {
+            for (int i = 0; i < numRead; i++) {
+                processDatagram(QByteArray(_datagramBatcher.getReadDatagram(i), _datagramBatcher.getReadDatagramSize(i)),
+                                _datagramBatcher.getReadDatagramSender(i));
+            }
+        }
     }
 }
+
+void OctreeServerDatagramProcessor::processDatagram(const QByteArray& incomingPacket, const HifiSockAddr& senderSockAddr) {
+    PacketType packetType = packetTypeForPacket(incomingPacket);
+    if (packetType == PacketTypePing) {
+        DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, incomingPacket);
+        return; // don't emit
+    }
+    
+    // emit the signal to tell the OctreeServer it needs to process a packet
+    emit packetRequiresProcessing(incomingPacket, senderSockAddr);
+}
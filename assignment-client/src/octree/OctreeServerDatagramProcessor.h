@@ -15,6 +15,8 @@
 #include <qobject.h>
 #include <qudpsocket.h>
 
+#include <DatagramBatcher.h>
+
 class OctreeServerDatagramProcessor : public QObject {
     Q_OBJECT
 public:
@@ -25,8 +27,11 @@ public slots:
 signals:
     void packetRequiresProcessing(const QByteArray& receivedPacket, const HifiSockAddr& senderSockAddr);
 private:
+    void processDatagram(const QByteArray& incomingPacket, const HifiSockAddr& senderSockAddr);
+    
     QUdpSocket& _nodeSocket;
     QThread* _previousNodeSocketThread;
+    DatagramBatcher _datagramBatcher;
 };
 
 #endif // hifi_OctreeServerDatagramProcessor_h
\ No newline at end of file
@@ -47,6 +47,8 @@ const QString ICE_SERVER_DEFAULT_HOSTNAME = "ice.highfidelity.io";
 const QString MAXIMUM_USER_CAPACITY = "security.maximum_user_capacity";
 const QString ALLOWED_EDITORS_SETTINGS_KEYPATH = "security.allowed_editors";
 const QString EDITORS_ARE_REZZERS_KEYPATH = "security.editors_are_rezzers";
+const QString PACKET_AUTHENTICATION_KEYPATH = "security.packet_authentication";
+const QString SIPHASH_PACKET_AUTHENTICATION_VALUE = "siphash";
 
 DomainServer::DomainServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
@@ -255,6 +257,13 @@ void DomainServer::setupNodeListAndAssignments(const QUuid& sessionUUID) {
     // check for scripts the user wants to persist from their domain-server config
     populateStaticScriptedAssignmentsFromSettings();
 
+    // every node in the domain is told to hash its verified packets the way we do in the domain list
+    QString packetAuthentication = _settingsManager.valueOrDefaultValueForKeyPath(PACKET_AUTHENTICATION_KEYPATH).toString();
+    setPacketAuthenticationMode(packetAuthentication == SIPHASH_PACKET_AUTHENTICATION_VALUE
+                                ? PacketAuthenticationSipHash : PacketAuthenticationMD5);
+    qDebug() << "Verified packets in this domain will be authenticated with"
+        << (getPacketAuthenticationMode() == PacketAuthenticationSipHash ? "SipHash" : "MD5");
+
     auto nodeList = DependencyManager::set<LimitedNodeList>(domainServerPort, domainServerDTLSPort);
 
     // no matter the local port, save it to shared mem so that local assignment clients can ask what it is
@@ -928,6 +937,7 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     broadcastDataStream << node->getUUID();
     broadcastDataStream << node->getCanAdjustLocks();
     broadcastDataStream << node->getCanRez();
+    broadcastDataStream << (quint8) getPacketAuthenticationMode();
 
     int numBroadcastPacketLeadBytes = broadcastDataStream.device()->pos();
 
@@ -28,7 +28,9 @@
 #include <QActionGroup>
 #include <QColorDialog>
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QDesktopWidget>
+#include <QDir>
 #include <QCheckBox>
 #include <QImage>
 #include <QInputDialog>
@@ -41,6 +43,7 @@
 #include <QWheelEvent>
 #include <QScreen>
 #include <QShortcut>
+#include <QStandardPaths>
 #include <QSystemTrayIcon>
 #include <QTimer>
 #include <QUrl>
@@ -60,11 +63,13 @@
 #include <CursorManager.h>
 #include <AmbientOcclusionEffect.h>
 #include <AudioInjector.h>
+#include <AudioInjectorManager.h>
 #include <AutoUpdater.h>
 #include <DeferredLightingEffect.h>
 #include <DependencyManager.h>
 #include <EntityScriptingInterface.h>
 #include <ErrorDialog.h>
+#include <FBXGeometryCache.h>
 #include <GlowEffect.h>
 #include <gpu/Batch.h>
 #include <gpu/Context.h>
@@ -180,6 +185,7 @@ static unsigned STARFIELD_NUM_STARS = 50000;
 static unsigned STARFIELD_SEED = 1;
 
 const qint64 MAXIMUM_CACHE_SIZE = 10 * BYTES_PER_GIGABYTES;  // 10GB
+const qint64 MAXIMUM_GEOMETRY_CACHE_SIZE = 2 * BYTES_PER_GIGABYTES;  // 2GB
 
 static QTimer* locationUpdateTimer = NULL;
 static QTimer* balanceUpdateTimer = NULL;
@@ -268,6 +274,7 @@ bool setupEssentials(int& argc, char** argv) {
     auto geometryCache = DependencyManager::set<GeometryCache>();
     auto scriptCache = DependencyManager::set<ScriptCache>();
     auto soundCache = DependencyManager::set<SoundCache>();
+    auto audioInjectorManager = DependencyManager::set<AudioInjectorManager>();
     auto glowEffect = DependencyManager::set<GlowEffect>();
     auto faceshift = DependencyManager::set<Faceshift>();
     auto audio = DependencyManager::set<AudioClient>();
@@ -517,8 +524,15 @@ Application::Application(int& argc, char** argv, QElapsedTimer &startup_time) :
     cache->setCacheDirectory(!cachePath.isEmpty() ? cachePath : "interfaceCache");
     networkAccessManager.setCache(cache);
 
+    // extracted models are kept next to the downloads they came from
+    FBXGeometryCache::setCacheDirectory(cache->cacheDirectory() + "/geometry");
+    FBXGeometryCache::setMaximumCacheSize(MAXIMUM_GEOMETRY_CACHE_SIZE);
+
     ResourceCache::setRequestLimit(3);
 
+    // let models through ahead of the textures they bring in
+    ResourceCache::setTypeWeight("GeometryCache", 2.0f);
+
     _window->setCentralWidget(_glWidget);
 
     _window->restoreGeometry();
@@ -720,6 +734,7 @@ Application::~Application() {
     DependencyManager::destroy<GeometryCache>();
     DependencyManager::destroy<ScriptCache>();
     DependencyManager::destroy<SoundCache>();
+    DependencyManager::destroy<AudioInjectorManager>();
 
     QThread* nodeThread = DependencyManager::get<NodeList>()->thread();
     DependencyManager::destroy<NodeList>();
@@ -1006,6 +1021,22 @@ void Application::runTests() {
     runTimingTests();
 }
 
+void Application::savePerformanceTrace() {
+    if (!PerformanceTimer::isActive()) {
+        qCDebug(interfaceapp) << "Turn on" << MenuOption::DisplayDebugTimingDetails << "to record a performance trace";
+        return;
+    }
+
+    // pick up everything recorded since the stats were last updated
+    PerformanceTimer::tallyAllTimerRecords();
+
+    QString filename = QString("hifi-trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss"));
+    QString path = QDir(QStandardPaths::writableLocation(QStandardPaths::DesktopLocation)).filePath(filename);
+    if (PerformanceTimer::writeChromeTrace(path)) {
+        qCDebug(interfaceapp) << "Saved performance trace to" << path << "- open it in chrome://tracing";
+    }
+}
+
 void Application::audioMuteToggled() {
     QAction* muteAction = Menu::getInstance()->getActionForOption(MenuOption::MuteAudio);
     Q_CHECK_PTR(muteAction);
@@ -2172,6 +2203,7 @@ void Application::init() {
     EntityTree* tree = _entities.getTree();
     _entitySimulation.init(tree, &_physicsEngine, &_entityEditSender);
     tree->setSimulation(&_entitySimulation);
+    _entitySimulation.setWantMovedEntities(true); // so that the entities renderer can re-place them in the scene
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
 
@@ -472,6 +472,7 @@ private slots:
     void manageRunningScriptsWidgetVisibility(bool shown);
     
     void runTests();
+    void savePerformanceTrace();
     
     void audioMuteToggled();
     void faceTrackerMuteToggled();
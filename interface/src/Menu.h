@@ -262,6 +262,7 @@ namespace MenuOption {
     const QString ResetSensors = "Reset Sensors";
     const QString RunningScripts = "Running Scripts";
     const QString RunTimingTests = "Run Timing Tests";
+    const QString SavePerformanceTrace = "Save Performance Trace";
     const QString ScriptEditor = "Script Editor...";
     const QString ScriptedMotorControl = "Enable Scripted Motor Control";
     const QString ShowDSConnectTable = "Show Domain Connection Timing";
@@ -62,7 +62,8 @@ const float DISPLAYNAME_BACKGROUND_ALPHA = 0.4f;
 
 namespace render {
     template <> const ItemKey payloadGetKey(const AvatarSharedPointer& avatar) {
-        return ItemKey::Builder::opaqueShape();
+        // avatars move every frame, there is no point re-placing them in the scene's spatial tree
+        return ItemKey::Builder::opaqueShape().withDynamic();
     }
     template <> const Item::Bound payloadGetBound(const AvatarSharedPointer& avatar) {
         return static_cast<Avatar*>(avatar.get())->getBounds();
@@ -149,7 +150,12 @@ float Avatar::getLODDistance() const {
 
 void Avatar::simulate(float deltaTime) {
     PerformanceTimer perfTimer("simulate");
+    prepareSimulation(deltaTime);
+    simulateModels(deltaTime);
+    finishSimulation(deltaTime);
+}
 
+void Avatar::prepareSimulation(float deltaTime) {
     // update the avatar's position according to its referential
     if (_referential) {
         if (_referential->hasExtraData()) {
@@ -193,34 +199,60 @@ void Avatar::simulate(float deltaTime) {
     bool inViewFrustum = Application::getInstance()->getViewFrustum()->sphereInFrustum(_position, boundingRadius) !=
         ViewFrustum::OUTSIDE;
 
+    _shouldSimulateModels = !_shouldRenderBillboard && inViewFrustum;
+
     {
         PerformanceTimer perfTimer("hand");
         getHand()->simulate(deltaTime, false);
     }
     _skeletonModel.setLODDistance(getLODDistance());
 
-    if (!_shouldRenderBillboard && inViewFrustum) {
-        {
-            PerformanceTimer perfTimer("skeleton");
-            if (_hasNewJointRotations) {
-                for (int i = 0; i < _jointData.size(); i++) {
-                    const JointData& data = _jointData.at(i);
-                    _skeletonModel.setJointState(i, data.valid, data.rotation);
-                }
+    if (_shouldSimulateModels) {
+        // update the geometry now, so that simulating the models doesn't touch the geometry cache
+        _skeletonModel.prepareSimulation();
+        FaceModel& faceModel = getHead()->getFaceModel();
+        faceModel.setLODDistance(getLODDistance());
+        faceModel.prepareSimulation();
+    }
+}
+
+void Avatar::simulateModels(float deltaTime) {
+    if (!_shouldSimulateModels) {
+        _modelSimulationUsecs = 0;
+        return;
+    }
+    quint64 start = usecTimestampNow();
+    {
+        PerformanceTimer perfTimer("skeleton");
+        if (_hasNewJointRotations) {
+            for (int i = 0; i < _jointData.size(); i++) {
+                const JointData& data = _jointData.at(i);
+                _skeletonModel.setJointState(i, data.valid, data.rotation);
             }
-            _skeletonModel.simulate(deltaTime, _hasNewJointRotations);
-            simulateAttachments(deltaTime);
-            _hasNewJointRotations = false;
-        }
-        {
-            PerformanceTimer perfTimer("head");
-            glm::vec3 headPosition = _position;
-            _skeletonModel.getHeadPosition(headPosition);
-            Head* head = getHead();
-            head->setPosition(headPosition);
-            head->setScale(_scale);
-            head->simulate(deltaTime, false, _shouldRenderBillboard);
         }
+        _skeletonModel.simulate(deltaTime, _hasNewJointRotations);
+        _hasNewJointRotations = false;
+    }
+    {
+        PerformanceTimer perfTimer("head");
+        glm::vec3 headPosition = _position;
+        _skeletonModel.getHeadPosition(headPosition);
+        Head* head = getHead();
+        head->setPosition(headPosition);
+        head->setScale(_scale);
+        head->simulate(deltaTime, false, _shouldRenderBillboard);
+    }
+    _modelSimulationUsecs = usecTimestampNow() - start;
+}
+
+void Avatar::finishSimulation(float deltaTime) {
+    _skeletonModel.finishSimulation();
+    getHead()->getFaceModel().finishSimulation();
+
+    // attachments look up their joints through the avatar's thread, so they follow the skeleton here
+    if (_shouldSimulateModels) {
+        PerformanceTimer perfTimer("attachments");
+        simulateAttachments(deltaTime);
     }
 
     // update animation for display name fade in/out
@@ -734,11 +766,12 @@ void Avatar::renderDisplayName(gpu::Batch& batch, const ViewFrustum& frustum) co
     if (shouldShowReceiveStats) {
         float kilobitsPerSecond = getAverageBytesReceivedPerSecond() / (float) BYTES_PER_KILOBIT;
 
-        QString statsFormat = QString("(%1 Kbps, %2 Hz)");
+        QString statsFormat = QString("(%1 Kbps, %2 Hz, %3 usecs simulating)");
         if (!renderedDisplayName.isEmpty()) {
             statsFormat.prepend(" - ");
         }
-        renderedDisplayName += statsFormat.arg(QString::number(kilobitsPerSecond, 'f', 2)).arg(getReceiveRate());
+        renderedDisplayName += statsFormat.arg(QString::number(kilobitsPerSecond, 'f', 2)).arg(getReceiveRate())
+            .arg(_modelSimulationUsecs);
     }
     
     // Compute display name extent/position offset
@@ -82,6 +82,16 @@ public:
     void init();
     void simulate(float deltaTime);
 
+    /// simulate() in three phases, so that the middle one can run for many avatars at once on worker threads. The
+    /// first and last touch the entities, the caches and the attachments and must run on the main thread, while the
+    /// middle one only updates this avatar's joint states, cluster matrices and blendshapes.
+    void prepareSimulation(float deltaTime);
+    void simulateModels(float deltaTime);
+    void finishSimulation(float deltaTime);
+
+    /// Returns the time taken by the last simulateModels().
+    quint64 getModelSimulationUsecs() const { return _modelSimulationUsecs; }
+
     virtual void render(RenderArgs* renderArgs, const glm::vec3& cameraPosition,
         bool postLighting = false);
 
@@ -251,6 +261,8 @@ private:
     NetworkTexturePointer _billboardTexture;
     bool _shouldRenderBillboard;
     bool _isLookAtTarget;
+    bool _shouldSimulateModels = false;
+    quint64 _modelSimulationUsecs = 0;
 
     void renderBillboard(RenderArgs* renderArgs);
     
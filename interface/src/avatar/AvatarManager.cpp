@@ -9,9 +9,14 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <atomic>
 #include <string>
 
+#include <QRunnable>
 #include <QScriptEngine>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -104,7 +109,8 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
 
     PerformanceTimer perfTimer("otherAvatars");
     
-    // simulate avatars
+    // prepare avatars on this thread, since that touches the entities and the caches
+    QVector<std::shared_ptr<Avatar> > simulatingAvatars;
     AvatarHash::iterator avatarIterator = _avatarHash.begin();
     while (avatarIterator != _avatarHash.end()) {
         auto avatar = std::dynamic_pointer_cast<Avatar>(avatarIterator.value());
@@ -118,15 +124,89 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             _avatarFades.push_back(avatarIterator.value());
             avatarIterator = _avatarHash.erase(avatarIterator);
         } else {
-            avatar->simulate(deltaTime);
+            PerformanceTimer perfTimer("prepare");
+            avatar->prepareSimulation(deltaTime);
+            simulatingAvatars.push_back(avatar);
             ++avatarIterator;
         }
     }
+
+    // simulate their models, which only touches each avatar itself, across the worker threads
+    simulateAvatarModels(simulatingAvatars, deltaTime);
+
+    // and finish them back on this thread
+    foreach (const std::shared_ptr<Avatar>& avatar, simulatingAvatars) {
+        PerformanceTimer perfTimer("finish");
+        avatar->finishSimulation(deltaTime);
+    }
     
     // simulate avatar fades
     simulateAvatarFades(deltaTime);
 }
 
+// below this many avatars, the simulation isn't worth handing to other threads
+const int MIN_AVATARS_TO_SIMULATE_IN_PARALLEL = 4;
+
+/// The avatars of a frame whose models are being simulated, claimed one at a time by the threads working on them.
+class AvatarSimulationJob {
+public:
+    AvatarSimulationJob(const QVector<std::shared_ptr<Avatar> >& avatars, float deltaTime) :
+        avatars(avatars), deltaTime(deltaTime), nextAvatar(0) { }
+
+    bool simulateNextAvatar() {
+        int index = nextAvatar++;
+        if (index >= avatars.size()) {
+            return false;
+        }
+        {
+            PerformanceTimer perfTimer("simulateModels");
+            avatars.at(index)->simulateModels(deltaTime);
+        }
+        avatarsDone.release();
+        return true;
+    }
+
+    const QVector<std::shared_ptr<Avatar> > avatars;
+    const float deltaTime;
+    std::atomic<int> nextAvatar;
+    QSemaphore avatarsDone;
+};
+
+class AvatarSimulationTask : public QRunnable {
+public:
+    AvatarSimulationTask(const std::shared_ptr<AvatarSimulationJob>& job) : _job(job) { }
+
+    virtual void run() {
+        while (_job->simulateNextAvatar()) {
+        }
+    }
+
+private:
+    std::shared_ptr<AvatarSimulationJob> _job;
+};
+
+void AvatarManager::simulateAvatarModels(const QVector<std::shared_ptr<Avatar> >& avatars, float deltaTime) {
+    PerformanceTimer perfTimer("simulateAvatarModels");
+
+    int numAvatars = avatars.size();
+    if (numAvatars < MIN_AVATARS_TO_SIMULATE_IN_PARALLEL || QThread::idealThreadCount() < 2) {
+        foreach (const std::shared_ptr<Avatar>& avatar, avatars) {
+            avatar->simulateModels(deltaTime);
+        }
+        return;
+    }
+
+    // this thread works through the avatars too, so the simulation never waits on a busy pool to get started
+    std::shared_ptr<AvatarSimulationJob> job = std::make_shared<AvatarSimulationJob>(avatars, deltaTime);
+    int numHelpers = std::min(QThread::idealThreadCount() - 1, numAvatars - 1);
+    for (int i = 0; i < numHelpers; i++) {
+        QThreadPool::globalInstance()->start(new AvatarSimulationTask(job));
+    }
+    while (job->simulateNextAvatar()) {
+    }
+    job->avatarsDone.acquire(numAvatars);
+}
+
 void AvatarManager::simulateAvatarFades(float deltaTime) {
     QVector<AvatarSharedPointer>::iterator fadingIterator = _avatarFades.begin();
     
@@ -69,6 +69,9 @@ private:
     AvatarManager(const AvatarManager& other);
 
     void simulateAvatarFades(float deltaTime);
+
+    /// Simulates the models of the given avatars, prepared for it, spread across the worker threads.
+    void simulateAvatarModels(const QVector<std::shared_ptr<Avatar> >& avatars, float deltaTime);
     
     // virtual overrides
     virtual AvatarSharedPointer newSharedAvatar();
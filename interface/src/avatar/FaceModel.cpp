@@ -22,7 +22,7 @@ FaceModel::FaceModel(Head* owningHead) :
 }
 
 void FaceModel::simulate(float deltaTime, bool fullUpdate) {
-    updateGeometry();
+    updatePreparedGeometry();
     Avatar* owningAvatar = static_cast<Avatar*>(_owningHead->_owningAvatar);
     glm::vec3 neckPosition;
     if (!owningAvatar->getSkeletonModel().getNeckPosition(neckPosition)) {
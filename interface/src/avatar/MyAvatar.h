@@ -31,7 +31,7 @@ public:
 	MyAvatar();
     ~MyAvatar();
 
-    QByteArray toByteArray();
+    QByteArray toByteArray(bool sendAll = false);
     void reset();
     void update(float deltaTime);
     void simulate(float deltaTime);
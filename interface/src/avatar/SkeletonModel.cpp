@@ -92,10 +92,12 @@ void SkeletonModel::initJointStates(QVector<JointState> states) {
 const float PALM_PRIORITY = DEFAULT_PRIORITY;
 const float LEAN_PRIORITY = DEFAULT_PRIORITY;
 
+// at file scope rather than a function static, since other avatars' skeletons are simulated on worker threads
+static const glm::quat REFERENCE_ORIENTATION = glm::angleAxis(PI, glm::vec3(0.0f, 1.0f, 0.0f));
+
 void SkeletonModel::simulate(float deltaTime, bool fullUpdate) {
     setTranslation(_owningAvatar->getSkeletonPosition());
-    static const glm::quat refOrientation = glm::angleAxis(PI, glm::vec3(0.0f, 1.0f, 0.0f));
-    setRotation(_owningAvatar->getOrientation() * refOrientation);
+    setRotation(_owningAvatar->getOrientation() * REFERENCE_ORIENTATION);
     setScale(glm::vec3(1.0f, 1.0f, 1.0f) * _owningAvatar->getScale());
     setBlendshapeCoefficients(_owningAvatar->getHead()->getBlendshapeCoefficients());
     
@@ -36,10 +36,11 @@
 namespace render {
     template <> const ItemKey payloadGetKey(const Overlay::Pointer& overlay) {
         if (overlay->is3D() && !static_cast<Base3DOverlay*>(overlay.get())->getDrawOnHUD()) {
+            // 3D overlays are few, and they move with their anchor or through their setters without telling the scene
             if (static_cast<Base3DOverlay*>(overlay.get())->getDrawInFront()) {
-                return ItemKey::Builder().withTypeShape().withLayered().build();
+                return ItemKey::Builder().withTypeShape().withLayered().withDynamic().build();
             } else {
-                return ItemKey::Builder::opaqueShape();
+                return ItemKey::Builder::opaqueShape().withDynamic();
             }
         } else {
             return ItemKey::Builder().withTypeShape().withViewSpace().build();
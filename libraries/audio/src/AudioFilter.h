@@ -60,6 +60,14 @@ public:
         a0 = _a0; a1 = _a1; a2 = _a2; b1 = _b1; b2 = _b2;
     }
 
+    void setState(const float32_t xm1, const float32_t xm2, const float32_t ym1, const float32_t ym2) {
+        _xm1 = xm1; _xm2 = xm2; _ym1 = ym1; _ym2 = ym2;
+    }
+
+    void getState(float32_t& xm1, float32_t& xm2, float32_t& ym1, float32_t& ym2) {
+        xm1 = _xm1; xm2 = _xm2; ym1 = _ym1; ym2 = _ym2;
+    }
+
     void render(const float32_t* in, float32_t* out, const uint32_t frames) {
         
         float32_t x;
@@ -149,6 +157,10 @@ public:
     void render(const float32_t* in, float32_t* out, const uint32_t frames) {
         _kernel.render(in,out,frames);
     }
+
+    AudioBiquad& getKernel() {
+        return _kernel;
+    }
     
     void reset() {
         _kernel.reset();
@@ -17,6 +17,7 @@
 #include "AudioBuffer.h"
 #include "AudioFilter.h"
 #include "AudioFormat.h"
+#include "AudioMixKernels.h"
 
 //
 // Helper/convenience class that implements a bank of Filter objects
@@ -127,6 +128,12 @@ public:
 
         const int scale = (2 << ((8 * sizeof(int16_t)) - 1));
 
+        // stereo banks run both channels at once through the mixing kernels
+        if (_channelCount == 2) {
+            renderStereo(in, out, frameCount, (float)scale);
+            return;
+        }
+
         // de-interleave and convert int16_t to float32 (normalized to -1. ... 1.)
         for (uint32_t i = 0; i < frameCount; ++i) {
             for (uint32_t j = 0; j < _channelCount; ++j) {
@@ -167,6 +174,29 @@ public:
         }
     }
 
+private:
+
+    void renderStereo(const int16_t* in, int16_t* out, const uint32_t frameCount, const float32_t scale) {
+        AudioMixKernels::Biquad stages[ _channelCount ][ _filterCount ];
+        for (uint32_t i = 0; i < _channelCount; ++i) {
+            for (uint32_t j = 0; j < _filterCount; ++j) {
+                AudioMixKernels::Biquad& stage = stages[i][j];
+                AudioBiquad& kernel = _filters[j][i].getKernel();
+                kernel.getParameters(stage.a0, stage.a1, stage.a2, stage.b1, stage.b2);
+                kernel.getState(stage.xm1, stage.xm2, stage.ym1, stage.ym2);
+            }
+        }
+
+        AudioMixKernels::renderBiquadCascadeStereo(stages[0], stages[_channelCount - 1], _filterCount, in, out,
+                                                   frameCount, scale);
+
+        for (uint32_t i = 0; i < _channelCount; ++i) {
+            for (uint32_t j = 0; j < _filterCount; ++j) {
+                const AudioMixKernels::Biquad& stage = stages[i][j];
+                _filters[j][i].getKernel().setState(stage.xm1, stage.xm2, stage.ym1, stage.ym2);
+            }
+        }
+    }
 };
 
 //
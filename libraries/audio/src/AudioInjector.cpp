@@ -9,17 +9,12 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
-#include <QtCore/QCoreApplication>
-#include <QtCore/QDataStream>
-
-#include <NodeList.h>
-#include <PacketHeaders.h>
 #include <SharedUtil.h>
-#include <UUID.h>
 #include <soxr.h>
 
 #include "AbstractAudioInterface.h"
 #include "AudioRingBuffer.h"
+#include "AudioInjectorManager.h"
 #include "AudioLogging.h"
 #include "SoundCache.h"
 
@@ -141,136 +136,20 @@ void AudioInjector::injectLocally() {
 
 }
 
-const uchar MAX_INJECTOR_VOLUME = 0xFF;
-
 void AudioInjector::injectToMixer() {
     if (_currentSendPosition < 0 ||
         _currentSendPosition >= _audioData.size()) {
         _currentSendPosition = 0;
     }
 
-    auto nodeList = DependencyManager::get<NodeList>();
-
     // make sure we actually have samples downloaded to inject
-    if (_audioData.size()) {
-
-        // setup the packet for injected audio
-        QByteArray injectAudioPacket = nodeList->byteArrayWithPopulatedHeader(PacketTypeInjectAudio);
-        QDataStream packetStream(&injectAudioPacket, QIODevice::Append);
-
-        // pack some placeholder sequence number for now
-        int numPreSequenceNumberBytes = injectAudioPacket.size();
-        packetStream << (quint16)0;
-
-        // pack stream identifier (a generated UUID)
-        packetStream << QUuid::createUuid();
-
-        // pack the stereo/mono type of the stream
-        packetStream << _options.stereo;
-
-        // pack the flag for loopback
-        uchar loopbackFlag = (uchar) true;
-        packetStream << loopbackFlag;
-
-        // pack the position for injected audio
-        int positionOptionOffset = injectAudioPacket.size();
-        packetStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
-                                  sizeof(_options.position));
-
-        // pack our orientation for injected audio
-        int orientationOptionOffset = injectAudioPacket.size();
-        packetStream.writeRawData(reinterpret_cast<const char*>(&_options.orientation),
-                                  sizeof(_options.orientation));
-
-        // pack zero for radius
-        float radius = 0;
-        packetStream << radius;
-
-        // pack 255 for attenuation byte
-        int volumeOptionOffset = injectAudioPacket.size();
-        quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
-        packetStream << volume;
-
-        packetStream << _options.ignorePenumbra;
-
-        QElapsedTimer timer;
-        timer.start();
-        int nextFrame = 0;
-
-        int numPreAudioDataBytes = injectAudioPacket.size();
-        bool shouldLoop = _options.loop;
-
-        // loop to send off our audio in NETWORK_BUFFER_LENGTH_SAMPLES_PER_CHANNEL byte chunks
-        quint16 outgoingInjectedAudioSequenceNumber = 0;
-        while (_currentSendPosition < _audioData.size() && !_shouldStop) {
-
-            int bytesToCopy = std::min(((_options.stereo) ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL,
-                                       _audioData.size() - _currentSendPosition);
-
-            //  Measure the loudness of this frame
-            _loudness = 0.0f;
-            for (int i = 0; i < bytesToCopy; i += sizeof(int16_t)) {
-                _loudness += abs(*reinterpret_cast<int16_t*>(_audioData.data() + _currentSendPosition + i)) /
-                (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
-            }
-            _loudness /= (float)(bytesToCopy / sizeof(int16_t));
-
-            memcpy(injectAudioPacket.data() + positionOptionOffset,
-                   &_options.position,
-                   sizeof(_options.position));
-            memcpy(injectAudioPacket.data() + orientationOptionOffset,
-                   &_options.orientation,
-                   sizeof(_options.orientation));
-            volume = MAX_INJECTOR_VOLUME * _options.volume;
-            memcpy(injectAudioPacket.data() + volumeOptionOffset, &volume, sizeof(volume));
-
-            // resize the QByteArray to the right size
-            injectAudioPacket.resize(numPreAudioDataBytes + bytesToCopy);
-
-            // pack the sequence number
-            memcpy(injectAudioPacket.data() + numPreSequenceNumberBytes,
-                   &outgoingInjectedAudioSequenceNumber, sizeof(quint16));
-
-            // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
-            memcpy(injectAudioPacket.data() + numPreAudioDataBytes,
-                   _audioData.data() + _currentSendPosition, bytesToCopy);
-
-            // grab our audio mixer from the NodeList, if it exists
-            SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
-
-            // send off this audio packet
-            nodeList->writeDatagram(injectAudioPacket, audioMixer);
-            outgoingInjectedAudioSequenceNumber++;
-
-            _currentSendPosition += bytesToCopy;
-
-            // send two packets before the first sleep so the mixer can start playback right away
-
-            if (_currentSendPosition != bytesToCopy && _currentSendPosition < _audioData.size()) {
-
-                // process events in case we have been told to stop and be deleted
-                QCoreApplication::processEvents();
-
-                if (_shouldStop) {
-                    break;
-                }
-
-                // not the first packet and not done
-                // sleep for the appropriate time
-                int usecToSleep = (++nextFrame * AudioConstants::NETWORK_FRAME_USECS) - timer.nsecsElapsed() / 1000;
-
-                if (usecToSleep > 0) {
-                    usleep(usecToSleep);
-                }
-            }
-
-            if (shouldLoop && _currentSendPosition >= _audioData.size()) {
-                _currentSendPosition = 0;
-            }
-        }
+    auto injectorManager = DependencyManager::get<AudioInjectorManager>();
+    if (_audioData.size() && injectorManager) {
+        // the manager sends our frames from here on, and marks us finished when done or stopped
+        injectorManager->addInjector(this);
+    } else {
+        setIsFinished(true);
     }
-
-    setIsFinished(true);
 }
 
 void AudioInjector::stop() {
@@ -331,21 +210,15 @@ AudioInjector* AudioInjector::playSound(const QString& soundUrl, const float vol
 }
 
 AudioInjector* AudioInjector::playSound(const QByteArray& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface) {
-    QThread* injectorThread = new QThread();
-    injectorThread->setObjectName("Audio Injector Thread");
+    auto injectorManager = DependencyManager::get<AudioInjectorManager>();
+    if (injectorManager.isNull()) {
+        return NULL;
+    }
 
     AudioInjector* injector = new AudioInjector(buffer, options);
     injector->setLocalAudioInterface(localInterface);
 
-    injector->moveToThread(injectorThread);
-
-    // start injecting when the injector thread starts
-    connect(injectorThread, &QThread::started, injector, &AudioInjector::injectAudio);
-
-    // connect the right slots and signals for AudioInjector and thread cleanup
-    connect(injector, &AudioInjector::destroyed, injectorThread, &QThread::quit);
-    connect(injectorThread, &QThread::finished, injectorThread, &QThread::deleteLater);
-
-    injectorThread->start();
+    // start injecting on the thread shared by all injectors
+    injectorManager->startInjector(injector);
     return injector;
 }
@@ -69,6 +69,8 @@ signals:
     void finished();
 
 private:
+    friend class AudioInjectorManager;
+
     void injectToMixer();
     void injectLocally();
     
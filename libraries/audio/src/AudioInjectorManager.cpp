@@ -0,0 +1,216 @@
+//
+//  AudioInjectorManager.cpp
+//  libraries/audio/src
+//
+//  Created on 2015-06-22.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDataStream>
+
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <PacketHeaders.h>
+
+#include "AudioConstants.h"
+#include "AudioInjector.h"
+
+#include "AudioInjectorManager.h"
+
+AudioInjectorManager::AudioInjectorManager() :
+    _timer(this)
+{
+    _thread.setObjectName("Audio Injector Thread");
+
+    _timer.setTimerType(Qt::PreciseTimer);
+    _timer.setInterval((int)AudioConstants::NETWORK_FRAME_MSECS);
+    connect(&_timer, &QTimer::timeout, this, &AudioInjectorManager::sendFrames);
+
+    // the timer can only be stopped from its own thread
+    connect(&_thread, &QThread::finished, &_timer, &QTimer::stop);
+
+    _clock.start();
+    moveToThread(&_thread);
+    _thread.start();
+}
+
+AudioInjectorManager::~AudioInjectorManager() {
+    _thread.quit();
+    _thread.wait();
+
+    qDeleteAll(_activeInjectors);
+    qDeleteAll(_freeInjectors);
+}
+
+void AudioInjectorManager::startInjector(AudioInjector* injector) {
+    injector->moveToThread(&_thread);
+    QMetaObject::invokeMethod(injector, "injectAudio", Qt::QueuedConnection);
+}
+
+void AudioInjectorManager::addInjector(AudioInjector* injector) {
+    Q_ASSERT(QThread::currentThread() == &_thread);
+
+    InjectorStream* stream;
+    if (_freeInjectors.isEmpty()) {
+        stream = new InjectorStream();
+
+        // reserved capacity is kept when the packet is cut back for the next sound
+        stream->packet.reserve(MAX_PACKET_SIZE);
+    } else {
+        stream = _freeInjectors.takeLast();
+    }
+    stream->injector = injector;
+    stream->sequenceNumber = 0;
+    stream->startTime = _clock.nsecsElapsed() / NSECS_PER_USEC;
+    stream->framesSent = 0;
+    writeHeader(stream);
+    _activeInjectors.append(stream);
+
+    if (!_timer.isActive()) {
+        _timer.start();
+    }
+
+    // send the first frames right away rather than on the next tick
+    sendFrames();
+}
+
+void AudioInjectorManager::sendFrames() {
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // grab our audio mixer from the NodeList, if it exists
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+
+    qint64 now = _clock.nsecsElapsed() / NSECS_PER_USEC;
+    for (int i = 0; i < _activeInjectors.size(); ) {
+        InjectorStream* stream = _activeInjectors.at(i);
+        AudioInjector* injector = stream->injector.data();
+        if (!injector || injector->_shouldStop) {
+            finishStream(i);
+            continue;
+        }
+
+        // send two frames before the first wait so the mixer can start playback right away, then one per frame
+        bool finished = false;
+        while (now - stream->startTime >= qMax(stream->framesSent - 1, 0) * (qint64)AudioConstants::NETWORK_FRAME_USECS) {
+            writeFrame(stream);
+            nodeList->writeDatagram(stream->packet, audioMixer);
+
+            if (injector->_currentSendPosition >= injector->_audioData.size()) {
+                if (!injector->_options.loop) {
+                    finished = true;
+                    break;
+                }
+                injector->_currentSendPosition = 0;
+            }
+        }
+        if (finished) {
+            finishStream(i);
+            continue;
+        }
+        i++;
+    }
+
+    if (_activeInjectors.isEmpty()) {
+        _timer.stop();
+    }
+}
+
+const uchar MAX_INJECTOR_VOLUME = 0xFF;
+
+void AudioInjectorManager::writeHeader(InjectorStream* stream) {
+    const AudioInjectorOptions& options = stream->injector->_options;
+
+    // setup the packet for injected audio
+    stream->packet.resize(0);
+    DependencyManager::get<NodeList>()->populatePacketHeader(stream->packet, PacketTypeInjectAudio);
+    QDataStream packetStream(&stream->packet, QIODevice::Append);
+
+    // pack some placeholder sequence number for now
+    stream->sequenceNumberOffset = stream->packet.size();
+    packetStream << (quint16)0;
+
+    // pack stream identifier (a generated UUID)
+    packetStream << QUuid::createUuid();
+
+    // pack the stereo/mono type of the stream
+    packetStream << options.stereo;
+
+    // pack the flag for loopback
+    uchar loopbackFlag = (uchar) true;
+    packetStream << loopbackFlag;
+
+    // pack the position for injected audio
+    stream->positionOffset = stream->packet.size();
+    packetStream.writeRawData(reinterpret_cast<const char*>(&options.position), sizeof(options.position));
+
+    // pack our orientation for injected audio
+    stream->orientationOffset = stream->packet.size();
+    packetStream.writeRawData(reinterpret_cast<const char*>(&options.orientation), sizeof(options.orientation));
+
+    // pack zero for radius
+    float radius = 0;
+    packetStream << radius;
+
+    // pack 255 for attenuation byte
+    stream->volumeOffset = stream->packet.size();
+    quint8 volume = MAX_INJECTOR_VOLUME * options.volume;
+    packetStream << volume;
+
+    packetStream << options.ignorePenumbra;
+
+    stream->audioDataOffset = stream->packet.size();
+}
+
+void AudioInjectorManager::writeFrame(InjectorStream* stream) {
+    AudioInjector* injector = stream->injector.data();
+    const AudioInjectorOptions& options = injector->_options;
+    const QByteArray& audioData = injector->_audioData;
+
+    int bytesToCopy = std::min(((options.stereo) ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL,
+                               audioData.size() - injector->_currentSendPosition);
+
+    //  Measure the loudness of this frame
+    const int16_t* samples = reinterpret_cast<const int16_t*>(audioData.constData() + injector->_currentSendPosition);
+    int numSamples = bytesToCopy / sizeof(int16_t);
+    float loudness = 0.0f;
+    for (int i = 0; i < numSamples; i++) {
+        loudness += abs(samples[i]) / (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
+    }
+    injector->_loudness = loudness / numSamples;
+
+    // the options may have been changed while playing
+    memcpy(stream->packet.data() + stream->positionOffset, &options.position, sizeof(options.position));
+    memcpy(stream->packet.data() + stream->orientationOffset, &options.orientation, sizeof(options.orientation));
+    quint8 volume = MAX_INJECTOR_VOLUME * options.volume;
+    memcpy(stream->packet.data() + stream->volumeOffset, &volume, sizeof(volume));
+
+    // resize the QByteArray to the right size
+    stream->packet.resize(stream->audioDataOffset + bytesToCopy);
+
+    // pack the sequence number
+    memcpy(stream->packet.data() + stream->sequenceNumberOffset, &stream->sequenceNumber, sizeof(quint16));
+
+    // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
+    memcpy(stream->packet.data() + stream->audioDataOffset, samples, bytesToCopy);
+
+    stream->sequenceNumber++;
+    stream->framesSent++;
+    injector->_currentSendPosition += bytesToCopy;
+}
+
+void AudioInjectorManager::finishStream(int index) {
+    InjectorStream* stream = _activeInjectors.at(index);
+    _activeInjectors[index] = _activeInjectors.last();
+    _activeInjectors.removeLast();
+
+    AudioInjector* injector = stream->injector.data();
+    stream->injector.clear();
+    _freeInjectors.append(stream);
+
+    if (injector) {
+        injector->setIsFinished(true);
+    }
+}
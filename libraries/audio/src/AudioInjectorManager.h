@@ -0,0 +1,73 @@
+//
+//  AudioInjectorManager.h
+//  libraries/audio/src
+//
+//  Created on 2015-06-22.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioInjectorManager_h
+#define hifi_AudioInjectorManager_h
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include <DependencyManager.h>
+
+class AudioInjector;
+
+/// Runs every audio injector on one thread. Injectors sending to the mixer are paced by a single timer that, each
+/// network frame, sends the frames that have come due for all of them, so the number of threads and of wakeups doesn't
+/// grow with the number of sounds playing.
+class AudioInjectorManager : public QObject, public Dependency {
+    Q_OBJECT
+    SINGLETON_DEPENDENCY
+
+public:
+    /// Moves the injector to the injector thread and starts it there. Must be called from the injector's thread.
+    void startInjector(AudioInjector* injector);
+
+    /// Starts sending the frames of an injector to the mixer. Must be called on the injector thread.
+    void addInjector(AudioInjector* injector);
+
+private slots:
+    void sendFrames();
+
+private:
+    AudioInjectorManager();
+    virtual ~AudioInjectorManager();
+
+    /// The send state of an injector, recycled from one sound to the next.
+    class InjectorStream {
+    public:
+        QPointer<AudioInjector> injector;
+        QByteArray packet;
+        int sequenceNumberOffset;
+        int positionOffset;
+        int orientationOffset;
+        int volumeOffset;
+        int audioDataOffset;
+        quint16 sequenceNumber;
+        qint64 startTime;
+        int framesSent;
+    };
+
+    void writeHeader(InjectorStream* stream);
+    void writeFrame(InjectorStream* stream);
+    void finishStream(int index);
+
+    QThread _thread;
+    QTimer _timer;
+    QElapsedTimer _clock;
+    QVector<InjectorStream*> _activeInjectors;
+    QVector<InjectorStream*> _freeInjectors;
+};
+
+#endif // hifi_AudioInjectorManager_h
@@ -0,0 +1,401 @@
+//
+//  AudioMixKernels.cpp
+//  libraries/audio/src
+//
+//  Created on 2015-06-23.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <NumericalConstants.h>
+
+#include "AudioConstants.h"
+
+#include "AudioMixKernels.h"
+
+// SSE2 is part of every x86-64 processor
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SSE2_KERNELS
+#include <emmintrin.h>
+#endif
+
+// AVX2 needs checking for at runtime, so its functions are compiled for it one by one, which needs a compiler that
+// allows AVX2 intrinsics in functions targeting it without building the whole file for it
+#if defined(HAVE_SSE2_KERNELS) && (defined(_MSC_VER) || \
+    (defined(__clang__) && !defined(__apple_build_version__) && \
+        (__clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 8))) || \
+    (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 5))
+#define HAVE_AVX2_KERNELS
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_FUNCTION
+#else
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+#endif
+
+using namespace AudioMixKernels;
+
+static inline int16_t saturate(int sample) {
+    return (int16_t)(sample < AudioConstants::MIN_SAMPLE_VALUE ? AudioConstants::MIN_SAMPLE_VALUE :
+        (sample > AudioConstants::MAX_SAMPLE_VALUE ? AudioConstants::MAX_SAMPLE_VALUE : sample));
+}
+
+static void accumulateScalar(int16_t* destination, const int16_t* source, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        destination[i] = saturate(destination[i] + source[i]);
+    }
+}
+
+static void accumulateWithGainScalar(int16_t* destination, const int16_t* source, float gain, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        destination[i] = saturate(destination[i] + (int)(source[i] * gain));
+    }
+}
+
+static void spreadMonoToStereoScalar(int16_t* destination, const int16_t* source, int numFrames,
+                                     float leftGain, int leftDelay, float rightGain, int rightDelay) {
+    for (int i = 0; i < numFrames; i++) {
+        destination[2 * i] = saturate(destination[2 * i] + (int)(source[i - leftDelay] * leftGain));
+        destination[2 * i + 1] = saturate(destination[2 * i + 1] + (int)(source[i - rightDelay] * rightGain));
+    }
+}
+
+static inline float renderBiquad(Biquad& biquad, float x) {
+    float y = (biquad.a0 * x) + (biquad.a1 * biquad.xm1) + (biquad.a2 * biquad.xm2) -
+        (biquad.b1 * biquad.ym1) - (biquad.b2 * biquad.ym2);
+
+    y = (y >= -EPSILON && y < EPSILON) ? 0.0f : y; // clamp to 0
+
+    biquad.xm2 = biquad.xm1;
+    biquad.xm1 = x;
+    biquad.ym2 = biquad.ym1;
+    biquad.ym1 = y;
+    return y;
+}
+
+static void renderBiquadCascadeStereoScalar(Biquad* left, Biquad* right, int numStages, const int16_t* input,
+                                            int16_t* output, int numFrames, float scale) {
+    for (int i = 0; i < numFrames; i++) {
+        float leftSample = ((float)input[2 * i]) / scale;
+        float rightSample = ((float)input[2 * i + 1]) / scale;
+        for (int j = 0; j < numStages; j++) {
+            leftSample = renderBiquad(left[j], leftSample);
+            rightSample = renderBiquad(right[j], rightSample);
+        }
+        output[2 * i] = (int16_t)(leftSample * scale);
+        output[2 * i + 1] = (int16_t)(rightSample * scale);
+    }
+}
+
+#ifdef HAVE_SSE2_KERNELS
+
+static inline __m128i widenLow(__m128i samples) {
+    return _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+}
+
+static inline __m128i widenHigh(__m128i samples) {
+    return _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+}
+
+static inline __m128i applyGain(__m128i samples, __m128 gain) {
+    return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(samples), gain));
+}
+
+static void accumulateSSE2(int16_t* destination, const int16_t* source, int numSamples) {
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i sum = _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(destination + i)),
+                                     _mm_loadu_si128((const __m128i*)(source + i)));
+        _mm_storeu_si128((__m128i*)(destination + i), sum);
+    }
+    accumulateScalar(destination + i, source + i, numSamples - i);
+}
+
+static void accumulateWithGainSSE2(int16_t* destination, const int16_t* source, float gain, int numSamples) {
+    __m128 gains = _mm_set1_ps(gain);
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i sourceSamples = _mm_loadu_si128((const __m128i*)(source + i));
+        __m128i destinationSamples = _mm_loadu_si128((const __m128i*)(destination + i));
+
+        // sum in 32 bits so that only the result saturates
+        __m128i low = _mm_add_epi32(widenLow(destinationSamples), applyGain(widenLow(sourceSamples), gains));
+        __m128i high = _mm_add_epi32(widenHigh(destinationSamples), applyGain(widenHigh(sourceSamples), gains));
+        _mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(low, high));
+    }
+    accumulateWithGainScalar(destination + i, source + i, gain, numSamples - i);
+}
+
+static void spreadMonoToStereoSSE2(int16_t* destination, const int16_t* source, int numFrames,
+                                   float leftGain, int leftDelay, float rightGain, int rightDelay) {
+    __m128 leftGains = _mm_set1_ps(leftGain);
+    __m128 rightGains = _mm_set1_ps(rightGain);
+    int i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        __m128i leftSamples = _mm_loadu_si128((const __m128i*)(source + i - leftDelay));
+        __m128i rightSamples = _mm_loadu_si128((const __m128i*)(source + i - rightDelay));
+        __m128i leftLow = applyGain(widenLow(leftSamples), leftGains);
+        __m128i leftHigh = applyGain(widenHigh(leftSamples), leftGains);
+        __m128i rightLow = applyGain(widenLow(rightSamples), rightGains);
+        __m128i rightHigh = applyGain(widenHigh(rightSamples), rightGains);
+
+        // interleave into frames 0-1, 2-3, 4-5 and 6-7 and add to the destination in 32 bits
+        int16_t* frames = destination + 2 * i;
+        __m128i firstFrames = _mm_loadu_si128((const __m128i*)frames);
+        __m128i lastFrames = _mm_loadu_si128((const __m128i*)(frames + 8));
+        __m128i frames01 = _mm_add_epi32(widenLow(firstFrames), _mm_unpacklo_epi32(leftLow, rightLow));
+        __m128i frames23 = _mm_add_epi32(widenHigh(firstFrames), _mm_unpackhi_epi32(leftLow, rightLow));
+        __m128i frames45 = _mm_add_epi32(widenLow(lastFrames), _mm_unpacklo_epi32(leftHigh, rightHigh));
+        __m128i frames67 = _mm_add_epi32(widenHigh(lastFrames), _mm_unpackhi_epi32(leftHigh, rightHigh));
+        _mm_storeu_si128((__m128i*)frames, _mm_packs_epi32(frames01, frames23));
+        _mm_storeu_si128((__m128i*)(frames + 8), _mm_packs_epi32(frames45, frames67));
+    }
+    spreadMonoToStereoScalar(destination + 2 * i, source + i, numFrames - i, leftGain, leftDelay, rightGain, rightDelay);
+}
+
+static void renderBiquadCascadeStereoSSE2(Biquad* left, Biquad* right, int numStages, const int16_t* input,
+                                          int16_t* output, int numFrames, float scale) {
+    // the left channel runs in the first lane and the right in the second
+    const int MAX_STAGES = 8;
+    if (numStages > MAX_STAGES) {
+        renderBiquadCascadeStereoScalar(left, right, numStages, input, output, numFrames, scale);
+        return;
+    }
+    __m128 a0[MAX_STAGES], a1[MAX_STAGES], a2[MAX_STAGES], b1[MAX_STAGES], b2[MAX_STAGES];
+    __m128 xm1[MAX_STAGES], xm2[MAX_STAGES], ym1[MAX_STAGES], ym2[MAX_STAGES];
+    for (int j = 0; j < numStages; j++) {
+        a0[j] = _mm_setr_ps(left[j].a0, right[j].a0, 0.0f, 0.0f);
+        a1[j] = _mm_setr_ps(left[j].a1, right[j].a1, 0.0f, 0.0f);
+        a2[j] = _mm_setr_ps(left[j].a2, right[j].a2, 0.0f, 0.0f);
+        b1[j] = _mm_setr_ps(left[j].b1, right[j].b1, 0.0f, 0.0f);
+        b2[j] = _mm_setr_ps(left[j].b2, right[j].b2, 0.0f, 0.0f);
+        xm1[j] = _mm_setr_ps(left[j].xm1, right[j].xm1, 0.0f, 0.0f);
+        xm2[j] = _mm_setr_ps(left[j].xm2, right[j].xm2, 0.0f, 0.0f);
+        ym1[j] = _mm_setr_ps(left[j].ym1, right[j].ym1, 0.0f, 0.0f);
+        ym2[j] = _mm_setr_ps(left[j].ym2, right[j].ym2, 0.0f, 0.0f);
+    }
+    __m128 scales = _mm_set1_ps(scale);
+    __m128 minimum = _mm_set1_ps(-EPSILON);
+    __m128 maximum = _mm_set1_ps(EPSILON);
+
+    for (int i = 0; i < numFrames; i++) {
+        __m128 x = _mm_div_ps(_mm_setr_ps((float)input[2 * i], (float)input[2 * i + 1], 0.0f, 0.0f), scales);
+        for (int j = 0; j < numStages; j++) {
+            // same order of operations as the scalar version, so the results match exactly
+            __m128 y = _mm_mul_ps(a0[j], x);
+            y = _mm_add_ps(y, _mm_mul_ps(a1[j], xm1[j]));
+            y = _mm_add_ps(y, _mm_mul_ps(a2[j], xm2[j]));
+            y = _mm_sub_ps(y, _mm_mul_ps(b1[j], ym1[j]));
+            y = _mm_sub_ps(y, _mm_mul_ps(b2[j], ym2[j]));
+            y = _mm_andnot_ps(_mm_and_ps(_mm_cmpge_ps(y, minimum), _mm_cmplt_ps(y, maximum)), y);
+
+            xm2[j] = xm1[j];
+            xm1[j] = x;
+            ym2[j] = ym1[j];
+            ym1[j] = y;
+            x = y;
+        }
+        __m128i samples = _mm_cvttps_epi32(_mm_mul_ps(x, scales));
+        output[2 * i] = (int16_t)_mm_cvtsi128_si32(samples);
+        output[2 * i + 1] = (int16_t)_mm_extract_epi16(samples, 2);
+    }
+
+    float lanes[4];
+    for (int j = 0; j < numStages; j++) {
+        _mm_storeu_ps(lanes, xm1[j]);
+        left[j].xm1 = lanes[0];
+        right[j].xm1 = lanes[1];
+        _mm_storeu_ps(lanes, xm2[j]);
+        left[j].xm2 = lanes[0];
+        right[j].xm2 = lanes[1];
+        _mm_storeu_ps(lanes, ym1[j]);
+        left[j].ym1 = lanes[0];
+        right[j].ym1 = lanes[1];
+        _mm_storeu_ps(lanes, ym2[j]);
+        left[j].ym2 = lanes[0];
+        right[j].ym2 = lanes[1];
+    }
+}
+
+#endif
+
+#ifdef HAVE_AVX2_KERNELS
+
+AVX2_FUNCTION static inline __m256i widen(const int16_t* samples) {
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)samples));
+}
+
+AVX2_FUNCTION static inline __m256i applyGain(__m256i samples, __m256 gain) {
+    return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(samples), gain));
+}
+
+AVX2_FUNCTION static inline __m256i narrow(__m256i first, __m256i second) {
+    // packing works within each 128 bit half, so put the quarters back in order
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(first, second), 0xD8);
+}
+
+AVX2_FUNCTION static void accumulateAVX2(int16_t* destination, const int16_t* source, int numSamples) {
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m256i sum = _mm256_adds_epi16(_mm256_loadu_si256((const __m256i*)(destination + i)),
+                                        _mm256_loadu_si256((const __m256i*)(source + i)));
+        _mm256_storeu_si256((__m256i*)(destination + i), sum);
+    }
+    accumulateScalar(destination + i, source + i, numSamples - i);
+}
+
+AVX2_FUNCTION static void accumulateWithGainAVX2(int16_t* destination, const int16_t* source, float gain,
+                                                 int numSamples) {
+    __m256 gains = _mm256_set1_ps(gain);
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m256i first = _mm256_add_epi32(widen(destination + i), applyGain(widen(source + i), gains));
+        __m256i second = _mm256_add_epi32(widen(destination + i + 8), applyGain(widen(source + i + 8), gains));
+        _mm256_storeu_si256((__m256i*)(destination + i), narrow(first, second));
+    }
+    accumulateWithGainScalar(destination + i, source + i, gain, numSamples - i);
+}
+
+AVX2_FUNCTION static void spreadMonoToStereoAVX2(int16_t* destination, const int16_t* source, int numFrames,
+                                                 float leftGain, int leftDelay, float rightGain, int rightDelay) {
+    __m256 leftGains = _mm256_set1_ps(leftGain);
+    __m256 rightGains = _mm256_set1_ps(rightGain);
+    int i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        __m256i leftSamples = applyGain(widen(source + i - leftDelay), leftGains);
+        __m256i rightSamples = applyGain(widen(source + i - rightDelay), rightGains);
+
+        // unpacking interleaves frames 0-1 and 4-5, then 2-3 and 6-7
+        __m256i low = _mm256_unpacklo_epi32(leftSamples, rightSamples);
+        __m256i high = _mm256_unpackhi_epi32(leftSamples, rightSamples);
+
+        int16_t* frames = destination + 2 * i;
+        __m256i first = _mm256_add_epi32(widen(frames), _mm256_permute2x128_si256(low, high, 0x20));
+        __m256i second = _mm256_add_epi32(widen(frames + 8), _mm256_permute2x128_si256(low, high, 0x31));
+        _mm256_storeu_si256((__m256i*)frames, narrow(first, second));
+    }
+    spreadMonoToStereoScalar(destination + 2 * i, source + i, numFrames - i, leftGain, leftDelay, rightGain, rightDelay);
+}
+
+static bool isAVX2Supported() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const int OSXSAVE_BIT = 1 << 27;
+    const int AVX_BIT = 1 << 28;
+    if ((info[2] & (OSXSAVE_BIT | AVX_BIT)) != (OSXSAVE_BIT | AVX_BIT)) {
+        return false;
+    }
+    // the operating system has to save the upper halves of the registers
+    const unsigned long long XMM_AND_YMM_STATE = 6;
+    if ((_xgetbv(0) & XMM_AND_YMM_STATE) != XMM_AND_YMM_STATE) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    const int AVX2_BIT = 1 << 5;
+    return (info[1] & AVX2_BIT) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+class Kernels {
+public:
+    InstructionSet instructionSet;
+    void (*accumulate)(int16_t*, const int16_t*, int);
+    void (*accumulateWithGain)(int16_t*, const int16_t*, float, int);
+    void (*spreadMonoToStereo)(int16_t*, const int16_t*, int, float, int, float, int);
+    void (*renderBiquadCascadeStereo)(Biquad*, Biquad*, int, const int16_t*, int16_t*, int, float);
+};
+
+static Kernels getKernels(InstructionSet instructionSet) {
+    Kernels kernels = { Scalar, accumulateScalar, accumulateWithGainScalar, spreadMonoToStereoScalar,
+        renderBiquadCascadeStereoScalar };
+#ifdef HAVE_SSE2_KERNELS
+    if (instructionSet >= SSE2) {
+        kernels.instructionSet = SSE2;
+        kernels.accumulate = accumulateSSE2;
+        kernels.accumulateWithGain = accumulateWithGainSSE2;
+        kernels.spreadMonoToStereo = spreadMonoToStereoSSE2;
+        kernels.renderBiquadCascadeStereo = renderBiquadCascadeStereoSSE2;
+    }
+#endif
+#ifdef HAVE_AVX2_KERNELS
+    // the biquads are serial within a channel, so they gain nothing from the wider registers
+    if (instructionSet >= AVX2) {
+        kernels.instructionSet = AVX2;
+        kernels.accumulate = accumulateAVX2;
+        kernels.accumulateWithGain = accumulateWithGainAVX2;
+        kernels.spreadMonoToStereo = spreadMonoToStereoAVX2;
+    }
+#endif
+    return kernels;
+}
+
+static InstructionSet detectInstructionSet() {
+#ifdef HAVE_AVX2_KERNELS
+    if (isAVX2Supported()) {
+        return AVX2;
+    }
+#endif
+#ifdef HAVE_SSE2_KERNELS
+    return SSE2;
+#else
+    return Scalar;
+#endif
+}
+
+static const InstructionSet _supportedInstructionSet = detectInstructionSet();
+static Kernels _kernels = getKernels(_supportedInstructionSet);
+
+InstructionSet AudioMixKernels::getSupportedInstructionSet() {
+    return _supportedInstructionSet;
+}
+
+InstructionSet AudioMixKernels::getInstructionSet() {
+    return _kernels.instructionSet;
+}
+
+void AudioMixKernels::setInstructionSet(InstructionSet instructionSet) {
+    _kernels = getKernels(instructionSet < _supportedInstructionSet ? instructionSet : _supportedInstructionSet);
+}
+
+const char* AudioMixKernels::getInstructionSetName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case SSE2:
+            return "SSE2";
+        case AVX2:
+            return "AVX2";
+        default:
+            return "scalar";
+    }
+}
+
+void AudioMixKernels::accumulate(int16_t* destination, const int16_t* source, int numSamples) {
+    _kernels.accumulate(destination, source, numSamples);
+}
+
+void AudioMixKernels::accumulateWithGain(int16_t* destination, const int16_t* source, float gain, int numSamples) {
+    _kernels.accumulateWithGain(destination, source, gain, numSamples);
+}
+
+void AudioMixKernels::spreadMonoToStereo(int16_t* destination, const int16_t* source, int numFrames,
+                                         float leftGain, int leftDelay, float rightGain, int rightDelay) {
+    _kernels.spreadMonoToStereo(destination, source, numFrames, leftGain, leftDelay, rightGain, rightDelay);
+}
+
+void AudioMixKernels::renderBiquadCascadeStereo(Biquad* left, Biquad* right, int numStages, const int16_t* input,
+                                                int16_t* output, int numFrames, float scale) {
+    _kernels.renderBiquadCascadeStereo(left, right, numStages, input, output, numFrames, scale);
+}
@@ -0,0 +1,63 @@
+//
+//  AudioMixKernels.h
+//  libraries/audio/src
+//
+//  Created on 2015-06-23.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_h
+#define hifi_AudioMixKernels_h
+
+#include <stdint.h>
+
+/// The inner loops of mixing, in vector versions (SSE2, AVX2) and a scalar fallback. The best version the machine
+/// supports is picked when the library loads; every version gives the same samples, bit for bit.
+namespace AudioMixKernels {
+
+    enum InstructionSet {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /// Returns the best instruction set the kernels can use on this machine.
+    InstructionSet getSupportedInstructionSet();
+
+    /// Returns the instruction set the kernels are using.
+    InstructionSet getInstructionSet();
+
+    /// Makes the kernels use the given instruction set, or the best supported one below it. Meant for tests and
+    /// benchmarks: not to be called while other threads are mixing.
+    void setInstructionSet(InstructionSet instructionSet);
+
+    const char* getInstructionSetName(InstructionSet instructionSet);
+
+    /// Adds the source samples to the destination, saturating.
+    void accumulate(int16_t* destination, const int16_t* source, int numSamples);
+
+    /// Adds the source samples, scaled by the gain and truncated, to the destination, saturating.
+    void accumulateWithGain(int16_t* destination, const int16_t* source, float gain, int numSamples);
+
+    /// Adds mono source frames to interleaved stereo destination frames, each channel scaled by its gain and delayed
+    /// by its number of samples, saturating. The source must be preceded by as many samples as the longest delay.
+    void spreadMonoToStereo(int16_t* destination, const int16_t* source, int numFrames,
+                            float leftGain, int leftDelay, float rightGain, int rightDelay);
+
+    /// A section of a biquad cascade, laid out as AudioBiquad keeps it.
+    class Biquad {
+    public:
+        float a0, a1, a2, b1, b2; // coefficients
+        float xm1, xm2, ym1, ym2; // delay line
+    };
+
+    /// Runs interleaved stereo frames through a cascade of biquads for each channel, as AudioFilterBank does: samples
+    /// are divided by the scale into the cascade and multiplied by it (truncating) out of it.
+    void renderBiquadCascadeStereo(Biquad* left, Biquad* right, int numStages, const int16_t* input, int16_t* output,
+                                   int numFrames, float scale);
+}
+
+#endif // hifi_AudioMixKernels_h
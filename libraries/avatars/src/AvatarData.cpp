@@ -46,6 +46,7 @@ AvatarData::AvatarData() :
     _bodyRoll(0.0f),
     _targetScale(1.0f),
     _handState(0),
+    _lastJointKeyframeTime(0),
     _keyState(NO_KEY_DOWN),
     _forceFaceTrackerConnected(false),
     _hasNewJointRotations(true),
@@ -131,7 +132,7 @@ void AvatarData::setHandPosition(const glm::vec3& handPosition) {
     _handPosition = glm::inverse(getOrientation()) * (handPosition - _position);
 }
 
-QByteArray AvatarData::toByteArray() {
+QByteArray AvatarData::toByteArray(bool sendAll) {
     // TODO: DRY this up to a shared method
     // that can pack any type given the number of bytes
     // and return the number of bytes to push the pointer
@@ -233,6 +234,13 @@ QByteArray AvatarData::toByteArray() {
 
     // joint data
     *destinationBuffer++ = _jointData.size();
+
+    // a keyframe carries every valid joint, anyone that missed a delta catches up on the next one
+    quint64 now = usecTimestampNow();
+    bool isKeyframe = sendAll || _lastSentJointData.size() != _jointData.size()
+        || now - _lastJointKeyframeTime >= AVATAR_JOINT_KEYFRAME_INTERVAL_USECS;
+    *destinationBuffer++ = isKeyframe ? JOINT_DATA_KEYFRAME : JOINT_DATA_DELTA;
+
     unsigned char validity = 0;
     int validityBit = 0;
     foreach (const JointData& data, _jointData) {
@@ -247,9 +255,54 @@ QByteArray AvatarData::toByteArray() {
     if (validityBit != 0) {
         *destinationBuffer++ = validity;
     }
-    foreach (const JointData& data, _jointData) {
-        if (data.valid) {
-            destinationBuffer += packOrientationQuatToBytes(destinationBuffer, data.rotation);
+
+    auto shouldSendJoint = [&](int index)->bool {
+        const JointData& data = _jointData.at(index);
+        if (!data.valid) {
+            return false;
+        }
+        if (isKeyframe) {
+            return true;
+        }
+        const JointData& lastSentData = _lastSentJointData.at(index);
+        return !lastSentData.valid || fabsf(glm::dot(data.rotation, lastSentData.rotation)) < AVATAR_MIN_JOINT_ROTATION_DOT;
+    };
+
+    if (!isKeyframe) {
+        // which of the valid joints have a rotation in this packet
+        unsigned char changed = 0;
+        int changedBit = 0;
+        for (int i = 0; i < _jointData.size(); i++) {
+            if (shouldSendJoint(i)) {
+                changed |= (1 << changedBit);
+            }
+            if (++changedBit == BITS_IN_BYTE) {
+                *destinationBuffer++ = changed;
+                changedBit = changed = 0;
+            }
+        }
+        if (changedBit != 0) {
+            *destinationBuffer++ = changed;
+        }
+    }
+
+    for (int i = 0; i < _jointData.size(); i++) {
+        if (shouldSendJoint(i)) {
+            destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, _jointData.at(i).rotation);
+        }
+    }
+
+    // the next delta is taken against what this packet told its receiver, a full send included, otherwise a joint that
+    // moves in a full send and then goes back isn't sent again and the receiver keeps the moved rotation
+    if (isKeyframe) {
+        _lastSentJointData = _jointData;
+        _lastJointKeyframeTime = now;
+    } else {
+        for (int i = 0; i < _jointData.size(); i++) {
+            if (shouldSendJoint(i)) {
+                _lastSentJointData[i].rotation = _jointData.at(i).rotation;
+            }
+            _lastSentJointData[i].valid = _jointData.at(i).valid;
         }
     }
         
@@ -296,8 +349,9 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
     // }
     // + 1 byte for pupilSize
     // + 1 byte for numJoints (0)
-    // = 45 bytes
-    int minPossibleSize = 45;
+    // + 1 byte for the joint data encoding
+    // = 46 bytes
+    int minPossibleSize = 46;
     
     int maxAvailableSize = packet.size() - offset;
     if (minPossibleSize > maxAvailableSize) {
@@ -498,8 +552,11 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
     
     // joint data
     int numJoints = *sourceBuffer++;
+    bool isKeyframe = (*sourceBuffer++ == JOINT_DATA_KEYFRAME);
     int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
-    minPossibleSize += bytesOfValidity;
+
+    // a delta follows the validity bits with the same number of bits saying which joints are in this packet
+    minPossibleSize += isKeyframe ? bytesOfValidity : 2 * bytesOfValidity;
     if (minPossibleSize > maxAvailableSize) {
         if (shouldLogError(now)) {
             qCDebug(avatars) << "Malformed AvatarData packet after JointValidityBits;"
@@ -509,7 +566,6 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
         }
         return maxAvailableSize;
     }
-    int numValidJoints = 0;
     _jointData.resize(numJoints);
     { // validity bits
         unsigned char validity = 0;
@@ -518,19 +574,30 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
             if (validityBit == 0) {
                 validity = *sourceBuffer++;
             }
-            bool valid = (bool)(validity & (1 << validityBit));
-            if (valid) {
-                ++numValidJoints;
-            }
-            _jointData[i].valid = valid;
+            _jointData[i].valid = (bool)(validity & (1 << validityBit));
             validityBit = (validityBit + 1) % BITS_IN_BYTE; 
         }
     }
-    // 1 + bytesOfValidity bytes
+    // 2 + bytesOfValidity bytes
+
+    const unsigned char* changedBits = NULL;
+    if (!isKeyframe) {
+        changedBits = sourceBuffer;
+        sourceBuffer += bytesOfValidity;
+    }
+    auto isJointInPacket = [&](int index)->bool {
+        return _jointData[index].valid
+            && (isKeyframe || (changedBits[index / BITS_IN_BYTE] & (1 << (index % BITS_IN_BYTE))));
+    };
+
+    int numJointsInPacket = 0;
+    for (int i = 0; i < numJoints; i++) {
+        if (isJointInPacket(i)) {
+            ++numJointsInPacket;
+        }
+    }
 
-    // each joint rotation component is stored in two bytes (sizeof(uint16_t))
-    int COMPONENTS_PER_QUATERNION = 4;
-    minPossibleSize += numValidJoints * COMPONENTS_PER_QUATERNION * sizeof(uint16_t);
+    minPossibleSize += numJointsInPacket * SMALLEST_THREE_QUAT_BYTES;
     if (minPossibleSize > maxAvailableSize) {
         if (shouldLogError(now)) {
             qCDebug(avatars) << "Malformed AvatarData packet after JointData;"
@@ -541,15 +608,14 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
         return maxAvailableSize;
     }
 
-    { // joint data
+    { // joint data, joints missing from a delta keep the rotation we last received for them
         for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (data.valid) {
+            if (isJointInPacket(i)) {
                 _hasNewJointRotations = true;
-                sourceBuffer += unpackOrientationQuatFromBytes(sourceBuffer, data.rotation);
+                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, _jointData[i].rotation);
             }
         }
-    } // numJoints * 8 bytes
+    } // numJointsInPacket * 6 bytes
     
     int numBytesRead = sourceBuffer - startPosition;
     _averageBytesReceived.updateAverage(numBytesRead); 
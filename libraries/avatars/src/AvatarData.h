@@ -76,6 +76,14 @@ const quint32 AVATAR_MOTION_SCRIPTABLE_BITS =
 
 const qint64 AVATAR_SILENCE_THRESHOLD_USECS = 5 * USECS_PER_SECOND;
 
+// joint rotations are sent in full on a keyframe, in between only the joints that turned by more than about half a
+// degree since they were last sent go out
+const quint64 AVATAR_JOINT_KEYFRAME_INTERVAL_USECS = USECS_PER_SECOND;
+const float AVATAR_MIN_JOINT_ROTATION_DOT = 0.99999f;
+
+const unsigned char JOINT_DATA_KEYFRAME = 0;
+const unsigned char JOINT_DATA_DELTA = 1;
+
 // Bitset of state flags - we store the key state, hand state, faceshift, chat circling, and existance of
 // referential data in this bit set. The hand state is an octal, but is split into two sections to maintain
 // backward compatibility. The bits are ordered as such (0-7 left to right).
@@ -173,7 +181,9 @@ public:
     glm::vec3 getHandPosition() const;
     void setHandPosition(const glm::vec3& handPosition);
 
-    virtual QByteArray toByteArray();
+    /// \param sendAll true to include every joint rotation, for a receiver that may have missed earlier data. Otherwise
+    /// only the joints that changed since the last call are included, along with a periodic keyframe.
+    virtual QByteArray toByteArray(bool sendAll = false);
 
     /// \return true if an error should be logged
     bool shouldLogError(const quint64& now);
@@ -363,6 +373,8 @@ protected:
     char _handState;
 
     QVector<JointData> _jointData; ///< the state of the skeleton joints
+    QVector<JointData> _lastSentJointData; ///< the joint state receivers were left with by the last toByteArray()
+    quint64 _lastJointKeyframeTime;
 
     // key state
     KeyState _keyState;
@@ -10,6 +10,7 @@
 //
 
 #include <AudioConstants.h>
+#include <AudioInjectorManager.h>
 #include <GLMHelpers.h>
 #include <NodeList.h>
 #include <StreamUtils.h>
@@ -28,7 +29,6 @@ Player::Player(AvatarData* avatar) :
     _pausedFrame(INVALID_FRAME),
     _timerOffset(0),
     _audioOffset(0),
-    _audioThread(NULL),
     _playFromCurrentPosition(true),
     _loop(false),
     _useAttachments(true),
@@ -114,13 +114,13 @@ void Player::startPlaying() {
         _avatar->setForceFaceTrackerConnected(true);
         
         qCDebug(avatars) << "Recorder::startPlaying()";
-        setupAudioThread();
+        setupAudio();
         _currentFrame = 0;
         _timerOffset = 0;
         _timer.start();
     } else {
         qCDebug(avatars) << "Recorder::startPlaying(): Unpause";
-        setupAudioThread();
+        setupAudio();
         _timer.start();
         
         setCurrentFrame(_pausedFrame);
@@ -134,7 +134,7 @@ void Player::stopPlaying() {
     }
     _pausedFrame = INVALID_FRAME;
     _timer.invalidate();
-    cleanupAudioThread();
+    cleanupAudio();
     _avatar->clearJointsData();
     
     // Turn off fake face tracker connection
@@ -159,40 +159,33 @@ void Player::stopPlaying() {
 void Player::pausePlayer() {
     _timerOffset = elapsed();
     _timer.invalidate();
-    cleanupAudioThread();
+    cleanupAudio();
     
     _pausedFrame = _currentFrame;
     qCDebug(avatars) << "Recorder::pausePlayer()";
 }
 
-void Player::setupAudioThread() {
-    _audioThread = new QThread();
-    _audioThread->setObjectName("Player Audio Thread");
+void Player::setupAudio() {
     _options.position = _avatar->getPosition();
     _options.orientation = _avatar->getOrientation();
     _options.stereo = _recording->numberAudioChannel() == 2;
     
     _injector.reset(new AudioInjector(_recording->getAudioData(), _options), &QObject::deleteLater);
-    _injector->moveToThread(_audioThread);
-    _audioThread->start();
-    QMetaObject::invokeMethod(_injector.data(), "injectAudio", Qt::QueuedConnection);
+    auto injectorManager = DependencyManager::get<AudioInjectorManager>();
+    if (injectorManager) {
+        injectorManager->startInjector(_injector.data());
+    }
 }
 
-void Player::cleanupAudioThread() {
+void Player::cleanupAudio() {
+    // the injector is deleted later on the injector thread, where the manager lets go of it
     _injector->stop();
-    QObject::connect(_injector.data(), &AudioInjector::finished,
-                     _injector.data(), &AudioInjector::deleteLater);
-    QObject::connect(_injector.data(), &AudioInjector::destroyed,
-                     _audioThread, &QThread::quit);
-    QObject::connect(_audioThread, &QThread::finished,
-                     _audioThread, &QThread::deleteLater);
     _injector.clear();
-    _audioThread = NULL;
 }
 
 void Player::loopRecording() {
-    cleanupAudioThread();
-    setupAudioThread();
+    cleanupAudio();
+    setupAudio();
     _currentFrame = 0;
     _timerOffset = 0;
     _timer.restart();
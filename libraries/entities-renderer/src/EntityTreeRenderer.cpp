@@ -309,6 +309,16 @@ void EntityTreeRenderer::update() {
     if (_tree && !_shuttingDown) {
         EntityTree* tree = static_cast<EntityTree*>(_tree);
         tree->update();
+
+        // re-place the entities that changed or moved in the scene
+        EntitySimulation* simulation = tree->getSimulation();
+        if (simulation) {
+            SetOfEntities movedEntities;
+            simulation->lock();
+            simulation->takeMovedEntities(movedEntities);
+            simulation->unlock();
+            updateEntitiesInScene(movedEntities);
+        }
         
         // check to see if the avatar has moved and if we need to handle enter/leave entity logic
         checkEnterLeaveEntities();
@@ -1020,6 +1030,19 @@ void EntityTreeRenderer::addEntityToScene(EntityItemPointer entity) {
     scene->enqueuePendingChanges(pendingChanges);
 }
 
+void EntityTreeRenderer::updateEntitiesInScene(const SetOfEntities& entities) {
+    if (entities.isEmpty()) {
+        return;
+    }
+    render::PendingChanges pendingChanges;
+    auto scene = _viewState->getMain3DScene();
+    foreach (EntityItemPointer entity, entities) {
+        if (_entitiesInScene.value(entity->getEntityItemID()) == entity) {
+            entity->updateInScene(entity, scene, pendingChanges);
+        }
+    }
+    scene->enqueuePendingChanges(pendingChanges);
+}
 
 void EntityTreeRenderer::entitySciptChanging(const EntityItemID& entityID) {
     if (_tree && !_shuttingDown) {
@@ -15,6 +15,7 @@
 #include <QSet>
 #include <QStack>
 
+#include <EntitySimulation.h>
 #include <EntityTree.h>
 #include <EntityScriptingInterface.h> // for RayToEntityIntersectionResult
 #include <MouseEvent.h>
@@ -124,6 +125,7 @@ protected:
 
 private:
     void addEntityToScene(EntityItemPointer entity);
+    void updateEntitiesInScene(const SetOfEntities& entities);
 
     void applyZonePropertiesToScene(std::shared_ptr<ZoneEntityItem> zone);
     void renderElementProxy(EntityTreeElement* entityTreeElement, RenderArgs* args);
@@ -15,9 +15,12 @@
 namespace render {
     template <> const ItemKey payloadGetKey(const RenderableEntityItemProxy::Pointer& payload) { 
         if (payload && payload->entity) {
-            if (payload->entity->getType() == EntityTypes::Light) {
-                return ItemKey::Builder::light();
+            auto builder = payload->entity->getType() == EntityTypes::Light ? ItemKey::Builder::light()
+                                                                            : ItemKey::Builder::opaqueShape();
+            if (!isEntityStaticInScene(*payload->entity)) {
+                builder.withDynamic();
             }
+            return builder.build();
         }
         return ItemKey::Builder::opaqueShape();
     }
@@ -31,6 +31,12 @@ namespace render {
    template <> void payloadRender(const RenderableEntityItemProxy::Pointer& payload, RenderArgs* args);
 }
 
+// Entities that are moving, or that physics may move, are dynamic. The others only move when they are changed, and the
+// EntityTreeRenderer then updates them in the scene, so they can stay in its spatial tree.
+inline bool isEntityStaticInScene(const EntityItem& entity) {
+    return !entity.isMoving() && !entity.getCollisionsWillMove();
+}
+
 // Mixin class for implementing basic single item rendering
 class SimpleRenderableEntityItem {
 public:
@@ -38,19 +44,28 @@ public:
         _myItem = scene->allocateID();
         
         auto renderData = RenderableEntityItemProxy::Pointer(new RenderableEntityItemProxy(self));
-        auto renderPayload = render::PayloadPointer(new RenderableEntityItemProxy::Payload(renderData));
+        _myPayload = render::PayloadPointer(new RenderableEntityItemProxy::Payload(renderData));
         
-        pendingChanges.resetItem(_myItem, renderPayload);
+        pendingChanges.resetItem(_myItem, _myPayload);
         
         return true;
     }
 
     void removeFromScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges) {
         pendingChanges.removeItem(_myItem);
+        _myPayload.reset();
+    }
+
+    void updateInScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges) {
+        // resetting the payload picks up the key as well as the bound, the entity may have started or stopped moving
+        if (_myPayload) {
+            pendingChanges.resetItem(_myItem, _myPayload);
+        }
     }
     
 private:
     render::ItemID _myItem;
+    render::PayloadPointer _myPayload;
 };
 
 
@@ -58,6 +73,7 @@ private:
 public: \
     virtual bool addToScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges) { return _renderHelper.addToScene(self, scene, pendingChanges); } \
     virtual void removeFromScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges) { _renderHelper.removeFromScene(self, scene, pendingChanges); } \
+    virtual void updateInScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges) { _renderHelper.updateInScene(self, scene, pendingChanges); } \
 private: \
     SimpleRenderableEntityItem _renderHelper;
 
@@ -23,6 +23,7 @@
 
 #include "EntityTreeRenderer.h"
 #include "EntitiesRendererLogging.h"
+#include "RenderableEntityItem.h"
 #include "RenderableModelEntityItem.h"
 
 EntityItemPointer RenderableModelEntityItem::factory(const EntityItemID& entityID, const EntityItemProperties& properties) {
@@ -149,6 +150,9 @@ public:
 
 namespace render {
     template <> const ItemKey payloadGetKey(const RenderableModelEntityItemMeta::Pointer& payload) { 
+        if (payload && payload->entity && !isEntityStaticInScene(*payload->entity)) {
+            return ItemKey::Builder::opaqueShape().withDynamic();
+        }
         return ItemKey::Builder::opaqueShape();
     }
     
@@ -172,9 +176,9 @@ bool RenderableModelEntityItem::addToScene(EntityItemPointer self, std::shared_p
     _myMetaItem = scene->allocateID();
     
     auto renderData = RenderableModelEntityItemMeta::Pointer(new RenderableModelEntityItemMeta(self));
-    auto renderPayload = render::PayloadPointer(new RenderableModelEntityItemMeta::Payload(renderData));
+    _myMetaPayload = render::PayloadPointer(new RenderableModelEntityItemMeta::Payload(renderData));
     
-    pendingChanges.resetItem(_myMetaItem, renderPayload);
+    pendingChanges.resetItem(_myMetaItem, _myMetaPayload);
     
     if (_model) {
         return _model->addToScene(scene, pendingChanges);
@@ -186,11 +190,20 @@ bool RenderableModelEntityItem::addToScene(EntityItemPointer self, std::shared_p
 void RenderableModelEntityItem::removeFromScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, 
                                                 render::PendingChanges& pendingChanges) {
     pendingChanges.removeItem(_myMetaItem);
+    _myMetaPayload.reset();
     if (_model) {
         _model->removeFromScene(scene, pendingChanges);
     }
 }
 
+void RenderableModelEntityItem::updateInScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene,
+                                              render::PendingChanges& pendingChanges) {
+    // only the meta item, the model parts are updated by render() once the model has been moved to match
+    if (_myMetaPayload) {
+        pendingChanges.resetItem(_myMetaItem, _myMetaPayload);
+    }
+}
+
 
 // NOTE: this only renders the "meta" portion of the Model, namely it renders debugging items, and it handles
 // the per frame simulation/update that might be required if the models properties changed.
@@ -219,6 +232,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
             scene->enqueuePendingChanges(pendingChanges);
 
             _model->setVisibleInScene(getVisible(), scene);
+            _model->setStaticInScene(isEntityStaticInScene(*this) && !isAnimatingSomething(), scene);
         }
 
 
@@ -263,6 +277,11 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
                         _model->simulate(0.0f);
                     }
                     _needsInitialSimulation = false;
+
+                    // static parts aren't re-placed in the scene unless we say they moved
+                    if (_model->isStaticInScene()) {
+                        _model->updateBoundsInScene(AbstractViewStateInterface::instance()->getMain3DScene());
+                    }
                 }
             }
         }
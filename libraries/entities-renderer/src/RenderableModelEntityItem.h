@@ -50,6 +50,7 @@ public:
     virtual bool readyToAddToScene(RenderArgs* renderArgs = nullptr);
     virtual bool addToScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges);
     virtual void removeFromScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges);
+    virtual void updateInScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges);
 
 
     virtual void render(RenderArgs* args);
@@ -82,6 +83,7 @@ private:
     QVector<QVector<glm::vec3>> _points;
     
     render::ItemID _myMetaItem;
+    render::PayloadPointer _myMetaPayload;
 };
 
 #endif // hifi_RenderableModelEntityItem_h
@@ -20,6 +20,8 @@
 #include <GeometryCache.h>
 #include <PerfStat.h>
 
+#include "RenderableEntityItem.h"
+
 EntityItemPointer RenderableZoneEntityItem::factory(const EntityItemID& entityID, const EntityItemProperties& properties) {
     return EntityItemPointer(new RenderableZoneEntityItem(entityID, properties));
 }
@@ -174,6 +176,9 @@ public:
 
 namespace render {
     template <> const ItemKey payloadGetKey(const RenderableZoneEntityItemMeta::Pointer& payload) {
+        if (payload && payload->entity && !isEntityStaticInScene(*payload->entity)) {
+            return ItemKey::Builder::opaqueShape().withDynamic();
+        }
         return ItemKey::Builder::opaqueShape();
     }
     
@@ -197,16 +202,25 @@ bool RenderableZoneEntityItem::addToScene(EntityItemPointer self, std::shared_pt
     _myMetaItem = scene->allocateID();
     
     auto renderData = RenderableZoneEntityItemMeta::Pointer(new RenderableZoneEntityItemMeta(self));
-    auto renderPayload = render::PayloadPointer(new RenderableZoneEntityItemMeta::Payload(renderData));
+    _myMetaPayload = render::PayloadPointer(new RenderableZoneEntityItemMeta::Payload(renderData));
     
-    pendingChanges.resetItem(_myMetaItem, renderPayload);
+    pendingChanges.resetItem(_myMetaItem, _myMetaPayload);
     return true;
 }
 
 void RenderableZoneEntityItem::removeFromScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene,
                                                 render::PendingChanges& pendingChanges) {
     pendingChanges.removeItem(_myMetaItem);
+    _myMetaPayload.reset();
     if (_model) {
         _model->removeFromScene(scene, pendingChanges);
     }
 }
+
+void RenderableZoneEntityItem::updateInScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene,
+                                             render::PendingChanges& pendingChanges) {
+    // the boundaries model is left dynamic, it is only drawn while editing zones
+    if (_myMetaPayload) {
+        pendingChanges.resetItem(_myMetaItem, _myMetaPayload);
+    }
+}
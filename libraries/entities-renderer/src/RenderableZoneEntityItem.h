@@ -37,6 +37,7 @@ public:
     
     virtual bool addToScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges);
     virtual void removeFromScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges);
+    virtual void updateInScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges);
     
 private:
     Model* getModel();
@@ -50,6 +51,7 @@ private:
     bool _needsInitialSimulation;
     
     render::ItemID _myMetaItem;
+    render::PayloadPointer _myMetaPayload;
 };
 
 #endif // hifi_RenderableZoneEntityItem_h
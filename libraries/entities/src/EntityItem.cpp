@@ -137,6 +137,33 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     
     OctreeElement::AppendState appendState = OctreeElement::COMPLETED; // assume the best
 
+    EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
+    EntityPropertyFlags requestedProperties = getEntityProperties(params);
+    EntityPropertyFlags propertiesDidntFit = requestedProperties;
+
+    // If we are being called for a subsequent pass at appendEntityData() that failed to completely encode this item,
+    // then our entityTreeElementExtraEncodeData should include data about which properties we need to append.
+    if (entityTreeElementExtraEncodeData && entityTreeElementExtraEncodeData->entities.contains(getEntityItemID())) {
+        requestedProperties = entityTreeElementExtraEncodeData->entities.value(getEntityItemID());
+    }
+
+    // When every property is requested the encoding is the same for every client, so if nothing has changed since we
+    // last encoded this entity we can send those same bytes again.
+    bool encodingAllProperties = (requestedProperties == propertiesDidntFit);
+    EncodedDataTimes encodedDataTimes = getEncodedDataTimes();
+    if (encodingAllProperties) {
+        QByteArray encodedData;
+        _encodedDataCacheMutex.lock();
+        if (_encodedDataCacheTimes == encodedDataTimes) {
+            encodedData = _encodedDataCache;
+        }
+        _encodedDataCacheMutex.unlock();
+
+        if (!encodedData.isEmpty() && packetData->appendRawData(encodedData)) {
+            return appendState;
+        }
+    }
+
     // encode our ID as a byte count coded byte stream
     QByteArray encodedID = getID().toRfc4122();
 
@@ -154,18 +181,8 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     ByteCountCoded<quint64> simulatedDeltaCoder = simulatedDelta;
     QByteArray encodedSimulatedDelta = simulatedDeltaCoder;
 
-
-    EntityPropertyFlags propertyFlags(PROP_LAST_ITEM);
-    EntityPropertyFlags requestedProperties = getEntityProperties(params);
-    EntityPropertyFlags propertiesDidntFit = requestedProperties;
-
-    // If we are being called for a subsequent pass at appendEntityData() that failed to completely encode this item,
-    // then our entityTreeElementExtraEncodeData should include data about which properties we need to append.
-    if (entityTreeElementExtraEncodeData && entityTreeElementExtraEncodeData->entities.contains(getEntityItemID())) {
-        requestedProperties = entityTreeElementExtraEncodeData->entities.value(getEntityItemID());
-    }
-
     LevelDetails entityLevel = packetData->startLevel();
+    int startOfEntity = packetData->getUncompressedByteOffset();
 
     quint64 lastEdited = getLastEdited();
 
@@ -284,6 +301,16 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         }
        
         packetData->endLevel(entityLevel);
+
+        if (encodingAllProperties && appendState == OctreeElement::COMPLETED) {
+            int endOfEntity = packetData->getUncompressedByteOffset();
+            QByteArray encodedData((const char*)packetData->getUncompressedData(startOfEntity), endOfEntity - startOfEntity);
+
+            _encodedDataCacheMutex.lock();
+            _encodedDataCache = encodedData;
+            _encodedDataCacheTimes = encodedDataTimes;
+            _encodedDataCacheMutex.unlock();
+        }
     } else {
         packetData->discardLevel(entityLevel);
         appendState = OctreeElement::NONE; // if we got here, then we didn't include the item
@@ -17,6 +17,8 @@
 
 #include <glm/glm.hpp>
 
+#include <QMutex>
+
 #include <AnimationCache.h> // for Animation, AnimationCache, and AnimationPointer classes
 #include <CollisionInfo.h>
 #include <Octree.h> // for EncodeBitstreamParams class
@@ -165,6 +167,8 @@ public:
                             render::PendingChanges& pendingChanges) { return false; } // by default entity items don't add to scene
     virtual void removeFromScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene, 
                                 render::PendingChanges& pendingChanges) { } // by default entity items don't add to scene
+    virtual void updateInScene(EntityItemPointer self, std::shared_ptr<render::Scene> scene,
+                               render::PendingChanges& pendingChanges) { } // called after the entity changed or moved
     virtual void render(RenderArgs* args) { } // by default entity items don't know how to render
 
     static int expectedBytes();
@@ -453,6 +457,32 @@ protected:
     bool _simulated; // set by EntitySimulation
 
     QHash<QUuid, EntityActionPointer> _objectActions;
+
+    // the change times that an encoding of this entity is valid for, any edit moves at least one of them on
+    struct EncodedDataTimes {
+        quint64 created;
+        quint64 lastEdited;
+        quint64 lastUpdated;
+        quint64 lastSimulated;
+        quint64 changedOnServer;
+        quint64 simulatorIDChanged;
+
+        bool operator==(const EncodedDataTimes& other) const {
+            return created == other.created && lastEdited == other.lastEdited && lastUpdated == other.lastUpdated
+                && lastSimulated == other.lastSimulated && changedOnServer == other.changedOnServer
+                && simulatorIDChanged == other.simulatorIDChanged;
+        }
+    };
+    EncodedDataTimes getEncodedDataTimes() const {
+        EncodedDataTimes times = { _created, _lastEdited, _lastUpdated, _lastSimulated, _changedOnServer,
+                                   _simulatorIDChangedTime };
+        return times;
+    }
+
+    // appendEntityData() output when all properties are requested, shared by every client it is sent to
+    mutable QMutex _encodedDataCacheMutex;
+    mutable QByteArray _encodedDataCache;
+    mutable EncodedDataTimes _encodedDataCacheTimes = EncodedDataTimes();
 };
 
 #endif // hifi_EntityItem_h
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <AACube.h>
 
 #include "EntitySimulation.h"
@@ -17,11 +19,12 @@
 
 void EntitySimulation::setEntityTree(EntityTree* tree) {
     if (_entityTree && _entityTree != tree) {
-        _mortalEntities.clear();
-        _nextExpiry = quint64(-1);
+        clearExpiries();
         _entitiesToUpdate.clear();
         _entitiesToSort.clear();
         _simpleKinematicEntities.clear();
+        _movedEntities.clear();
+        _steppedEntities.clear();
     }
     _entityTree = tree;
 }
@@ -46,6 +49,30 @@ void EntitySimulation::getEntitiesToDelete(VectorOfEntities& entitiesToDelete) {
     _entitiesToDelete.clear();
 }
 
+void EntitySimulation::setWantMovedEntities(bool wantMovedEntities) {
+    _wantMovedEntities = wantMovedEntities;
+    if (!_wantMovedEntities) {
+        _movedEntities.clear();
+    }
+}
+
+void EntitySimulation::takeMovedEntities(SetOfEntities& movedEntities) {
+    movedEntities.swap(_movedEntities);
+    _movedEntities.clear();
+}
+
+void EntitySimulation::setWantSteppedEntities(bool wantSteppedEntities) {
+    _wantSteppedEntities = wantSteppedEntities;
+    if (!_wantSteppedEntities) {
+        _steppedEntities.clear();
+    }
+}
+
+void EntitySimulation::takeSteppedEntities(SetOfEntities& steppedEntities) {
+    steppedEntities.swap(_steppedEntities);
+    _steppedEntities.clear();
+}
+
 void EntitySimulation::addEntityInternal(EntityItemPointer entity) {
     if (entity->isMoving() && !entity->getPhysicsInfo()) {
         _simpleKinematicEntities.insert(entity);
@@ -62,34 +89,65 @@ void EntitySimulation::changeEntityInternal(EntityItemPointer entity) {
 
 // protected
 void EntitySimulation::expireMortalEntities(const quint64& now) {
-    if (now > _nextExpiry) {
-        // only search for expired entities if we expect to find one
-        _nextExpiry = quint64(-1);
-        SetOfEntities::iterator itemItr = _mortalEntities.begin();
-        while (itemItr != _mortalEntities.end()) {
-            EntityItemPointer entity = *itemItr;
-            quint64 expiry = entity->getExpiry();
-            if (expiry < now) {
-                _entitiesToDelete.insert(entity);
-                itemItr = _mortalEntities.erase(itemItr);
-                _entitiesToUpdate.remove(entity);
-                _entitiesToSort.remove(entity);
-                _simpleKinematicEntities.remove(entity);
-                removeEntityInternal(entity);
-
-                _allEntities.remove(entity);
-                entity->_simulated = false;
-            } else {
-                if (expiry < _nextExpiry) {
-                    // remeber the smallest _nextExpiry so we know when to start the next search
-                    _nextExpiry = expiry;
-                }
-                ++itemItr;
-            }
+    // the queue is ordered by expiry, so only the entities that are actually expiring get looked at
+    while (!_expiryQueue.empty() && _expiryQueue.front().expiry < now) {
+        std::pop_heap(_expiryQueue.begin(), _expiryQueue.end(), EntityExpiry::isLater);
+        EntityExpiry next = _expiryQueue.back();
+        _expiryQueue.pop_back();
+
+        EntityItemPointer entity = next.entity.lock();
+        if (!entity) {
+            continue; // the entity was deleted since this entry was queued
+        }
+        QHash<EntityItemPointer, quint64>::iterator mortalItr = _mortalEntities.find(entity);
+        if (mortalItr == _mortalEntities.end() || mortalItr.value() != next.expiry) {
+            // the entity was removed, made immortal or rescheduled since this entry was queued
+            continue;
         }
+        if (entity->getExpiry() >= now) {
+            // the expiry moved without a DIRTY_LIFETIME change, go by the new one
+            scheduleExpiry(entity);
+            continue;
+        }
+
+        _entitiesToDelete.insert(entity);
+        _mortalEntities.erase(mortalItr);
+        _entitiesToUpdate.remove(entity);
+        _entitiesToSort.remove(entity);
+        _simpleKinematicEntities.remove(entity);
+        removeEntityInternal(entity);
+
+        _allEntities.remove(entity);
+        entity->_simulated = false;
     }
 }
 
+// protected
+void EntitySimulation::scheduleExpiry(EntityItemPointer entity) {
+    quint64 expiry = entity->getExpiry();
+    _mortalEntities.insert(entity, expiry);
+    _expiryQueue.push_back(EntityExpiry(expiry, entity));
+    std::push_heap(_expiryQueue.begin(), _expiryQueue.end(), EntityExpiry::isLater);
+
+    // stale entries are dropped lazily as they come to the front, but entities that keep having their lifetime
+    // changed could pile them up, so rebuild the queue from the live entries when they are outnumbered
+    const size_t MIN_QUEUE_SIZE_TO_COMPACT = 64;
+    if (_expiryQueue.size() > MIN_QUEUE_SIZE_TO_COMPACT && _expiryQueue.size() > 2 * (size_t)_mortalEntities.size()) {
+        _expiryQueue.clear();
+        for (QHash<EntityItemPointer, quint64>::const_iterator itr = _mortalEntities.constBegin();
+                itr != _mortalEntities.constEnd(); ++itr) {
+            _expiryQueue.push_back(EntityExpiry(itr.value(), itr.key()));
+        }
+        std::make_heap(_expiryQueue.begin(), _expiryQueue.end(), EntityExpiry::isLater);
+    }
+}
+
+// protected
+void EntitySimulation::clearExpiries() {
+    _mortalEntities.clear();
+    _expiryQueue.clear();
+}
+
 // protected
 void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
     PerformanceTimer perfTimer("updatingEntities");
@@ -102,6 +160,7 @@ void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
             itemItr = _entitiesToUpdate.erase(itemItr);
         } else {
             entity->update(now);
+            noteSteppedEntity(entity);
             ++itemItr;
         }
     }
@@ -147,11 +206,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
 void EntitySimulation::addEntity(EntityItemPointer entity) {
     assert(entity);
     if (entity->isMortal()) {
-        _mortalEntities.insert(entity);
-        quint64 expiry = entity->getExpiry();
-        if (expiry < _nextExpiry) {
-            _nextExpiry = expiry;
-        }
+        scheduleExpiry(entity);
     }
     if (entity->needsToCallUpdate()) {
         _entitiesToUpdate.insert(entity);
@@ -173,6 +228,8 @@ void EntitySimulation::removeEntity(EntityItemPointer entity) {
     _entitiesToSort.remove(entity);
     _simpleKinematicEntities.remove(entity);
     _entitiesToDelete.remove(entity);
+    _movedEntities.remove(entity);
+    _steppedEntities.remove(entity);
     removeEntityInternal(entity);
 
     _allEntities.remove(entity);
@@ -211,11 +268,7 @@ void EntitySimulation::changeEntity(EntityItemPointer entity) {
     if (!wasRemoved) {
         if (dirtyFlags & EntityItem::DIRTY_LIFETIME) {
             if (entity->isMortal()) {
-                _mortalEntities.insert(entity);
-                quint64 expiry = entity->getExpiry();
-                if (expiry < _nextExpiry) {
-                    _nextExpiry = expiry;
-                }
+                scheduleExpiry(entity);
             } else {
                 _mortalEntities.remove(entity);
             }
@@ -227,16 +280,18 @@ void EntitySimulation::changeEntity(EntityItemPointer entity) {
             _entitiesToUpdate.remove(entity);
         }
         changeEntityInternal(entity);
+        noteMovedEntity(entity);
     }
 }
 
 void EntitySimulation::clearEntities() {
-    _mortalEntities.clear();
-    _nextExpiry = quint64(-1);
+    clearExpiries();
     _entitiesToUpdate.clear();
     _entitiesToSort.clear();
     _simpleKinematicEntities.clear();
     _entitiesToDelete.clear();
+    _movedEntities.clear();
+    _steppedEntities.clear();
 
     clearEntitiesInternal();
 
@@ -247,16 +302,47 @@ void EntitySimulation::clearEntities() {
 }
 
 void EntitySimulation::moveSimpleKinematics(const quint64& now) {
-    SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
-    while (itemItr != _simpleKinematicEntities.end()) {
+    PerformanceTimer perfTimer("moveSimpleKinematics");
+
+    // entities moving in a straight line are stepped all together, and only those that left their element are sorted
+    _simpleKinematicEntities.integrate(now);
+    for (int row = _simpleKinematicEntities.getNumRows() - 1; row >= 0; row--) {
+        EntityItemPointer entity = _simpleKinematicEntities.getEntity(row);
+        if (entity->getPhysicsInfo()) {
+            // the entity is no longer non-physical-kinematic
+            _simpleKinematicEntities.removeRow(row);
+            continue;
+        }
+        entity->_lastSimulated = now;
+        if (_simpleKinematicEntities.hasStopped(row)) {
+            entity->setVelocity(ENTITY_ITEM_ZERO_VEC3);
+            entity->_dirtyFlags |= EntityItem::DIRTY_MOTION_TYPE;
+            _simpleKinematicEntities.removeRow(row);
+            noteMovedEntity(entity);
+            noteSteppedEntity(entity);
+            continue;
+        }
+        entity->setPosition(_simpleKinematicEntities.getPosition(row));
+        entity->setVelocity(_simpleKinematicEntities.getVelocity(row));
+        noteSteppedEntity(entity);
+        if (_simpleKinematicEntities.hasLeftElement(row)) {
+            _entitiesToSort.insert(entity);
+        }
+    }
+
+    SetOfEntities& rotatingEntities = _simpleKinematicEntities.getRotatingEntities();
+    SetOfEntities::iterator itemItr = rotatingEntities.begin();
+    while (itemItr != rotatingEntities.end()) {
         EntityItemPointer entity = *itemItr;
         if (entity->isMoving() && !entity->getPhysicsInfo()) {
             entity->simulate(now);
             _entitiesToSort.insert(entity);
+            noteSteppedEntity(entity);
             ++itemItr;
         } else {
             // the entity is no longer non-physical-kinematic
-            itemItr = _simpleKinematicEntities.erase(itemItr);
+            noteMovedEntity(entity);
+            itemItr = rotatingEntities.erase(itemItr);
         }
     }
 }
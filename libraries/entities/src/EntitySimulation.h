@@ -12,7 +12,11 @@
 #ifndef hifi_EntitySimulation_h
 #define hifi_EntitySimulation_h
 
+#include <memory>
+#include <vector>
+
 #include <QtCore/QObject>
+#include <QHash>
 #include <QSet>
 #include <QVector>
 
@@ -21,6 +25,7 @@
 #include "EntityActionInterface.h"
 #include "EntityItem.h"
 #include "EntityTree.h"
+#include "KinematicStateTable.h"
 
 typedef QSet<EntityItemPointer> SetOfEntities;
 typedef QVector<EntityItemPointer> VectorOfEntities;
@@ -41,10 +46,23 @@ const int DIRTY_SIMULATION_FLAGS =
         EntityItem::DIRTY_MATERIAL |
         EntityItem::DIRTY_SIMULATOR_ID;
 
+// an entry of the expiry queue, it is stale if the entity is gone or no longer scheduled to expire at this time.
+// It doesn't keep the entity alive, so that stale entries don't hold on to deleted entities until they are dropped
+class EntityExpiry {
+public:
+    EntityExpiry(quint64 expiry, EntityItemPointer entity) : expiry(expiry), entity(entity) { }
+
+    // the ordering that makes the std heap functions keep the earliest expiry at the front
+    static bool isLater(const EntityExpiry& a, const EntityExpiry& b) { return a.expiry > b.expiry; }
+
+    quint64 expiry;
+    std::weak_ptr<EntityItem> entity;
+};
+
 class EntitySimulation : public QObject {
 Q_OBJECT
 public:
-    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(NULL), _nextExpiry(quint64(-1)) { }
+    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(NULL) { }
     virtual ~EntitySimulation() { setEntityTree(NULL); }
 
     void lock() { _mutex.lock(); }
@@ -86,6 +104,16 @@ public:
 
     void getEntitiesToDelete(VectorOfEntities& entitiesToDelete);
 
+    /// When wanted, the entities that were changed or moved, or that stopped moving, are remembered until taken, so
+    /// that the renderer can re-place them in the scene
+    void setWantMovedEntities(bool wantMovedEntities);
+    void takeMovedEntities(SetOfEntities& movedEntities);
+
+    /// When wanted, the entities that the simulation itself moved or updated are remembered until taken, so that the
+    /// tree can journal them
+    void setWantSteppedEntities(bool wantSteppedEntities);
+    void takeSteppedEntities(SetOfEntities& steppedEntities);
+
 signals:
     void entityCollisionWithEntity(const EntityItemID& idA, const EntityItemID& idB, const Collision& collision);
 
@@ -100,8 +128,12 @@ protected:
     virtual void clearEntitiesInternal() = 0;
 
     void expireMortalEntities(const quint64& now);
+    void scheduleExpiry(EntityItemPointer entity);
+    void clearExpiries();
     void callUpdateOnEntitiesThatNeedIt(const quint64& now);
     void sortEntitiesThatMoved();
+    void noteMovedEntity(EntityItemPointer entity) { if (_wantMovedEntities) { _movedEntities.insert(entity); } }
+    void noteSteppedEntity(EntityItemPointer entity) { if (_wantSteppedEntities) { _steppedEntities.insert(entity); } }
 
     QMutex _mutex;
 
@@ -111,12 +143,16 @@ protected:
     // We maintain multiple lists, each for its distinct purpose.
     // An entity may be in more than one list.
     SetOfEntities _allEntities; // tracks all entities added the simulation
-    SetOfEntities _mortalEntities; // entities that have an expiry
-    quint64 _nextExpiry;
+    QHash<EntityItemPointer, quint64> _mortalEntities; // entities that have an expiry, and when they were scheduled to expire
+    std::vector<EntityExpiry> _expiryQueue; // min-heap of scheduled expiries, including stale ones
     SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
     SetOfEntities _entitiesToSort; // entities moved by simulation (and might need resort in EntityTree)
     SetOfEntities _entitiesToDelete; // entities simulation decided needed to be deleted (EntityTree will actually delete)
-    SetOfEntities _simpleKinematicEntities; // entities undergoing non-colliding kinematic motion
+    KinematicStateTable _simpleKinematicEntities; // entities undergoing non-colliding kinematic motion
+    SetOfEntities _movedEntities; // entities changed or moved since the last takeMovedEntities()
+    bool _wantMovedEntities = false;
+    SetOfEntities _steppedEntities; // entities moved or updated by the simulation since the last takeSteppedEntities()
+    bool _wantSteppedEntities = false;
 
  private:
     void moveSimpleKinematics();
@@ -11,6 +11,10 @@
 
 #include <PerfStat.h>
 #include <QDateTime>
+#include <QJsonDocument>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
 #include <QtScript/QScriptEngine>
 
 #include "EntityTree.h"
@@ -84,6 +88,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
         _simulation->unlock();
     }
     _isDirty = true;
+    noteJournalChange(entity->getEntityItemID());
     maybeNotifyNewCollisionSoundURL("", entity->getCollisionSoundURL());
     emit addingEntity(entity->getEntityItemID());
 }
@@ -145,6 +150,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
                 UpdateEntityOperator theOperator(this, containingElement, entity, tempProperties);
                 recurseTreeWithOperator(&theOperator);
                 _isDirty = true;
+                noteJournalChange(entity->getEntityItemID());
             }
         }
     } else {
@@ -190,6 +196,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
         UpdateEntityOperator theOperator(this, containingElement, entity, properties);
         recurseTreeWithOperator(&theOperator);
         _isDirty = true;
+        noteJournalChange(entity->getEntityItemID());
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -266,6 +273,71 @@ EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const Enti
     return result;
 }
 
+/// Decodes the entities of one SVO file chunk on a pool thread.
+class BitstreamChunkDecoder : public QRunnable {
+public:
+    BitstreamChunkDecoder(const EntityTree* tree, const BitstreamChunk& chunk,
+                          const ReadBitstreamToTreeParams& args, EntityItems& decodedEntities) :
+        _tree(tree), _chunk(chunk), _args(args), _decodedEntities(decodedEntities) { }
+
+    virtual void run() {
+        _tree->walkBitstream(_chunk.data, _chunk.length, _args,
+            [&](const unsigned char* data, int bytesLeftToRead, bool isRoot) {
+                return EntityTreeElement::decodeElementDataFromBuffer(data, bytesLeftToRead, isRoot, _args,
+                                                                      _decodedEntities);
+            });
+    }
+
+private:
+    const EntityTree* _tree;
+    BitstreamChunk _chunk;
+    ReadBitstreamToTreeParams _args;
+    EntityItems& _decodedEntities;
+};
+
+void EntityTree::readBitstreamChunksToTree(const QVector<BitstreamChunk>& chunks, ReadBitstreamToTreeParams& args) {
+    // Decoding the entities is most of the work of loading a persist file, and it doesn't need the tree, so the chunks
+    // are decoded side by side and only the placement of the decoded entities is left to this thread. This is only
+    // done for an empty tree, where every entity in the file is new.
+    if (chunks.size() < 2 || QThread::idealThreadCount() < 2 || !_entityToElementMap.isEmpty()) {
+        Octree::readBitstreamChunksToTree(chunks, args);
+        return;
+    }
+
+    QVector<EntityItems> decodedChunks(chunks.size());
+    EntityItems* decodedChunksData = decodedChunks.data();
+    QThreadPool decoderPool;
+    for (int i = 0; i < chunks.size(); i++) {
+        decoderPool.start(new BitstreamChunkDecoder(this, chunks.at(i), args, decodedChunksData[i]));
+    }
+    decoderPool.waitForDone();
+
+    // an entity saved more than once keeps its latest edit, like it does when the chunks are read one after another
+    QHash<EntityItemID, EntityItemPointer> latestEntities;
+    foreach (const EntityItems& decodedEntities, decodedChunks) {
+        foreach (EntityItemPointer entity, decodedEntities) {
+            EntityItemPointer& latestEntity = latestEntities[entity->getEntityItemID()];
+            if (!latestEntity || entity->getLastEdited() > latestEntity->getLastEdited()) {
+                latestEntity = entity;
+            }
+        }
+    }
+
+    for (int i = 0; i < decodedChunks.size(); i++) {
+        foreach (EntityItemPointer entity, decodedChunks.at(i)) {
+            if (latestEntities.value(entity->getEntityItemID()) != entity) {
+                continue;
+            }
+            AddEntityOperator theOperator(this, entity);
+            recurseTreeWithOperator(&theOperator);
+            postAddEntity(entity);
+        }
+        if (args.wantImportProgress) {
+            emit importProgress((100 * (i + 1)) / decodedChunks.size());
+        }
+    }
+}
+
 void EntityTree::emitEntityScriptChanging(const EntityItemID& entityItemID) {
     emit entityScriptChanging(entityItemID);
 }
@@ -288,6 +360,11 @@ void EntityTree::setSimulation(EntitySimulation* simulation) {
         _simulation->unlock();
     }
     _simulation = simulation;
+    if (_simulation) {
+        _simulation->lock();
+        _simulation->setWantSteppedEntities(_wantJournal);
+        _simulation->unlock();
+    }
 }
 
 void EntityTree::deleteEntity(const EntityItemID& entityID, bool force, bool ignoreWarnings) {
@@ -371,6 +448,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
     }
     foreach(const EntityToDeleteDetails& details, entities) {
         EntityItemPointer theEntity = details.entity;
+        noteJournalChange(theEntity->getEntityItemID());
 
         if (getIsServer()) {
             // set up the deleted entities ID
@@ -675,6 +753,14 @@ void EntityTree::update() {
         _simulation->updateEntities();
         VectorOfEntities pendingDeletes;
         _simulation->getEntitiesToDelete(pendingDeletes);
+        if (_wantJournal) {
+            // the simulation moves entities without edits, their new positions need journaling like edits do
+            SetOfEntities steppedEntities;
+            _simulation->takeSteppedEntities(steppedEntities);
+            foreach (EntityItemPointer entity, steppedEntities) {
+                noteJournalChange(entity->getEntityItemID());
+            }
+        }
         _simulation->unlock();
 
         if (pendingDeletes.size() > 0) {
@@ -1042,6 +1128,58 @@ bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElement* eleme
     return true;
 }
 
+bool EntityTree::writeToVariants(OctreeElement* element, bool skipDefaultValues,
+                                 std::function<void(const QVariantList& items)> writeItems) {
+    if (element && element != _rootElement) {
+        // part of the tree is described in one go
+        QVariantMap entityDescription;
+        writeToMap(entityDescription, element, skipDefaultValues);
+        writeItems(entityDescription["Entities"].toList());
+        return true;
+    }
+
+    // only the list of entities is taken up front, they are described a slice at a time so that a save doesn't hold
+    // off edits for its whole length
+    const int ENTITIES_PER_SLICE = 256;
+    QVector<EntityItemPointer> entities;
+    lockForRead();
+    entities.reserve(_entityToElementMap.size());
+    for (auto iterator = _entityToElementMap.constBegin(); iterator != _entityToElementMap.constEnd(); ++iterator) {
+        EntityItemPointer entity = iterator.value()->getEntityWithEntityItemID(iterator.key());
+        if (entity) {
+            entities.append(entity);
+        }
+    }
+    unlock();
+
+    QScriptEngine scriptEngine;
+    QVector<EntityItemProperties> sliceProperties;
+    QVariantList items;
+    for (int sliceStart = 0; sliceStart < entities.size(); sliceStart += ENTITIES_PER_SLICE) {
+        int sliceEnd = std::min(sliceStart + ENTITIES_PER_SLICE, entities.size());
+        sliceProperties.clear();
+        lockForRead();
+        for (int i = sliceStart; i < sliceEnd; i++) {
+            // skip the entities deleted since we listed them
+            if (getContainingElement(entities[i]->getEntityItemID())) {
+                sliceProperties.append(entities[i]->getProperties());
+            }
+        }
+        unlock();
+
+        items.clear();
+        foreach (const EntityItemProperties& properties, sliceProperties) {
+            QScriptValue entityScriptValue = skipDefaultValues ?
+                EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, properties) :
+                EntityItemPropertiesToScriptValue(&scriptEngine, properties);
+            items << entityScriptValue.toVariant();
+        }
+        writeItems(items);
+        scriptEngine.collectGarbage();
+    }
+    return true;
+}
+
 bool EntityTree::readFromMap(QVariantMap& map) {
     // map will have a top-level list keyed as "Entities".  This will be extracted
     // and iterated over.  Each member of this list is converted to a QVariantMap, then
@@ -1072,3 +1210,73 @@ bool EntityTree::readFromMap(QVariantMap& map) {
 
     return true;
 }
+
+void EntityTree::setWantJournal(bool wantJournal) {
+    _wantJournal = wantJournal;
+    if (!wantJournal) {
+        _unjournaledEntityIDs.clear();
+    }
+    if (_simulation) {
+        _simulation->lock();
+        _simulation->setWantSteppedEntities(wantJournal);
+        _simulation->unlock();
+    }
+}
+
+void EntityTree::writeJournal(OctreeJournal& journal) {
+    if (_unjournaledEntityIDs.isEmpty()) {
+        return;
+    }
+
+    // an entity edited many times since the last write costs one record, holding all of its properties so that
+    // replaying it doesn't depend on anything recorded before
+    QScriptEngine scriptEngine;
+    foreach (const EntityItemID& entityID, _unjournaledEntityIDs) {
+        EntityItemPointer entity = findEntityByEntityItemID(entityID);
+        if (entity) {
+            QScriptValue entityScriptValue = EntityItemPropertiesToScriptValue(&scriptEngine, entity->getProperties());
+            QByteArray entityJSON = QJsonDocument::fromVariant(entityScriptValue.toVariant()).toJson(QJsonDocument::Compact);
+            journal.append(OctreeJournal::RECORD_CHANGED, entityID, entityJSON);
+        } else {
+            journal.append(OctreeJournal::RECORD_DELETED, entityID);
+        }
+    }
+    _unjournaledEntityIDs.clear();
+}
+
+void EntityTree::readJournal(const QVector<OctreeJournal::Record>& records) {
+    // only the latest record of each entity matters
+    QHash<QUuid, int> latestRecords;
+    for (int i = 0; i < records.size(); i++) {
+        latestRecords.insert(records[i].id, i);
+    }
+
+    QScriptEngine scriptEngine;
+    for (int i = 0; i < records.size(); i++) {
+        const OctreeJournal::Record& record = records[i];
+        if (latestRecords.value(record.id) != i) {
+            continue;
+        }
+
+        EntityItemID entityItemID(record.id);
+        if (record.type == OctreeJournal::RECORD_DELETED) {
+            deleteEntity(entityItemID, true, true);
+            continue;
+        }
+
+        QVariantMap entityMap = QJsonDocument::fromJson(record.data).toVariant().toMap();
+        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+        EntityItemProperties properties;
+        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+        EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
+        if (existingEntity) {
+            // the record is the whole entity, so it applies regardless of locks or simulation ownership
+            UpdateEntityOperator theOperator(this, getContainingElement(entityItemID), existingEntity, properties);
+            recurseTreeWithOperator(&theOperator);
+            _isDirty = true;
+        } else if (!addEntity(entityItemID, properties)) {
+            qCDebug(entities) << "adding journaled Entity failed:" << entityItemID << properties.getType();
+        }
+    }
+}
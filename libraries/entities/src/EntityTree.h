@@ -164,8 +164,17 @@ public:
     void setWantEditLogging(bool value) { _wantEditLogging = value; }
 
     bool writeToMap(QVariantMap& entityDescription, OctreeElement* element, bool skipDefaultValues);
+    bool writeToVariants(OctreeElement* element, bool skipDefaultValues,
+                         std::function<void(const QVariantList& items)> writeItems);
     bool readFromMap(QVariantMap& entityDescription);
 
+    virtual void readBitstreamChunksToTree(const QVector<BitstreamChunk>& chunks, ReadBitstreamToTreeParams& args);
+
+    virtual bool canJournal() const { return true; }
+    virtual void setWantJournal(bool wantJournal);
+    virtual void writeJournal(OctreeJournal& journal);
+    virtual void readJournal(const QVector<OctreeJournal::Record>& records);
+
     float getContentsLargestDimension();
 
 signals:
@@ -201,6 +210,13 @@ private:
     EntitySimulation* _simulation;
 
     bool _wantEditLogging = false;
+
+    // entities added, edited, deleted or moved by the simulation since the last writeJournal(), guarded by the tree lock
+    // like the entities are
+    void noteJournalChange(const EntityItemID& entityID) { if (_wantJournal) { _unjournaledEntityIDs.insert(entityID); } }
+    bool _wantJournal = false;
+    QSet<EntityItemID> _unjournaledEntityIDs;
+
     void maybeNotifyNewCollisionSoundURL(const QString& oldCollisionSoundURL, const QString& newCollisionSoundURL);
 };
 
@@ -780,6 +780,43 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
     return bytesRead;
 }
 
+int EntityTreeElement::decodeElementDataFromBuffer(const unsigned char* data, int bytesLeftToRead, bool isRoot,
+                                                   ReadBitstreamToTreeParams& args, EntityItems& decodedEntities) {
+    // this is the new entity half of readElementDataFromBuffer()
+    if (isRoot && args.bitstreamVersion < VERSION_ROOT_ELEMENT_HAS_DATA) {
+        return 0;
+    }
+
+    const unsigned char* dataAt = data;
+    int bytesRead = 0;
+    uint16_t numberOfEntities = 0;
+    int expectedBytesPerEntity = EntityItem::expectedBytes();
+
+    if (bytesLeftToRead >= (int)sizeof(numberOfEntities)) {
+        numberOfEntities = *(uint16_t*)dataAt;
+
+        dataAt += sizeof(numberOfEntities);
+        bytesLeftToRead -= (int)sizeof(numberOfEntities);
+        bytesRead += sizeof(numberOfEntities);
+
+        if (bytesLeftToRead >= (int)(numberOfEntities * expectedBytesPerEntity)) {
+            for (uint16_t i = 0; i < numberOfEntities; i++) {
+                int bytesForThisEntity = 0;
+                EntityItemPointer entityItem = EntityTypes::constructEntityItem(dataAt, bytesLeftToRead, args);
+                if (entityItem) {
+                    bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
+                    decodedEntities.push_back(entityItem);
+                }
+                dataAt += bytesForThisEntity;
+                bytesLeftToRead -= bytesForThisEntity;
+                bytesRead += bytesForThisEntity;
+            }
+        }
+    }
+
+    return bytesRead;
+}
+
 void EntityTreeElement::addEntityItem(EntityItemPointer entity) {
     assert(entity);
     assert(entity->_element == NULL);
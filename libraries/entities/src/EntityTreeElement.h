@@ -131,6 +131,11 @@ public:
     /// from the network.
     virtual int readElementDataFromBuffer(const unsigned char* data, int bytesLeftToRead, ReadBitstreamToTreeParams& args);
 
+    /// Decodes the entities in the data of an element into new items without looking at or changing any tree, so it
+    /// is safe to call from any thread. Returns the bytes read, the same as readElementDataFromBuffer() would.
+    static int decodeElementDataFromBuffer(const unsigned char* data, int bytesLeftToRead, bool isRoot,
+                                           ReadBitstreamToTreeParams& args, EntityItems& decodedEntities);
+
     /// Override to indicate that the item is currently rendered in the rendering engine. By default we assume that if
     /// the element should be rendered, then your rendering engine is rendering. But some rendering engines my have cases
     /// where an element is not actually rendering all should render elements. If the isRendered() state doesn't match the
@@ -0,0 +1,262 @@
+//
+//  KinematicStateTable.cpp
+//  libraries/entities/src
+//
+//  Created on 2015-06-15.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cmath>
+
+#include <SharedUtil.h>
+
+#include "EntityItem.h"
+#include "EntityTreeElement.h"
+#include "KinematicStateTable.h"
+
+// the speed below which EntityItem::simulateKinematicMotion() brings an entity to rest
+const float EPSILON_LINEAR_VELOCITY_LENGTH = 0.001f; // 1mm/sec
+
+void KinematicStateTable::insert(EntityItemPointer entity) {
+    if (entity->hasAngularVelocity()) {
+        remove(entity);
+        _rotatingEntities.insert(entity);
+        return;
+    }
+    _rotatingEntities.remove(entity);
+
+    QHash<EntityItemPointer, int>::const_iterator rowItr = _rows.constFind(entity);
+    if (rowItr != _rows.constEnd()) {
+        loadRow(rowItr.value(), entity);
+        return;
+    }
+
+    int row = (int)_entities.size();
+    _rows.insert(entity, row);
+    _entities.push_back(entity);
+    _elements.push_back(NULL);
+    _lastSimulated.push_back(0);
+    _timeElapsed.push_back(0.0f);
+    _damping.push_back(0.0f);
+    _dampingFactor.push_back(1.0f);
+    _positionX.push_back(0.0f);
+    _positionY.push_back(0.0f);
+    _positionZ.push_back(0.0f);
+    _velocityX.push_back(0.0f);
+    _velocityY.push_back(0.0f);
+    _velocityZ.push_back(0.0f);
+    _accelerationX.push_back(0.0f);
+    _accelerationY.push_back(0.0f);
+    _accelerationZ.push_back(0.0f);
+    _radius.push_back(0.0f);
+    _elementMinX.push_back(0.0f);
+    _elementMinY.push_back(0.0f);
+    _elementMinZ.push_back(0.0f);
+    _elementScale.push_back(0.0f);
+    _stopped.push_back(0);
+    _leftElement.push_back(1);
+    loadRow(row, entity);
+}
+
+void KinematicStateTable::remove(EntityItemPointer entity) {
+    _rotatingEntities.remove(entity);
+    QHash<EntityItemPointer, int>::const_iterator rowItr = _rows.constFind(entity);
+    if (rowItr != _rows.constEnd()) {
+        removeRow(rowItr.value());
+    }
+}
+
+void KinematicStateTable::clear() {
+    _rotatingEntities.clear();
+    while (!_entities.empty()) {
+        removeRow((int)_entities.size() - 1);
+    }
+}
+
+void KinematicStateTable::integrate(quint64 now) {
+    const int numRows = (int)_entities.size();
+    if (numRows == 0) {
+        return;
+    }
+
+    // a row that was never simulated starts now, like EntityItem::simulate() does
+    for (int i = 0; i < numRows; i++) {
+        quint64 lastSimulated = _lastSimulated[i] == 0 ? now : _lastSimulated[i];
+        _timeElapsed[i] = (float)(now - lastSimulated) / (float)(USECS_PER_SECOND);
+        _lastSimulated[i] = now;
+    }
+
+    // damping is the one step that isn't straight arithmetic, so it gets a loop of its own and the rest stay simple
+    for (int i = 0; i < numRows; i++) {
+        _dampingFactor[i] = _damping[i] > 0.0f ? powf(1.0f - _damping[i], _timeElapsed[i]) : 1.0f;
+    }
+
+    // the same steps as EntityItem::simulateKinematicMotion(): damp, move, then accelerate
+    float* positionX = _positionX.data();
+    float* positionY = _positionY.data();
+    float* positionZ = _positionZ.data();
+    float* velocityX = _velocityX.data();
+    float* velocityY = _velocityY.data();
+    float* velocityZ = _velocityZ.data();
+    const float* accelerationX = _accelerationX.data();
+    const float* accelerationY = _accelerationY.data();
+    const float* accelerationZ = _accelerationZ.data();
+    const float* timeElapsed = _timeElapsed.data();
+    const float* dampingFactor = _dampingFactor.data();
+    unsigned char* stopped = _stopped.data();
+    const float EPSILON_SPEED_SQUARED = EPSILON_LINEAR_VELOCITY_LENGTH * EPSILON_LINEAR_VELOCITY_LENGTH;
+    for (int i = 0; i < numRows; i++) {
+        float dt = timeElapsed[i];
+        float vx = velocityX[i] * dampingFactor[i];
+        float vy = velocityY[i] * dampingFactor[i];
+        float vz = velocityZ[i] * dampingFactor[i];
+        float px = positionX[i] + vx * dt;
+        float py = positionY[i] + vy * dt;
+        float pz = positionZ[i] + vz * dt;
+        vx += accelerationX[i] * dt;
+        vy += accelerationY[i] * dt;
+        vz += accelerationZ[i] * dt;
+
+        // an entity coming to rest keeps the position it had, as in simulateKinematicMotion()
+        unsigned char isStopped = (vx * vx + vy * vy + vz * vz) < EPSILON_SPEED_SQUARED;
+        stopped[i] = isStopped;
+        positionX[i] = isStopped ? positionX[i] : px;
+        positionY[i] = isStopped ? positionY[i] : py;
+        positionZ[i] = isStopped ? positionZ[i] : pz;
+        velocityX[i] = isStopped ? 0.0f : vx;
+        velocityY[i] = isStopped ? 0.0f : vy;
+        velocityZ[i] = isStopped ? 0.0f : vz;
+    }
+
+    // test the maximum cube of each entity against the cube of the element it was in, the same test as
+    // AACube::contains(const AACube&)
+    const float* radius = _radius.data();
+    const float* elementMinX = _elementMinX.data();
+    const float* elementMinY = _elementMinY.data();
+    const float* elementMinZ = _elementMinZ.data();
+    const float* elementScale = _elementScale.data();
+    unsigned char* leftElement = _leftElement.data();
+    for (int i = 0; i < numRows; i++) {
+        float minX = positionX[i] - radius[i] - elementMinX[i];
+        float minY = positionY[i] - radius[i] - elementMinY[i];
+        float minZ = positionZ[i] - radius[i] - elementMinZ[i];
+        float maxX = minX + 2.0f * radius[i];
+        float maxY = minY + 2.0f * radius[i];
+        float maxZ = minZ + 2.0f * radius[i];
+        leftElement[i] = (minX < 0.0f) | (minY < 0.0f) | (minZ < 0.0f)
+            | (maxX > elementScale[i]) | (maxY > elementScale[i]) | (maxZ > elementScale[i]);
+    }
+}
+
+bool KinematicStateTable::hasLeftElement(int row) {
+    // the entity may have been sorted into another element since its row was loaded. An element can also be deleted
+    // and another one allocated at the same address, so the cube cached for the row is compared as well
+    EntityTreeElement* element = _entities[row]->getElement();
+    if (element != _elements[row] || (element && !hasElementCube(row, element->getAACube()))) {
+        loadElementCube(row, element);
+        if (!element) {
+            return true;
+        }
+        AACube maximumCube(getPosition(row) - glm::vec3(_radius[row]), 2.0f * _radius[row]);
+        _leftElement[row] = !element->getAACube().contains(maximumCube);
+    }
+    return _leftElement[row] != 0;
+}
+
+void KinematicStateTable::removeRow(int row) {
+    int lastRow = (int)_entities.size() - 1;
+    _rows.remove(_entities[row]);
+    if (row != lastRow) {
+        _rows[_entities[lastRow]] = row;
+        _entities[row] = _entities[lastRow];
+        _elements[row] = _elements[lastRow];
+        _lastSimulated[row] = _lastSimulated[lastRow];
+        _timeElapsed[row] = _timeElapsed[lastRow];
+        _damping[row] = _damping[lastRow];
+        _dampingFactor[row] = _dampingFactor[lastRow];
+        _positionX[row] = _positionX[lastRow];
+        _positionY[row] = _positionY[lastRow];
+        _positionZ[row] = _positionZ[lastRow];
+        _velocityX[row] = _velocityX[lastRow];
+        _velocityY[row] = _velocityY[lastRow];
+        _velocityZ[row] = _velocityZ[lastRow];
+        _accelerationX[row] = _accelerationX[lastRow];
+        _accelerationY[row] = _accelerationY[lastRow];
+        _accelerationZ[row] = _accelerationZ[lastRow];
+        _radius[row] = _radius[lastRow];
+        _elementMinX[row] = _elementMinX[lastRow];
+        _elementMinY[row] = _elementMinY[lastRow];
+        _elementMinZ[row] = _elementMinZ[lastRow];
+        _elementScale[row] = _elementScale[lastRow];
+        _stopped[row] = _stopped[lastRow];
+        _leftElement[row] = _leftElement[lastRow];
+    }
+    _entities.pop_back();
+    _elements.pop_back();
+    _lastSimulated.pop_back();
+    _timeElapsed.pop_back();
+    _damping.pop_back();
+    _dampingFactor.pop_back();
+    _positionX.pop_back();
+    _positionY.pop_back();
+    _positionZ.pop_back();
+    _velocityX.pop_back();
+    _velocityY.pop_back();
+    _velocityZ.pop_back();
+    _accelerationX.pop_back();
+    _accelerationY.pop_back();
+    _accelerationZ.pop_back();
+    _radius.pop_back();
+    _elementMinX.pop_back();
+    _elementMinY.pop_back();
+    _elementMinZ.pop_back();
+    _elementScale.pop_back();
+    _stopped.pop_back();
+    _leftElement.pop_back();
+}
+
+void KinematicStateTable::loadRow(int row, const EntityItemPointer& entity) {
+    glm::vec3 position = entity->getPosition();
+    glm::vec3 velocity = entity->getVelocity();
+    glm::vec3 acceleration = entity->getAcceleration();
+    _lastSimulated[row] = entity->getLastSimulated();
+    _damping[row] = entity->getDamping();
+    _positionX[row] = position.x;
+    _positionY[row] = position.y;
+    _positionZ[row] = position.z;
+    _velocityX[row] = velocity.x;
+    _velocityY[row] = velocity.y;
+    _velocityZ[row] = velocity.z;
+    _accelerationX[row] = acceleration.x;
+    _accelerationY[row] = acceleration.y;
+    _accelerationZ[row] = acceleration.z;
+    _radius[row] = entity->getMaximumAACube().getScale() * 0.5f;
+    _stopped[row] = 0;
+    _leftElement[row] = 1;
+    loadElementCube(row, entity->getElement());
+}
+
+bool KinematicStateTable::hasElementCube(int row, const AACube& cube) const {
+    return _elementMinX[row] == cube.getCorner().x && _elementMinY[row] == cube.getCorner().y
+        && _elementMinZ[row] == cube.getCorner().z && _elementScale[row] == cube.getScale();
+}
+
+void KinematicStateTable::loadElementCube(int row, EntityTreeElement* element) {
+    _elements[row] = element;
+    if (element) {
+        const AACube& cube = element->getAACube();
+        _elementMinX[row] = cube.getCorner().x;
+        _elementMinY[row] = cube.getCorner().y;
+        _elementMinZ[row] = cube.getCorner().z;
+        _elementScale[row] = cube.getScale();
+    } else {
+        // a cube nothing fits in, so that an entity without an element is always sorted
+        _elementMinX[row] = 0.0f;
+        _elementMinY[row] = 0.0f;
+        _elementMinZ[row] = 0.0f;
+        _elementScale[row] = -1.0f;
+    }
+}
@@ -0,0 +1,88 @@
+//
+//  KinematicStateTable.h
+//  libraries/entities/src
+//
+//  Created on 2015-06-15.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Linear motion state of the simple kinematic entities, laid out for integrating them all in one pass
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_KinematicStateTable_h
+#define hifi_KinematicStateTable_h
+
+#include <vector>
+
+#include <QHash>
+#include <QSet>
+
+#include <glm/glm.hpp>
+
+#include "EntityTypes.h"
+
+class AACube;
+class EntityTreeElement;
+
+/// Holds the entities that the EntitySimulation moves itself, without physics. Entities that only move in a straight
+/// line get a row of a structure of arrays, so that integrate() steps them all in a few tight loops over contiguous
+/// floats that the compiler can vectorize, instead of calling EntityItem::simulate() on each. Entities that also
+/// rotate are kept aside and simulated one at a time as before.
+///
+/// It has the insert()/remove() of the set it replaces: inserting an entity that is already in the table reloads its
+/// row, which is how external changes to the entity reach it.
+class KinematicStateTable {
+public:
+    void insert(EntityItemPointer entity);
+    void remove(EntityItemPointer entity);
+    void clear();
+
+    bool contains(EntityItemPointer entity) const { return _rows.contains(entity) || _rotatingEntities.contains(entity); }
+
+    /// the entities with angular velocity, which integrate() leaves alone
+    QSet<EntityItemPointer>& getRotatingEntities() { return _rotatingEntities; }
+
+    /// steps the linear motion of every row to now
+    void integrate(quint64 now);
+
+    int getNumRows() const { return (int)_entities.size(); }
+    const EntityItemPointer& getEntity(int row) const { return _entities[row]; }
+    glm::vec3 getPosition(int row) const { return glm::vec3(_positionX[row], _positionY[row], _positionZ[row]); }
+    glm::vec3 getVelocity(int row) const { return glm::vec3(_velocityX[row], _velocityY[row], _velocityZ[row]); }
+
+    /// whether the last integrate() slowed the row below the speed at which an entity is considered at rest
+    bool hasStopped(int row) const { return _stopped[row] != 0; }
+
+    /// whether the maximum cube of the entity left the cube of its containing element in the last integrate(), so
+    /// that it has to be sorted into the tree again
+    bool hasLeftElement(int row);
+
+    /// removes a row, the last row takes its place
+    void removeRow(int row);
+
+private:
+    void loadRow(int row, const EntityItemPointer& entity);
+    void loadElementCube(int row, EntityTreeElement* element);
+    bool hasElementCube(int row, const AACube& cube) const;
+
+    QHash<EntityItemPointer, int> _rows;
+    QSet<EntityItemPointer> _rotatingEntities;
+
+    std::vector<EntityItemPointer> _entities;
+    std::vector<EntityTreeElement*> _elements;
+    std::vector<quint64> _lastSimulated;
+    std::vector<float> _timeElapsed;
+    std::vector<float> _damping;
+    std::vector<float> _dampingFactor;
+    std::vector<float> _positionX, _positionY, _positionZ;
+    std::vector<float> _velocityX, _velocityY, _velocityZ;
+    std::vector<float> _accelerationX, _accelerationY, _accelerationZ;
+    std::vector<float> _radius; // of the sphere the entity can sweep by rotating about its registration point
+    std::vector<float> _elementMinX, _elementMinY, _elementMinZ, _elementScale;
+    std::vector<unsigned char> _stopped;
+    std::vector<unsigned char> _leftElement;
+};
+
+#endif // hifi_KinematicStateTable_h
@@ -0,0 +1,644 @@
+//
+//  FBXGeometryCache.cpp
+//  libraries/fbx/src
+//
+//  Created on 2015-06-19.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstring>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+
+#include "FBXGeometryCache.h"
+#include "ModelFormatLogging.h"
+
+const char FBX_GEOMETRY_MAGIC[] = { 'H', 'F', 'G', 'C' };
+
+// bump this whenever FBXGeometry or the way it is extracted changes, so that older entries are missed rather than misread
+const quint32 FBX_GEOMETRY_CACHE_VERSION = 1;
+
+// written in the byte order of the machine, entries from a machine of the other order are ignored
+const quint32 FBX_GEOMETRY_BYTE_ORDER_MARK = 0x01020304;
+
+const int ARRAY_ALIGNMENT = 16;
+const QString CACHE_FILE_SUFFIX = ".fbxgeometry";
+const qint64 DEFAULT_MAXIMUM_CACHE_SIZE = 1024 * 1024 * 1024;
+
+QMutex FBXGeometryCache::_mutex;
+QString FBXGeometryCache::_directory;
+qint64 FBXGeometryCache::_maximumSize = DEFAULT_MAXIMUM_CACHE_SIZE;
+
+static int getPadding(qint64 position) {
+    return (ARRAY_ALIGNMENT - position % ARRAY_ALIGNMENT) % ARRAY_ALIGNMENT;
+}
+
+class FBXGeometryWriter {
+public:
+
+    template<class T> void writeValue(const T& value) {
+        _data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void writeBool(bool value) { writeValue<quint8>(value ? 1 : 0); }
+    void writeBytes(const QByteArray& bytes) { writeValue<quint32>(bytes.size()); _data.append(bytes); }
+    void writeString(const QString& string) { writeBytes(string.toUtf8()); }
+
+    template<class T> void writeArray(const QVector<T>& values) {
+        writeValue<quint32>(values.size());
+        _data.append(QByteArray(getPadding(_data.size()), 0));
+        _data.append(reinterpret_cast<const char*>(values.constData()), values.size() * sizeof(T));
+    }
+
+    void writeExtents(const Extents& extents);
+    void writeTexture(const FBXTexture& texture);
+    void writeJoint(const FBXJoint& joint);
+    void writeMesh(const FBXMesh& mesh);
+    void writeGeometry(const FBXGeometry& geometry);
+
+    const QByteArray& getData() const { return _data; }
+
+private:
+
+    QByteArray _data;
+};
+
+void FBXGeometryWriter::writeExtents(const Extents& extents) {
+    writeValue(extents.minimum);
+    writeValue(extents.maximum);
+}
+
+void FBXGeometryWriter::writeTexture(const FBXTexture& texture) {
+    writeString(texture.name);
+    writeBytes(texture.filename);
+    writeBytes(texture.content);
+    writeValue(texture.transform.getTranslation());
+    writeValue(texture.transform.getRotation());
+    writeValue(texture.transform.getScale());
+    writeValue<qint32>(texture.texcoordSet);
+    writeString(texture.texcoordSetName);
+}
+
+void FBXGeometryWriter::writeJoint(const FBXJoint& joint) {
+    writeBool(joint.isFree);
+    writeArray(joint.freeLineage);
+    writeValue<qint32>(joint.parentIndex);
+    writeValue(joint.distanceToParent);
+    writeValue(joint.boneRadius);
+    writeValue(joint.translation);
+    writeValue(joint.preTransform);
+    writeValue(joint.preRotation);
+    writeValue(joint.rotation);
+    writeValue(joint.postRotation);
+    writeValue(joint.postTransform);
+    writeValue(joint.transform);
+    writeValue(joint.rotationMin);
+    writeValue(joint.rotationMax);
+    writeValue(joint.inverseDefaultRotation);
+    writeValue(joint.inverseBindRotation);
+    writeValue(joint.bindTransform);
+    writeString(joint.name);
+    writeValue(joint.shapePosition);
+    writeValue(joint.shapeRotation);
+    writeValue(joint.shapeType);
+    writeBool(joint.isSkeletonJoint);
+}
+
+void FBXGeometryWriter::writeMesh(const FBXMesh& mesh) {
+    writeValue<quint32>(mesh.parts.size());
+    foreach (const FBXMeshPart& part, mesh.parts) {
+        writeArray(part.quadIndices);
+        writeArray(part.triangleIndices);
+        writeValue(part.diffuseColor);
+        writeValue(part.specularColor);
+        writeValue(part.emissiveColor);
+        writeValue(part.emissiveParams);
+        writeValue(part.shininess);
+        writeValue(part.opacity);
+        writeTexture(part.diffuseTexture);
+        writeTexture(part.normalTexture);
+        writeTexture(part.specularTexture);
+        writeTexture(part.emissiveTexture);
+        writeString(part.materialID);
+        writeBool(part._material != nullptr);
+    }
+
+    writeArray(mesh.vertices);
+    writeArray(mesh.normals);
+    writeArray(mesh.tangents);
+    writeArray(mesh.colors);
+    writeArray(mesh.texCoords);
+    writeArray(mesh.texCoords1);
+    writeArray(mesh.clusterIndices);
+    writeArray(mesh.clusterWeights);
+
+    writeValue<quint32>(mesh.clusters.size());
+    foreach (const FBXCluster& cluster, mesh.clusters) {
+        writeValue<qint32>(cluster.jointIndex);
+        writeValue(cluster.inverseBindMatrix);
+    }
+
+    writeExtents(mesh.meshExtents);
+    writeValue(mesh.modelTransform);
+    writeBool(mesh.isEye);
+
+    writeValue<quint32>(mesh.blendshapes.size());
+    foreach (const FBXBlendshape& blendshape, mesh.blendshapes) {
+        writeArray(blendshape.indices);
+        writeArray(blendshape.vertices);
+        writeArray(blendshape.normals);
+    }
+    writeValue<quint32>(mesh.meshIndex);
+}
+
+void FBXGeometryWriter::writeGeometry(const FBXGeometry& geometry) {
+    _data.append(FBX_GEOMETRY_MAGIC, sizeof(FBX_GEOMETRY_MAGIC));
+    writeValue(FBX_GEOMETRY_CACHE_VERSION);
+    writeValue(FBX_GEOMETRY_BYTE_ORDER_MARK);
+
+    writeString(geometry.author);
+    writeString(geometry.applicationName);
+
+    writeValue<quint32>(geometry.joints.size());
+    foreach (const FBXJoint& joint, geometry.joints) {
+        writeJoint(joint);
+    }
+    writeValue<quint32>(geometry.jointIndices.size());
+    for (QHash<QString, int>::const_iterator it = geometry.jointIndices.constBegin();
+            it != geometry.jointIndices.constEnd(); it++) {
+        writeString(it.key());
+        writeValue<qint32>(it.value());
+    }
+    writeBool(geometry.hasSkeletonJoints);
+
+    writeValue<quint32>(geometry.meshes.size());
+    foreach (const FBXMesh& mesh, geometry.meshes) {
+        writeMesh(mesh);
+    }
+
+    writeValue(geometry.offset);
+    writeValue<qint32>(geometry.leftEyeJointIndex);
+    writeValue<qint32>(geometry.rightEyeJointIndex);
+    writeValue<qint32>(geometry.neckJointIndex);
+    writeValue<qint32>(geometry.rootJointIndex);
+    writeValue<qint32>(geometry.leanJointIndex);
+    writeValue<qint32>(geometry.headJointIndex);
+    writeValue<qint32>(geometry.leftHandJointIndex);
+    writeValue<qint32>(geometry.rightHandJointIndex);
+    writeValue<qint32>(geometry.leftToeJointIndex);
+    writeValue<qint32>(geometry.rightToeJointIndex);
+    writeArray(geometry.humanIKJointIndices);
+    writeValue(geometry.palmDirection);
+
+    writeValue<quint32>(geometry.sittingPoints.size());
+    foreach (const SittingPoint& sittingPoint, geometry.sittingPoints) {
+        writeString(sittingPoint.name);
+        writeValue(sittingPoint.position);
+        writeValue(sittingPoint.rotation);
+    }
+
+    writeValue(geometry.neckPivot);
+    writeExtents(geometry.bindExtents);
+    writeExtents(geometry.meshExtents);
+
+    writeValue<quint32>(geometry.animationFrames.size());
+    foreach (const FBXAnimationFrame& frame, geometry.animationFrames) {
+        writeArray(frame.rotations);
+    }
+
+    writeValue<quint32>(geometry.meshIndicesToModelNames.size());
+    for (QHash<int, QString>::const_iterator it = geometry.meshIndicesToModelNames.constBegin();
+            it != geometry.meshIndicesToModelNames.constEnd(); it++) {
+        writeValue<qint32>(it.key());
+        writeString(it.value());
+    }
+
+    writeValue<quint32>(geometry.blendshapeChannelNames.size());
+    foreach (const QString& name, geometry.blendshapeChannelNames) {
+        writeString(name);
+    }
+}
+
+/// Reads what FBXGeometryWriter writes, throwing a QString if the data runs out or doesn't make sense.
+class FBXGeometryReader {
+public:
+
+    FBXGeometryReader(const char* data, qint64 size) : _data(data), _size(size), _position(0) { }
+
+    template<class T> void readValue(T& value) {
+        memcpy(&value, require(sizeof(T)), sizeof(T));
+    }
+    bool readBool() { quint8 value; readValue(value); return value != 0; }
+    int readCount();
+    void readBytes(QByteArray& bytes);
+    void readString(QString& string);
+
+    template<class T> void readArray(QVector<T>& values) {
+        quint32 count;
+        readValue(count);
+        require(getPadding(_position));
+        if (count > (quint64)(_size - _position) / sizeof(T)) {
+            throw QString("array runs past the end of the entry");
+        }
+        values.resize(count);
+        memcpy(values.data(), require(count * sizeof(T)), count * sizeof(T));
+    }
+
+    void readExtents(Extents& extents);
+    void readTexture(FBXTexture& texture);
+    void readJoint(FBXJoint& joint);
+    void readMesh(FBXMesh& mesh);
+    void readGeometry(FBXGeometry& geometry);
+
+private:
+
+    const char* require(qint64 length);
+
+    const char* _data;
+    qint64 _size;
+    qint64 _position;
+};
+
+int FBXGeometryReader::readCount() {
+    // every counted item takes at least a byte, which bounds what a corrupt count can make us allocate
+    quint32 count;
+    readValue(count);
+    if (count > _size - _position) {
+        throw QString("count runs past the end of the entry");
+    }
+    return count;
+}
+
+void FBXGeometryReader::readBytes(QByteArray& bytes) {
+    quint32 length;
+    readValue(length);
+    bytes = QByteArray(require(length), length);
+}
+
+void FBXGeometryReader::readString(QString& string) {
+    QByteArray utf8;
+    readBytes(utf8);
+    string = QString::fromUtf8(utf8);
+}
+
+void FBXGeometryReader::readExtents(Extents& extents) {
+    readValue(extents.minimum);
+    readValue(extents.maximum);
+}
+
+void FBXGeometryReader::readTexture(FBXTexture& texture) {
+    readString(texture.name);
+    readBytes(texture.filename);
+    readBytes(texture.content);
+    glm::vec3 translation;
+    glm::quat rotation;
+    glm::vec3 scale;
+    readValue(translation);
+    readValue(rotation);
+    readValue(scale);
+    texture.transform.setTranslation(translation);
+    texture.transform.setRotation(rotation);
+    texture.transform.setScale(scale);
+    qint32 texcoordSet;
+    readValue(texcoordSet);
+    texture.texcoordSet = texcoordSet;
+    readString(texture.texcoordSetName);
+}
+
+void FBXGeometryReader::readJoint(FBXJoint& joint) {
+    joint.isFree = readBool();
+    readArray(joint.freeLineage);
+    qint32 parentIndex;
+    readValue(parentIndex);
+    joint.parentIndex = parentIndex;
+    readValue(joint.distanceToParent);
+    readValue(joint.boneRadius);
+    readValue(joint.translation);
+    readValue(joint.preTransform);
+    readValue(joint.preRotation);
+    readValue(joint.rotation);
+    readValue(joint.postRotation);
+    readValue(joint.postTransform);
+    readValue(joint.transform);
+    readValue(joint.rotationMin);
+    readValue(joint.rotationMax);
+    readValue(joint.inverseDefaultRotation);
+    readValue(joint.inverseBindRotation);
+    readValue(joint.bindTransform);
+    readString(joint.name);
+    readValue(joint.shapePosition);
+    readValue(joint.shapeRotation);
+    readValue(joint.shapeType);
+    joint.isSkeletonJoint = readBool();
+}
+
+void FBXGeometryReader::readMesh(FBXMesh& mesh) {
+    // materials are rebuilt from the colors of the parts the same way extraction builds them, once per material
+    QHash<QString, model::MaterialPointer> materials;
+
+    mesh.parts.resize(readCount());
+    for (int i = 0; i < mesh.parts.size(); i++) {
+        FBXMeshPart& part = mesh.parts[i];
+        readArray(part.quadIndices);
+        readArray(part.triangleIndices);
+        readValue(part.diffuseColor);
+        readValue(part.specularColor);
+        readValue(part.emissiveColor);
+        readValue(part.emissiveParams);
+        readValue(part.shininess);
+        readValue(part.opacity);
+        readTexture(part.diffuseTexture);
+        readTexture(part.normalTexture);
+        readTexture(part.specularTexture);
+        readTexture(part.emissiveTexture);
+        readString(part.materialID);
+        if (readBool()) {
+            model::MaterialPointer& material = materials[part.materialID];
+            if (!material) {
+                material = model::MaterialPointer(new model::Material());
+                material->setEmissive(part.emissiveColor);
+                material->setDiffuse(part.diffuseColor);
+                material->setMetallic(glm::length(part.specularColor));
+                material->setGloss(part.shininess);
+                material->setOpacity(part.opacity <= 0.0f ? 1.0f : part.opacity);
+            }
+            part._material = material;
+        }
+    }
+
+    readArray(mesh.vertices);
+    readArray(mesh.normals);
+    readArray(mesh.tangents);
+    readArray(mesh.colors);
+    readArray(mesh.texCoords);
+    readArray(mesh.texCoords1);
+    readArray(mesh.clusterIndices);
+    readArray(mesh.clusterWeights);
+
+    mesh.clusters.resize(readCount());
+    for (int i = 0; i < mesh.clusters.size(); i++) {
+        qint32 jointIndex;
+        readValue(jointIndex);
+        mesh.clusters[i].jointIndex = jointIndex;
+        readValue(mesh.clusters[i].inverseBindMatrix);
+    }
+
+    readExtents(mesh.meshExtents);
+    readValue(mesh.modelTransform);
+    mesh.isEye = readBool();
+
+    mesh.blendshapes.resize(readCount());
+    for (int i = 0; i < mesh.blendshapes.size(); i++) {
+        readArray(mesh.blendshapes[i].indices);
+        readArray(mesh.blendshapes[i].vertices);
+        readArray(mesh.blendshapes[i].normals);
+    }
+    quint32 meshIndex;
+    readValue(meshIndex);
+    mesh.meshIndex = meshIndex;
+
+#   if USE_MODEL_MESH
+    buildModelMesh(mesh);
+#   endif
+}
+
+void FBXGeometryReader::readGeometry(FBXGeometry& geometry) {
+    quint32 version;
+    quint32 byteOrderMark;
+    if (memcmp(require(sizeof(FBX_GEOMETRY_MAGIC)), FBX_GEOMETRY_MAGIC, sizeof(FBX_GEOMETRY_MAGIC)) != 0) {
+        throw QString("not a geometry cache entry");
+    }
+    readValue(version);
+    readValue(byteOrderMark);
+    if (version != FBX_GEOMETRY_CACHE_VERSION || byteOrderMark != FBX_GEOMETRY_BYTE_ORDER_MARK) {
+        throw QString("geometry cache entry of another version or byte order");
+    }
+
+    readString(geometry.author);
+    readString(geometry.applicationName);
+
+    geometry.joints.resize(readCount());
+    for (int i = 0; i < geometry.joints.size(); i++) {
+        readJoint(geometry.joints[i]);
+    }
+    for (int i = 0, count = readCount(); i < count; i++) {
+        QString name;
+        qint32 index;
+        readString(name);
+        readValue(index);
+        geometry.jointIndices.insert(name, index);
+    }
+    geometry.hasSkeletonJoints = readBool();
+
+    geometry.meshes.resize(readCount());
+    for (int i = 0; i < geometry.meshes.size(); i++) {
+        readMesh(geometry.meshes[i]);
+    }
+
+    readValue(geometry.offset);
+    qint32 jointIndices[10];
+    for (int i = 0; i < 10; i++) {
+        readValue(jointIndices[i]);
+    }
+    geometry.leftEyeJointIndex = jointIndices[0];
+    geometry.rightEyeJointIndex = jointIndices[1];
+    geometry.neckJointIndex = jointIndices[2];
+    geometry.rootJointIndex = jointIndices[3];
+    geometry.leanJointIndex = jointIndices[4];
+    geometry.headJointIndex = jointIndices[5];
+    geometry.leftHandJointIndex = jointIndices[6];
+    geometry.rightHandJointIndex = jointIndices[7];
+    geometry.leftToeJointIndex = jointIndices[8];
+    geometry.rightToeJointIndex = jointIndices[9];
+    readArray(geometry.humanIKJointIndices);
+    readValue(geometry.palmDirection);
+
+    geometry.sittingPoints.resize(readCount());
+    for (int i = 0; i < geometry.sittingPoints.size(); i++) {
+        readString(geometry.sittingPoints[i].name);
+        readValue(geometry.sittingPoints[i].position);
+        readValue(geometry.sittingPoints[i].rotation);
+    }
+
+    readValue(geometry.neckPivot);
+    readExtents(geometry.bindExtents);
+    readExtents(geometry.meshExtents);
+
+    geometry.animationFrames.resize(readCount());
+    for (int i = 0; i < geometry.animationFrames.size(); i++) {
+        readArray(geometry.animationFrames[i].rotations);
+    }
+
+    for (int i = 0, count = readCount(); i < count; i++) {
+        qint32 meshIndex;
+        QString name;
+        readValue(meshIndex);
+        readString(name);
+        geometry.meshIndicesToModelNames.insert(meshIndex, name);
+    }
+
+    for (int i = 0, count = readCount(); i < count; i++) {
+        QString name;
+        readString(name);
+        geometry.blendshapeChannelNames.append(name);
+    }
+}
+
+const char* FBXGeometryReader::require(qint64 length) {
+    if (length > _size - _position) {
+        throw QString("unexpected end of the entry");
+    }
+    const char* start = _data + _position;
+    _position += length;
+    return start;
+}
+
+QByteArray writeFBXGeometry(const FBXGeometry& geometry) {
+    FBXGeometryWriter writer;
+    writer.writeGeometry(geometry);
+    return writer.getData();
+}
+
+bool readFBXGeometry(const char* data, qint64 size, FBXGeometry& geometry) {
+    try {
+        FBXGeometryReader(data, size).readGeometry(geometry);
+        return true;
+
+    } catch (const QString& error) {
+        qCDebug(modelformat) << "Invalid geometry cache entry:" << error;
+        geometry = FBXGeometry();
+        return false;
+    }
+}
+
+void FBXGeometryCache::setCacheDirectory(const QString& directory) {
+    QMutexLocker locker(&_mutex);
+    _directory = directory;
+    if (!directory.isEmpty()) {
+        QDir().mkpath(directory);
+    }
+}
+
+QString FBXGeometryCache::getCacheDirectory() {
+    QMutexLocker locker(&_mutex);
+    return _directory;
+}
+
+void FBXGeometryCache::setMaximumCacheSize(qint64 size) {
+    QMutexLocker locker(&_mutex);
+    _maximumSize = size;
+}
+
+static void addToHash(QCryptographicHash& hash, const QVariant& value) {
+    hash.addData(QByteArray::number(value.userType()) + ':');
+    if (value.type() == QVariant::Hash) {
+        // hashes iterate in a different order from one run to the next, so go through the keys sorted
+        QVariantHash map = value.toHash();
+        QStringList keys = map.uniqueKeys();
+        keys.sort();
+        foreach (const QString& key, keys) {
+            hash.addData(key.toUtf8() + '=');
+            foreach (const QVariant& child, map.values(key)) {
+                addToHash(hash, child);
+            }
+        }
+    } else if (value.type() == QVariant::Map) {
+        QVariantMap map = value.toMap();
+        for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); it++) {
+            hash.addData(it.key().toUtf8() + '=');
+            addToHash(hash, it.value());
+        }
+    } else if (value.type() == QVariant::List || value.type() == QVariant::StringList) {
+        foreach (const QVariant& child, value.toList()) {
+            addToHash(hash, child);
+        }
+    } else {
+        hash.addData(value.toString().toUtf8());
+    }
+    hash.addData(";");
+}
+
+QByteArray FBXGeometryCache::getKey(const QByteArray& model, const QVariantHash& mapping, bool loadLightmaps,
+                                    float lightmapLevel) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(FBX_GEOMETRY_CACHE_VERSION) + ':');
+    hash.addData(QByteArray::number((int)loadLightmaps) + ':' + QByteArray::number(lightmapLevel) + ':');
+    addToHash(hash, QVariant(mapping));
+    hash.addData(model);
+    return hash.result().toHex();
+}
+
+bool FBXGeometryCache::load(const QByteArray& key, FBXGeometry& geometry) {
+    QString directory = getCacheDirectory();
+    if (directory.isEmpty()) {
+        return false;
+    }
+    QFile file(QDir(directory).filePath(key + CACHE_FILE_SUFFIX));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    bool read;
+    uchar* data = file.map(0, file.size());
+    if (data) {
+        read = readFBXGeometry(reinterpret_cast<const char*>(data), file.size(), geometry);
+        file.unmap(data);
+
+    } else {
+        QByteArray contents = file.readAll();
+        read = readFBXGeometry(contents.constData(), contents.size(), geometry);
+    }
+    if (!read) {
+        file.remove();
+    }
+    return read;
+}
+
+void FBXGeometryCache::store(const QByteArray& key, const FBXGeometry& geometry) {
+    QString directory = getCacheDirectory();
+    if (directory.isEmpty()) {
+        return;
+    }
+    // written aside and renamed into place, so that a reader never maps a partly written entry
+    QSaveFile file(QDir(directory).filePath(key + CACHE_FILE_SUFFIX));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    file.write(writeFBXGeometry(geometry));
+    if (file.commit()) {
+        expire();
+    }
+}
+
+void FBXGeometryCache::expire() {
+    QMutexLocker locker(&_mutex);
+    QFileInfoList entries = QDir(_directory).entryInfoList(QStringList() << "*" + CACHE_FILE_SUFFIX,
+                                                           QDir::Files, QDir::Time);
+    qint64 totalSize = 0;
+    foreach (const QFileInfo& entry, entries) {
+        totalSize += entry.size();
+        if (totalSize > _maximumSize) {
+            QFile::remove(entry.filePath());
+        }
+    }
+}
+
+FBXGeometry readCachedFBX(const QByteArray& model, const QVariantHash& mapping, bool loadLightmaps, float lightmapLevel) {
+    if (FBXGeometryCache::getCacheDirectory().isEmpty()) {
+        return readFBX(model, mapping, loadLightmaps, lightmapLevel);
+    }
+    QByteArray key = FBXGeometryCache::getKey(model, mapping, loadLightmaps, lightmapLevel);
+    FBXGeometry geometry;
+    if (FBXGeometryCache::load(key, geometry)) {
+        return geometry;
+    }
+    geometry = readFBX(model, mapping, loadLightmaps, lightmapLevel);
+    FBXGeometryCache::store(key, geometry);
+    return geometry;
+}
@@ -0,0 +1,65 @@
+//
+//  FBXGeometryCache.h
+//  libraries/fbx/src
+//
+//  Created on 2015-06-19.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXGeometryCache_h
+#define hifi_FBXGeometryCache_h
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+
+#include "FBXReader.h"
+
+/// An on-disk cache of extracted FBX geometry. Entries are keyed by a hash of the model's contents and of everything
+/// else that goes into extracting it, so a model that was read before, under any URL, loads without being parsed.
+///
+/// Entries are written in a binary layout that mirrors FBXGeometry: every array is stored as its raw elements on a
+/// 16 byte boundary, so that reading an entry maps the file and copies each array into place in one go.
+class FBXGeometryCache {
+public:
+
+    /// Enables the cache, keeping its entries in the given directory. The cache is disabled until this is called.
+    static void setCacheDirectory(const QString& directory);
+    static QString getCacheDirectory();
+
+    /// Sets the size the entries are trimmed to, oldest first, after a new one is stored.
+    static void setMaximumCacheSize(qint64 size);
+
+    /// Returns the key of the geometry that readFBX() extracts from the given arguments.
+    static QByteArray getKey(const QByteArray& model, const QVariantHash& mapping, bool loadLightmaps, float lightmapLevel);
+
+    /// Reads the entry with the given key into the geometry, returns false if there is no valid entry.
+    static bool load(const QByteArray& key, FBXGeometry& geometry);
+
+    /// Stores the geometry as the entry with the given key.
+    static void store(const QByteArray& key, const FBXGeometry& geometry);
+
+private:
+
+    static void expire();
+
+    static QMutex _mutex;
+    static QString _directory;
+    static qint64 _maximumSize;
+};
+
+/// Writes geometry in the layout of the cache entries.
+QByteArray writeFBXGeometry(const FBXGeometry& geometry);
+
+/// Reads geometry written by writeFBXGeometry(), returns false if the data isn't valid for this version and machine.
+bool readFBXGeometry(const char* data, qint64 size, FBXGeometry& geometry);
+
+/// Reads FBX geometry like readFBX(), through the geometry cache when it is enabled.
+/// \exception QString if an error occurs in parsing
+FBXGeometry readCachedFBX(const QByteArray& model, const QVariantHash& mapping, bool loadLightmaps = true,
+                          float lightmapLevel = 1.0f);
+
+#endif // hifi_FBXGeometryCache_h
@@ -9,9 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstring>
 #include <iostream>
 #include <QBuffer>
-#include <QDataStream>
 #include <QIODevice>
 #include <QStringList>
 #include <QTextStream>
@@ -184,131 +184,77 @@ static int fbxGeometryMetaTypeId = qRegisterMetaType<FBXGeometry>();
 static int fbxAnimationFrameMetaTypeId = qRegisterMetaType<FBXAnimationFrame>();
 static int fbxAnimationFrameVectorMetaTypeId = qRegisterMetaType<QVector<FBXAnimationFrame> >();
 
-template<class T> int streamSize() {
-    return sizeof(T);
+// see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
+// of the FBX binary format
+
+template<class T> void copyFromLittleEndian(const char* source, T* destination, int count) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    memcpy(destination, source, count * sizeof(T));
+#else
+    for (int i = 0; i < count; i++) {
+        char* bytes = reinterpret_cast<char*>(destination + i);
+        for (int j = 0; j < (int)sizeof(T); j++) {
+            bytes[j] = source[i * sizeof(T) + sizeof(T) - 1 - j];
+        }
+    }
+#endif
 }
 
-template<bool> int streamSize() {
-    return 1;
+template<> void copyFromLittleEndian<bool>(const char* source, bool* destination, int count) {
+    for (int i = 0; i < count; i++) {
+        destination[i] = (source[i] != 0);
+    }
 }
 
-template<class T> QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
+/// Parses a binary FBX document held in memory. Arrays, which are nearly all of a model, are copied or inflated from
+/// the document straight into the vectors that hold them, rather than streamed in one value at a time.
+class BinaryFBXParser {
+public:
 
-    in >> arrayLength;
-    in >> encoding;
-    in >> compressedLength;
-    position += sizeof(quint32) * 3;
+    /// The data is modified by parsing, see readArray().
+    BinaryFBXParser(QByteArray& data) : _data(data.data()), _size(data.size()), _position(0) { }
 
-    QVector<T> values;
-    const unsigned int DEFLATE_ENCODING = 1;
-    if (encoding == DEFLATE_ENCODING) {
-        // preface encoded data with uncompressed length
-        QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-        *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-        in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-        position += compressedLength;
-        QByteArray uncompressed = qUncompress(compressed);
-        QDataStream uncompressedIn(uncompressed);
-        uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-        uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-        for (quint32 i = 0; i < arrayLength; i++) {
-            T value;
-            uncompressedIn >> value;
-            values.append(value);
-        }
-    } else {
-        for (quint32 i = 0; i < arrayLength; i++) {
-            T value;
-            in >> value;
-            position += streamSize<T>();
-            values.append(value);
-        }
-    }
-    return QVariant::fromValue(values);
-}
+    FBXNode parse();
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
-    switch (ch) {
-        case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
-        }
-        case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
-        }
-        case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
-        }
-        case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
-        }
-        case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
-        }
-        case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
-        }
-        case 'f': {
-            return readBinaryArray<float>(in, position);
-        }
-        case 'd': {
-            return readBinaryArray<double>(in, position);
-        }
-        case 'l': {
-            return readBinaryArray<qint64>(in, position);
-        }
-        case 'i': {
-            return readBinaryArray<qint32>(in, position);
-        }
-        case 'b': {
-            return readBinaryArray<bool>(in, position);
-        }
-        case 'S':
-        case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+private:
+
+    FBXNode parseNode();
+    QVariant parseProperty();
+
+    template<class T> T read();
+    template<class T> QVariant readArray();
+
+    const char* require(int length);
+
+    char* _data;
+    int _size;
+    int _position;
+};
+
+FBXNode BinaryFBXParser::parse() {
+    // skip the rest of the header
+    const int HEADER_SIZE = 27;
+    require(HEADER_SIZE);
+
+    // parse the top-level node
+    FBXNode top;
+    while (_position < _size) {
+        FBXNode next = parseNode();
+        if (next.name.isNull()) {
+            return top;
+
+        } else {
+            top.children.append(next);
         }
-        default:
-            throw QString("Unknown property type: ") + ch;
     }
+    return top;
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position) {
-    qint32 endOffset;
-    quint32 propertyCount;
-    quint32 propertyListLength;
-    quint8 nameLength;
-
-    in >> endOffset;
-    in >> propertyCount;
-    in >> propertyListLength;
-    in >> nameLength;
-    position += sizeof(quint32) * 3 + sizeof(quint8);
+FBXNode BinaryFBXParser::parseNode() {
+    qint32 endOffset = read<qint32>();
+    quint32 propertyCount = read<quint32>();
+    read<quint32>(); // property list length
+    quint8 nameLength = read<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -316,15 +262,14 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position) {
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = QByteArray(require(nameLength), nameLength);
 
     for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+        node.properties.append(parseProperty());
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position);
+    while (endOffset > _position) {
+        FBXNode child = parseNode();
         if (child.name.isNull()) {
             return node;
 
@@ -336,6 +281,95 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position) {
     return node;
 }
 
+QVariant BinaryFBXParser::parseProperty() {
+    char ch = read<char>();
+    switch (ch) {
+        case 'Y':
+            return QVariant::fromValue(read<qint16>());
+
+        case 'C':
+            return QVariant::fromValue(read<bool>());
+
+        case 'I':
+            return QVariant::fromValue(read<qint32>());
+
+        case 'F':
+            return QVariant::fromValue(read<float>());
+
+        case 'D':
+            return QVariant::fromValue(read<double>());
+
+        case 'L':
+            return QVariant::fromValue(read<qint64>());
+
+        case 'f':
+            return readArray<float>();
+
+        case 'd':
+            return readArray<double>();
+
+        case 'l':
+            return readArray<qint64>();
+
+        case 'i':
+            return readArray<qint32>();
+
+        case 'b':
+            return readArray<bool>();
+
+        case 'S':
+        case 'R': {
+            quint32 length = read<quint32>();
+            return QVariant::fromValue(QByteArray(require(length), length));
+        }
+        default:
+            throw QString("Unknown property type: ") + ch;
+    }
+}
+
+template<class T> T BinaryFBXParser::read() {
+    T value;
+    copyFromLittleEndian(require(sizeof(T)), &value, 1);
+    return value;
+}
+
+template<class T> QVariant BinaryFBXParser::readArray() {
+    quint32 arrayLength = read<quint32>();
+    quint32 encoding = read<quint32>();
+    quint32 compressedLength = read<quint32>();
+
+    const quint32 MAX_ARRAY_BYTES = 0x7FFFFFFF;
+    if (arrayLength > MAX_ARRAY_BYTES / sizeof(T)) {
+        throw QString("FBX array too large");
+    }
+    QVector<T> values(arrayLength);
+    const unsigned int DEFLATE_ENCODING = 1;
+    if (encoding == DEFLATE_ENCODING) {
+        // qUncompress wants the data prefaced with the uncompressed length, so it goes where the compressed length was
+        char* compressed = const_cast<char*>(require(compressedLength)) - sizeof(quint32);
+        qToBigEndian<quint32>(arrayLength * sizeof(T), reinterpret_cast<uchar*>(compressed));
+        QByteArray uncompressed = qUncompress(reinterpret_cast<const uchar*>(compressed),
+                                              compressedLength + sizeof(quint32));
+        if (uncompressed.size() != (int)(arrayLength * sizeof(T))) {
+            throw QString("Invalid compressed FBX array");
+        }
+        copyFromLittleEndian(uncompressed.constData(), values.data(), arrayLength);
+
+    } else {
+        copyFromLittleEndian(require(arrayLength * sizeof(T)), values.data(), arrayLength);
+    }
+    return QVariant::fromValue(values);
+}
+
+const char* BinaryFBXParser::require(int length) {
+    if (length < 0 || length > _size - _position) {
+        throw QString("Unexpected end of FBX file");
+    }
+    const char* start = _data + _position;
+    _position += length;
+    return start;
+}
+
 class Tokenizer {
 public:
 
@@ -477,56 +511,24 @@ FBXNode parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-
-    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
-    // of the FBX binary format
-
-    // skip the rest of the header
-    const int HEADER_SIZE = 27;
-    in.skipRawData(HEADER_SIZE);
-    int position = HEADER_SIZE;
-
-    // parse the top-level node
-    FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position);
-        if (next.name.isNull()) {
-            return top;
-
-        } else {
-            top.children.append(next);
-        }
-    }
-
-    return top;
+    QByteArray data = device->readAll();
+    return BinaryFBXParser(data).parse();
 }
 
 QVector<glm::vec4> createVec4Vector(const QVector<double>& doubleVector) {
-    QVector<glm::vec4> values;
-    for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 4) * 4); it != end; ) {
-        float x = *it++;
-        float y = *it++;
-        float z = *it++;
-        float w = *it++;
-        values.append(glm::vec4(x, y, z, w));
+    QVector<glm::vec4> values(doubleVector.size() / 4);
+    const double* it = doubleVector.constData();
+    for (glm::vec4* value = values.data(), *end = value + values.size(); value != end; value++, it += 4) {
+        *value = glm::vec4(it[0], it[1], it[2], it[3]);
     }
     return values;
 }
 
 
 QVector<glm::vec4> createVec4VectorRGBA(const QVector<double>& doubleVector, glm::vec4& average) {
-    QVector<glm::vec4> values;
-    for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 4) * 4); it != end; ) {
-        float x = *it++;
-        float y = *it++;
-        float z = *it++;
-        float w = *it++;
-        auto val = glm::vec4(x, y, z, w);
-        values.append(val);
-        average += val;
+    QVector<glm::vec4> values = createVec4Vector(doubleVector);
+    foreach (const glm::vec4& value, values) {
+        average += value;
     }
     if (!values.isEmpty()) {
         average *= (1.0f / float(values.size()));
@@ -535,22 +537,19 @@ QVector<glm::vec4> createVec4VectorRGBA(const QVector<double>& doubleVector, glm
 }
 
 QVector<glm::vec3> createVec3Vector(const QVector<double>& doubleVector) {
-    QVector<glm::vec3> values;
-    for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 3) * 3); it != end; ) {
-        float x = *it++;
-        float y = *it++;
-        float z = *it++;
-        values.append(glm::vec3(x, y, z));
+    QVector<glm::vec3> values(doubleVector.size() / 3);
+    const double* it = doubleVector.constData();
+    for (glm::vec3* value = values.data(), *end = value + values.size(); value != end; value++, it += 3) {
+        *value = glm::vec3(it[0], it[1], it[2]);
     }
     return values;
 }
 
 QVector<glm::vec2> createVec2Vector(const QVector<double>& doubleVector) {
-    QVector<glm::vec2> values;
-    for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 2) * 2); it != end; ) {
-        float s = *it++;
-        float t = *it++;
-        values.append(glm::vec2(s, -t));
+    QVector<glm::vec2> values(doubleVector.size() / 2);
+    const double* it = doubleVector.constData();
+    for (glm::vec2* value = values.data(), *end = value + values.size(); value != end; value++, it += 2) {
+        *value = glm::vec2(it[0], -it[1]);
     }
     return values;
 }
@@ -995,10 +994,10 @@ ExtractedMesh extractMesh(const FBXNode& object, unsigned int& meshIndex) {
                 foreach (const FBXNode& subdata, child.children) {
                     if (subdata.name == "UV") {
                         data.texCoords = createVec2Vector(getDoubleVector(subdata));
-                        attrib.texCoords = createVec2Vector(getDoubleVector(subdata));
+                        attrib.texCoords = data.texCoords;
                     } else if (subdata.name == "UVIndex") {
                         data.texCoordIndices = getIntVector(subdata);
-                        attrib.texCoordIndices = getIntVector(subdata);
+                        attrib.texCoordIndices = data.texCoordIndices;
                     } else if (subdata.name == "Name") {
                         attrib.name = subdata.properties.at(0).toString();
                     } 
@@ -1311,21 +1310,20 @@ FBXLight extractLight(const FBXNode& object) {
 
 
 #if USE_MODEL_MESH
-void buildModelMesh(ExtractedMesh& extracted) {
+void buildModelMesh(FBXMesh& fbxMesh) {
     static QString repeatedMessage = LogHandler::getInstance().addRepeatedMessageRegex("buildModelMesh failed -- .*");
 
-    if (extracted.mesh.vertices.size() == 0) {
-        extracted.mesh._mesh = model::Mesh();
+    if (fbxMesh.vertices.size() == 0) {
+        fbxMesh._mesh = model::Mesh();
         qCDebug(modelformat) << "buildModelMesh failed -- no vertices";
         return;
     }
-    FBXMesh& fbxMesh = extracted.mesh;
     model::Mesh mesh;
 
     // Grab the vertices in a buffer
     gpu::BufferPointer vb(new gpu::Buffer());
-    vb->setData(extracted.mesh.vertices.size() * sizeof(glm::vec3),
-                (const gpu::Byte*) extracted.mesh.vertices.data());
+    vb->setData(fbxMesh.vertices.size() * sizeof(glm::vec3),
+                (const gpu::Byte*) fbxMesh.vertices.data());
     gpu::BufferView vbv(vb, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
     mesh.setVertexBuffer(vbv);
 
@@ -1397,12 +1395,12 @@ void buildModelMesh(ExtractedMesh& extracted) {
 
     unsigned int totalIndices = 0;
 
-    foreach(const FBXMeshPart& part, extracted.mesh.parts) {
+    foreach(const FBXMeshPart& part, fbxMesh.parts) {
         totalIndices += (part.quadIndices.size() + part.triangleIndices.size());
     }
 
     if (! totalIndices) {
-        extracted.mesh._mesh = model::Mesh();
+        fbxMesh._mesh = model::Mesh();
         qCDebug(modelformat) << "buildModelMesh failed -- no indices";
         return;
     }
@@ -1415,7 +1413,7 @@ void buildModelMesh(ExtractedMesh& extracted) {
 
     std::vector< model::Mesh::Part > parts;
 
-    foreach(const FBXMeshPart& part, extracted.mesh.parts) {
+    foreach(const FBXMeshPart& part, fbxMesh.parts) {
         model::Mesh::Part quadPart(indexNum, part.quadIndices.size(), 0, model::Mesh::QUADS);
         if (quadPart._numIndices) {
             parts.push_back(quadPart);
@@ -1442,7 +1440,7 @@ void buildModelMesh(ExtractedMesh& extracted) {
         gpu::BufferView pbv(pb, gpu::Element(gpu::VEC4, gpu::UINT32, gpu::XYZW));
         mesh.setPartBuffer(pbv);
     } else {
-        extracted.mesh._mesh = model::Mesh();
+        fbxMesh._mesh = model::Mesh();
         qCDebug(modelformat) << "buildModelMesh failed -- no parts";
         return;
     }
@@ -1450,7 +1448,7 @@ void buildModelMesh(ExtractedMesh& extracted) {
     // model::Box box =
     mesh.evalPartBound(0);
 
-    extracted.mesh._mesh = mesh;
+    fbxMesh._mesh = mesh;
 }
 #endif // USE_MODEL_MESH
 
@@ -2613,7 +2611,7 @@ FBXGeometry extractFBXGeometry(const FBXNode& node, const QVariantHash& mapping,
         extracted.mesh.isEye = (maxJointIndex == geometry.leftEyeJointIndex || maxJointIndex == geometry.rightEyeJointIndex);
 
 #       if USE_MODEL_MESH
-        buildModelMesh(extracted);
+        buildModelMesh(extracted.mesh);
 #       endif
         
         geometry.meshes.append(extracted.mesh);
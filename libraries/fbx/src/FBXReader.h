@@ -266,6 +266,15 @@ public:
 
 Q_DECLARE_METATYPE(FBXGeometry)
 
+#if USE_MODEL_MESH
+/// Builds the model::Mesh of an extracted mesh from its vertex attributes and parts.
+void buildModelMesh(FBXMesh& mesh);
+#endif
+
+/// Parses the node tree of an FBX document, binary or text.
+/// \exception QString if an error occurs in parsing
+FBXNode parseFBX(QIODevice* device);
+
 /// Reads FBX geometry from the supplied model and mapping data.
 /// \exception QString if an error occurs in parsing
 FBXGeometry readFBX(const QByteArray& model, const QVariantHash& mapping, bool loadLightmaps = true, float lightmapLevel = 1.0f);
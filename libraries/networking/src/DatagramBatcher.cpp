@@ -0,0 +1,175 @@
+//
+//  DatagramBatcher.cpp
+//  libraries/networking/src
+//
+//  Created on 2015-06-10.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DatagramBatcher.h"
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#endif
+
+#include "LimitedNodeList.h"
+#include "NetworkLogging.h"
+
+DatagramBatcher::DatagramBatcher(QUdpSocket& socket, int maxQueuedDatagrams, int maxReadDatagrams) :
+    _socket(socket),
+    _maxQueuedDatagrams(isSupported() ? qBound(0, maxQueuedDatagrams, (int)MAX_BATCHED_DATAGRAMS) : 0),
+    _numQueuedDatagrams(0),
+    _numDroppedDatagrams(0),
+    _numDroppedBytes(0),
+    _maxReadDatagrams(isSupported() ? qBound(0, maxReadDatagrams, (int)MAX_BATCHED_DATAGRAMS) : 0)
+{
+    _sendBuffer.resize(_maxQueuedDatagrams * MAX_PACKET_SIZE);
+    _sendSizes.resize(_maxQueuedDatagrams);
+    _sendDestinations.resize(_maxQueuedDatagrams);
+
+    _readBuffer.resize(_maxReadDatagrams * MAX_READ_DATAGRAM_SIZE);
+    _readSizes.resize(_maxReadDatagrams);
+    _readSenders.resize(_maxReadDatagrams);
+}
+
+bool DatagramBatcher::isSupported() {
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DatagramBatcher::queueDatagram(const char* data, qint64 size, const HifiSockAddr& destinationSockAddr) {
+    if (_maxQueuedDatagrams == 0 || size > MAX_PACKET_SIZE
+        || destinationSockAddr.getAddress().protocol() != QAbstractSocket::IPv4Protocol) {
+        // keep datagrams in order, everything queued has to go out before the caller sends this one
+        flush();
+        return false;
+    }
+
+    if (_numQueuedDatagrams == _maxQueuedDatagrams) {
+        flush();
+    }
+
+    memcpy(_sendBuffer.data() + _numQueuedDatagrams * MAX_PACKET_SIZE, data, size);
+    _sendSizes[_numQueuedDatagrams] = size;
+    _sendDestinations[_numQueuedDatagrams] = destinationSockAddr;
+    ++_numQueuedDatagrams;
+
+    return true;
+}
+
+int DatagramBatcher::flush() {
+    if (_numQueuedDatagrams == 0) {
+        return 0;
+    }
+
+    int numDropped = 0;
+
+#ifdef Q_OS_LINUX
+    sockaddr_in addresses[MAX_BATCHED_DATAGRAMS];
+    iovec buffers[MAX_BATCHED_DATAGRAMS];
+    mmsghdr messages[MAX_BATCHED_DATAGRAMS];
+    memset(messages, 0, sizeof(mmsghdr) * _numQueuedDatagrams);
+
+    for (int i = 0; i < _numQueuedDatagrams; i++) {
+        memset(&addresses[i], 0, sizeof(sockaddr_in));
+        addresses[i].sin_family = AF_INET;
+        addresses[i].sin_addr.s_addr = htonl(_sendDestinations[i].getAddress().toIPv4Address());
+        addresses[i].sin_port = htons(_sendDestinations[i].getPort());
+
+        buffers[i].iov_base = _sendBuffer.data() + i * MAX_PACKET_SIZE;
+        buffers[i].iov_len = _sendSizes[i];
+
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages[i].msg_hdr.msg_iov = &buffers[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int socketDescriptor = (int)_socket.socketDescriptor();
+    int numSent = 0;
+    while (numSent < _numQueuedDatagrams) {
+        int result = sendmmsg(socketDescriptor, messages + numSent, _numQueuedDatagrams - numSent, MSG_DONTWAIT);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // like any other UDP send that fails the rest of the batch is lost, the senders were told it was written
+            // so it is logged and counted here
+            numDropped = _numQueuedDatagrams - numSent;
+            qCDebug(networking) << "ERROR in DatagramBatcher::flush:" << strerror(errno) << "-"
+                << numDropped << "datagrams dropped";
+            _numDroppedDatagrams += numDropped;
+            for (int i = numSent; i < _numQueuedDatagrams; i++) {
+                _numDroppedBytes += _sendSizes[i];
+            }
+            break;
+        }
+        numSent += result;
+    }
+#endif
+
+    _numQueuedDatagrams = 0;
+    return numDropped;
+}
+
+int DatagramBatcher::readDatagrams() {
+#ifdef Q_OS_LINUX
+    if (_maxReadDatagrams == 0) {
+        return 0;
+    }
+
+    sockaddr_in addresses[MAX_BATCHED_DATAGRAMS];
+    iovec buffers[MAX_BATCHED_DATAGRAMS];
+    mmsghdr messages[MAX_BATCHED_DATAGRAMS];
+    memset(messages, 0, sizeof(mmsghdr) * _maxReadDatagrams);
+
+    for (int i = 0; i < _maxReadDatagrams; i++) {
+        buffers[i].iov_base = _readBuffer.data() + i * MAX_READ_DATAGRAM_SIZE;
+        buffers[i].iov_len = MAX_READ_DATAGRAM_SIZE;
+
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages[i].msg_hdr.msg_iov = &buffers[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int numRead = 0;
+    do {
+        numRead = recvmmsg((int)_socket.socketDescriptor(), messages, _maxReadDatagrams, MSG_DONTWAIT, NULL);
+    } while (numRead < 0 && errno == EINTR);
+
+    if (numRead <= 0) {
+        return 0;
+    }
+
+    int numValid = 0;
+    for (int i = 0; i < numRead; i++) {
+        if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            qCDebug(networking) << "DatagramBatcher dropped a datagram larger than" << MAX_READ_DATAGRAM_SIZE << "bytes";
+            continue;
+        }
+
+        // compact the valid datagrams down to the front of the ring
+        if (numValid != i) {
+            memmove(_readBuffer.data() + numValid * MAX_READ_DATAGRAM_SIZE,
+                    _readBuffer.constData() + i * MAX_READ_DATAGRAM_SIZE, messages[i].msg_len);
+        }
+        _readSizes[numValid] = messages[i].msg_len;
+        _readSenders[numValid] = HifiSockAddr(reinterpret_cast<const sockaddr*>(&addresses[i]));
+        ++numValid;
+    }
+
+    return numValid;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,79 @@
+//
+//  DatagramBatcher.h
+//  libraries/networking/src
+//
+//  Created on 2015-06-10.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Batches datagram sends and receives on a UDP socket into single sendmmsg and recvmmsg calls where available
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DatagramBatcher_h
+#define hifi_DatagramBatcher_h
+
+#include <QtCore/QVector>
+#include <QtNetwork/QUdpSocket>
+
+#include "HifiSockAddr.h"
+
+/// Queues outgoing datagrams so that a whole frame of them can be handed to the kernel in one sendmmsg call, and drains
+/// incoming datagrams with recvmmsg into a preallocated ring. Only Linux has these calls, elsewhere isSupported()
+/// is false, nothing is ever queued or read and callers use the QUdpSocket directly.
+class DatagramBatcher {
+public:
+    static const int MAX_BATCHED_DATAGRAMS = 32;
+
+    // datagrams are read into fixed size slots, this is well beyond anything we send
+    static const int MAX_READ_DATAGRAM_SIZE = 16384;
+
+    /// the buffers are sized for the given number of datagrams per sendmmsg and recvmmsg call, up to
+    /// MAX_BATCHED_DATAGRAMS. A batcher that only sends or only reads passes 0 for the other one and allocates nothing
+    /// for it.
+    DatagramBatcher(QUdpSocket& socket, int maxQueuedDatagrams, int maxReadDatagrams);
+
+    static bool isSupported();
+
+    /// copies the datagram into the send batch, sending the batch first if it is full.
+    /// Returns false if the datagram can't be batched, in which case anything already queued has been sent
+    /// and the caller should send the datagram itself.
+    bool queueDatagram(const char* data, qint64 size, const HifiSockAddr& destinationSockAddr);
+
+    /// sends every queued datagram, returns the number of them that couldn't be sent
+    int flush();
+
+    int getNumQueuedDatagrams() const { return _numQueuedDatagrams; }
+
+    /// queued datagrams that a flush couldn't send, queueDatagram() had already reported them as written
+    int getNumDroppedDatagrams() const { return _numDroppedDatagrams; }
+    qint64 getNumDroppedBytes() const { return _numDroppedBytes; }
+    void resetDroppedStats() { _numDroppedDatagrams = 0; _numDroppedBytes = 0; }
+
+    /// reads the datagrams that are already waiting on the socket without blocking, up to maxReadDatagrams.
+    /// Returns the number read, they can be accessed with the getters below until the next call.
+    int readDatagrams();
+
+    const char* getReadDatagram(int index) const { return _readBuffer.constData() + index * MAX_READ_DATAGRAM_SIZE; }
+    int getReadDatagramSize(int index) const { return _readSizes[index]; }
+    const HifiSockAddr& getReadDatagramSender(int index) const { return _readSenders[index]; }
+
+private:
+    QUdpSocket& _socket;
+
+    int _maxQueuedDatagrams;
+    QVector<char> _sendBuffer;
+    QVector<int> _sendSizes;
+    QVector<HifiSockAddr> _sendDestinations;
+    int _numQueuedDatagrams;
+    int _numDroppedDatagrams;
+    qint64 _numDroppedBytes;
+
+    int _maxReadDatagrams;
+    QVector<char> _readBuffer;
+    QVector<int> _readSizes;
+    QVector<HifiSockAddr> _readSenders;
+};
+
+#endif // hifi_DatagramBatcher_h
@@ -44,6 +44,8 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
     _nodeHash(),
     _nodeMutex(QReadWriteLock::Recursive),
     _nodeSocket(this),
+    _datagramBatcher(_nodeSocket, DatagramBatcher::MAX_BATCHED_DATAGRAMS, 0), // what we read goes through the socket
+    _datagramBatchThread(NULL),
     _dtlsSocket(NULL),
     _localSockAddr(),
     _publicSockAddr(),
@@ -190,7 +192,7 @@ bool LimitedNodeList::packetVersionAndHashMatch(const QByteArray& packet) {
         SharedNodePointer sendingNode = sendingNodeForPacket(packet);
         if (sendingNode) {
             // check if the md5 hash in the header matches the hash we would expect
-            if (hashFromPacketHeader(packet) == hashForPacketAndConnectionUUID(packet, sendingNode->getConnectionSecret())) {
+            if (packetHashMatches(packet, sendingNode->getConnectionSecret())) {
                 return true;
             } else {
                 static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
@@ -233,12 +235,21 @@ qint64 LimitedNodeList::readDatagram(QByteArray& incomingPacket, QHostAddress* a
 }
 
 qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram, const HifiSockAddr& destinationSockAddr) {
+    return writeDatagram(datagram.constData(), datagram.size(), destinationSockAddr);
+}
+
+qint64 LimitedNodeList::writeDatagram(const char* data, qint64 size, const HifiSockAddr& destinationSockAddr) {
     // XXX can BandwidthRecorder be used for this?
     // stat collection for packets
     ++_numCollectedPackets;
-    _numCollectedBytes += datagram.size();
+    _numCollectedBytes += size;
+
+    if (_datagramBatchThread.load() == QThread::currentThread()
+        && _datagramBatcher.queueDatagram(data, size, destinationSockAddr)) {
+        return size;
+    }
 
-    qint64 bytesWritten = _nodeSocket.writeDatagram(datagram,
+    qint64 bytesWritten = _nodeSocket.writeDatagram(data, size,
                                                     destinationSockAddr.getAddress(), destinationSockAddr.getPort());
 
     if (bytesWritten < 0) {
@@ -248,14 +259,42 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram, const HifiSock
     return bytesWritten;
 }
 
+void LimitedNodeList::beginDatagramBatch() {
+    if (DatagramBatcher::isSupported()) {
+        // only one thread at a time can batch, anything sent from other threads goes straight out
+        _datagramBatchThread.testAndSetOrdered(NULL, QThread::currentThread());
+    }
+}
+
+int LimitedNodeList::sendDatagramBatch() {
+    int numDropped = 0;
+    if (_datagramBatchThread.load() == QThread::currentThread()) {
+        _datagramBatcher.flush();
+
+        // the datagrams that didn't go out were counted when they were queued
+        numDropped = _datagramBatcher.getNumDroppedDatagrams();
+        _numCollectedPackets -= numDropped;
+        _numCollectedBytes -= _datagramBatcher.getNumDroppedBytes();
+        _datagramBatcher.resetDroppedStats();
+
+        _datagramBatchThread.store(NULL);
+    }
+    return numDropped;
+}
+
 qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram,
                                       const SharedNodePointer& destinationNode,
                                       const HifiSockAddr& overridenSockAddr) {
+    return writeDatagram(datagram.constData(), datagram.size(), destinationNode, overridenSockAddr);
+}
+
+qint64 LimitedNodeList::writeDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
+                                      const HifiSockAddr& overridenSockAddr) {
     if (destinationNode) {
-        PacketType packetType = packetTypeForPacket(datagram);
+        PacketType packetType = packetTypeForPacket(data);
 
         if (NON_VERIFIED_PACKETS.contains(packetType)) {
-            return writeUnverifiedDatagram(datagram, destinationNode, overridenSockAddr);
+            return writeUnverifiedDatagram(QByteArray::fromRawData(data, size), destinationNode, overridenSockAddr);
         }
 
         // if we don't have an overridden address, assume they want to send to the node's active socket
@@ -270,8 +309,6 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram,
             }
         }
 
-        QByteArray datagramCopy = datagram;
-
         // if we're here and the connection secret is null, debug out - this could be a problem
         if (destinationNode->getConnectionSecret().isNull()) {
             qDebug() << "LimitedNodeList::writeDatagram called for verified datagram with null connection secret for"
@@ -279,17 +316,26 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram,
                 << "this packet to be unverifiable on the receiving side.";
         }
 
-        // perform replacement of hash and optionally also sequence number in the header
+        // the header is filled in on a copy on the stack so that sending doesn't need to allocate,
+        // only packets larger than we ever expect to send fall back to the heap
+        char stackDatagram[MAX_PACKET_SIZE];
+        QByteArray heapDatagram;
+        char* datagramCopy = stackDatagram;
+        if (size > MAX_PACKET_SIZE) {
+            heapDatagram.resize(size);
+            datagramCopy = heapDatagram.data();
+        }
+        memcpy(datagramCopy, data, size);
+
+        // perform replacement of sequence number and then the hash in the header
         if (SEQUENCE_NUMBERED_PACKETS.contains(packetType)) {
             PacketSequenceNumber sequenceNumber = getNextSequenceNumberForPacket(destinationNode->getUUID(), packetType);
-            replaceHashAndSequenceNumberInPacket(datagramCopy, destinationNode->getConnectionSecret(),
-                                                 sequenceNumber, packetType);
-        } else {
-            replaceHashInPacket(datagramCopy, destinationNode->getConnectionSecret(), packetType);
+            replaceSequenceNumberInPacket(datagramCopy, sequenceNumber, packetType);
         }
+        replaceHashInPacket(datagramCopy, size, destinationNode->getConnectionSecret(), packetType);
 
-        emit dataSent(destinationNode->getType(), datagram.size());
-        auto bytesWritten = writeDatagram(datagramCopy, *destinationSockAddr);
+        emit dataSent(destinationNode->getType(), size);
+        auto bytesWritten = writeDatagram(datagramCopy, size, *destinationSockAddr);
         // Keep track of per-destination-node bandwidth
         destinationNode->recordBytesSent(bytesWritten);
         return bytesWritten;
@@ -339,11 +385,6 @@ qint64 LimitedNodeList::writeUnverifiedDatagram(const QByteArray& datagram, cons
     return writeDatagram(datagram, destinationSockAddr);
 }
 
-qint64 LimitedNodeList::writeDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
-                               const HifiSockAddr& overridenSockAddr) {
-    return writeDatagram(QByteArray(data, size), destinationNode, overridenSockAddr);
-}
-
 qint64 LimitedNodeList::writeUnverifiedDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
                                const HifiSockAddr& overridenSockAddr) {
     return writeUnverifiedDatagram(QByteArray(data, size), destinationNode, overridenSockAddr);
@@ -21,12 +21,14 @@
 #include <unistd.h> // not on windows, not needed for mac or windows
 #endif
 
+#include <QtCore/QAtomicPointer>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QPointer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QSet>
 #include <QtCore/QSharedMemory>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThread>
 #include <QtNetwork/QUdpSocket>
 #include <QtNetwork/QHostAddress>
 
@@ -34,6 +36,7 @@
 
 #include <DependencyManager.h>
 
+#include "DatagramBatcher.h"
 #include "DomainHandler.h"
 #include "Node.h"
 #include "PacketHeaders.h"
@@ -141,6 +144,12 @@ public:
     qint64 writeUnverifiedDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
                          const HifiSockAddr& overridenSockAddr = HifiSockAddr());
 
+    /// until sendDatagramBatch() is called, datagrams written from the calling thread are queued and then sent together
+    /// with a single system call, where the platform supports it. A queued datagram is reported as written in full,
+    /// sendDatagramBatch() returns how many of them the batch then failed to send, and takes them out of the packet stats.
+    void beginDatagramBatch();
+    int sendDatagramBatch();
+
     void (*linkedDataCreateCallback)(Node *);
 
     int size() const { return _nodeHash.size(); }
@@ -265,6 +274,7 @@ protected:
     void operator=(LimitedNodeList const&); // Don't implement, needed to avoid copies of singleton
 
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& destinationSockAddr);
+    qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& destinationSockAddr);
 
     PacketSequenceNumber getNextSequenceNumberForPacket(const QUuid& nodeUUID, PacketType packetType);
 
@@ -281,6 +291,8 @@ protected:
     NodeHash _nodeHash;
     QReadWriteLock _nodeMutex;
     QUdpSocket _nodeSocket;
+    DatagramBatcher _datagramBatcher;
+    QAtomicPointer<QThread> _datagramBatchThread;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
     HifiSockAddr _publicSockAddr;
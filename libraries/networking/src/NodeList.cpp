@@ -558,6 +558,15 @@ int NodeList::processDomainServerList(const QByteArray& packet) {
     packetStream >> thisNodeCanRez;
     setThisNodeCanRez(thisNodeCanRez);
 
+    // hash verified packets the way the rest of the domain does
+    quint8 packetAuthenticationMode;
+    packetStream >> packetAuthenticationMode;
+    if (packetAuthenticationMode == PacketAuthenticationSipHash) {
+        setPacketAuthenticationMode(PacketAuthenticationSipHash);
+    } else {
+        setPacketAuthenticationMode(PacketAuthenticationMD5);
+    }
+
     // pull each node in the packet
     while (packetStream.device()->pos() < packet.size()) {
         parseNodeFromPacketStream(packetStream);
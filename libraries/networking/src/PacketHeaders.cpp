@@ -11,9 +11,28 @@
 
 #include "PacketHeaders.h"
 
+#include <algorithm>
+#include <atomic>
 #include <math.h>
 
 #include <QtCore/QDebug>
+#include <QtCore/QtEndian>
+
+#include <SipHash.h>
+
+static_assert(SIPHASH_128_BYTES == NUM_BYTES_MD5_HASH, "packet hashes must fill the hash in the packet header");
+
+// MD5 until the domain-server says otherwise in the domain list, it is set from the node list thread
+// and read by every thread that sends or receives verified packets
+static std::atomic<PacketAuthenticationMode> packetAuthenticationMode(PacketAuthenticationMD5);
+
+void setPacketAuthenticationMode(PacketAuthenticationMode mode) {
+    packetAuthenticationMode.store(mode, std::memory_order_relaxed);
+}
+
+PacketAuthenticationMode getPacketAuthenticationMode() {
+    return packetAuthenticationMode.load(std::memory_order_relaxed);
+}
 
 int arithmeticCodingValueFromBuffer(const char* checkValue) {
     if (((uchar) *checkValue) < 255) {
@@ -55,14 +74,15 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketTypeInjectAudio:
             return 1;
         case PacketTypeAvatarData:
-            return 6;
+        case PacketTypeBulkAvatarData:
+            return 7;
         case PacketTypeAvatarIdentity:
             return 1;
         case PacketTypeEnvironmentData:
             return 2;
         case PacketTypeDomainList:
         case PacketTypeDomainListRequest:
-            return 5;
+            return 6;
         case PacketTypeCreateAssignment:
         case PacketTypeRequestAssignment:
             return 2;
@@ -231,8 +251,43 @@ QByteArray hashFromPacketHeader(const QByteArray& packet) {
 }
 
 QByteArray hashForPacketAndConnectionUUID(const QByteArray& packet, const QUuid& connectionUUID) {
-    return QCryptographicHash::hash(packet.mid(numBytesForPacketHeader(packet)) + connectionUUID.toRfc4122(),
-                                    QCryptographicHash::Md5);
+    QByteArray hash(NUM_BYTES_MD5_HASH, 0);
+    hashForPacketAndConnectionUUID(packet.constData(), packet.size(), connectionUUID, hash.data());
+    return hash;
+}
+
+void hashForPacketAndConnectionUUID(const char* packet, int packetSize, const QUuid& connectionUUID, char* hash) {
+    int numHeaderBytes = numBytesForPacketHeader(packet);
+    const char* payload = packet + numHeaderBytes;
+    int payloadSize = std::max(packetSize - numHeaderBytes, 0);
+
+    // the same bytes as connectionUUID.toRfc4122() without allocating them
+    unsigned char secret[NUM_BYTES_RFC4122_UUID];
+    qToBigEndian(connectionUUID.data1, secret);
+    qToBigEndian(connectionUUID.data2, secret + 4);
+    qToBigEndian(connectionUUID.data3, secret + 6);
+    memcpy(secret + 8, connectionUUID.data4, sizeof(connectionUUID.data4));
+
+    if (getPacketAuthenticationMode() == PacketAuthenticationSipHash) {
+        sipHash128(secret, reinterpret_cast<const unsigned char*>(payload), payloadSize,
+                   reinterpret_cast<unsigned char*>(hash));
+    } else {
+        QCryptographicHash md5(QCryptographicHash::Md5);
+        md5.addData(payload, payloadSize);
+        md5.addData(reinterpret_cast<const char*>(secret), NUM_BYTES_RFC4122_UUID);
+        memcpy(hash, md5.result().constData(), NUM_BYTES_MD5_HASH);
+    }
+}
+
+bool packetHashMatches(const QByteArray& packet, const QUuid& connectionUUID) {
+    PacketType packetType = packetTypeForPacket(packet);
+    if (packet.size() < numBytesForPacketHeaderGivenPacketType(packetType)) {
+        return false;
+    }
+
+    char hash[NUM_BYTES_MD5_HASH];
+    hashForPacketAndConnectionUUID(packet.constData(), packet.size(), connectionUUID, hash);
+    return memcmp(packet.constData() + hashOffsetForPacketType(packetType), hash, NUM_BYTES_MD5_HASH) == 0;
 }
 
 PacketSequenceNumber sequenceNumberFromHeader(const QByteArray& packet, PacketType packetType) {
@@ -254,8 +309,15 @@ void replaceHashInPacket(QByteArray& packet, const QUuid& connectionUUID, Packet
         packetType = packetTypeForPacket(packet);
     }
 
-    packet.replace(hashOffsetForPacketType(packetType), NUM_BYTES_MD5_HASH,
-                   hashForPacketAndConnectionUUID(packet, connectionUUID));
+    replaceHashInPacket(packet.data(), packet.size(), connectionUUID, packetType);
+}
+
+void replaceHashInPacket(char* packet, int packetSize, const QUuid& connectionUUID, PacketType packetType) {
+    if (packetType == PacketTypeUnknown) {
+        packetType = packetTypeForPacket(packet);
+    }
+
+    hashForPacketAndConnectionUUID(packet, packetSize, connectionUUID, packet + hashOffsetForPacketType(packetType));
 }
 
 void replaceSequenceNumberInPacket(QByteArray& packet, PacketSequenceNumber sequenceNumber, PacketType packetType) {
@@ -267,6 +329,14 @@ void replaceSequenceNumberInPacket(QByteArray& packet, PacketSequenceNumber sequ
                    sizeof(PacketSequenceNumber), reinterpret_cast<char*>(&sequenceNumber), sizeof(PacketSequenceNumber));
 }
 
+void replaceSequenceNumberInPacket(char* packet, PacketSequenceNumber sequenceNumber, PacketType packetType) {
+    if (packetType == PacketTypeUnknown) {
+        packetType = packetTypeForPacket(packet);
+    }
+
+    memcpy(packet + sequenceNumberOffsetForPacketType(packetType), &sequenceNumber, sizeof(PacketSequenceNumber));
+}
+
 void replaceHashAndSequenceNumberInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketSequenceNumber sequenceNumber,
                                           PacketType packetType) {
     if (packetType == PacketTypeUnknown) {
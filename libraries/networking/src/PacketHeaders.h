@@ -104,6 +104,16 @@ const QSet<PacketType> NON_VERIFIED_PACKETS = QSet<PacketType>()
 const QSet<PacketType> SEQUENCE_NUMBERED_PACKETS = QSet<PacketType>()
 << PacketTypeAvatarData;
 
+// how the hash in the header of verified packets is computed from their payload and the connection secret,
+// both ends of a connection must use the same mode, so the domain-server picks it and sends it in the domain list
+enum PacketAuthenticationMode {
+    PacketAuthenticationMD5, // MD5 of the payload followed by the connection secret
+    PacketAuthenticationSipHash // 128 bit SipHash-2-4 of the payload, keyed by the connection secret
+};
+
+void setPacketAuthenticationMode(PacketAuthenticationMode mode);
+PacketAuthenticationMode getPacketAuthenticationMode();
+
 const int NUM_BYTES_MD5_HASH = 16;
 const int NUM_STATIC_HEADER_BYTES = sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
 const int MAX_PACKET_HEADER_BYTES = sizeof(PacketType) + NUM_BYTES_MD5_HASH + NUM_STATIC_HEADER_BYTES;
@@ -136,15 +146,25 @@ int sequenceNumberOffsetForPacketType(PacketType packetType);
 QByteArray hashFromPacketHeader(const QByteArray& packet);
 QByteArray hashForPacketAndConnectionUUID(const QByteArray& packet, const QUuid& connectionUUID);
 
+/// computes the hash of the packet in place, writing NUM_BYTES_MD5_HASH bytes to hash
+void hashForPacketAndConnectionUUID(const char* packet, int packetSize, const QUuid& connectionUUID, char* hash);
+
+/// returns true if the hash in the header of the packet matches the one expected for the connection secret
+bool packetHashMatches(const QByteArray& packet, const QUuid& connectionUUID);
+
 // NOTE: The following four methods accept a PacketType which defaults to PacketTypeUnknown.
 // If the caller has already looked at the packet type and can provide it then the methods below won't have to look it up.
 
 PacketSequenceNumber sequenceNumberFromHeader(const QByteArray& packet, PacketType packetType = PacketTypeUnknown);
 
 void replaceHashInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketType packetType = PacketTypeUnknown);
+void replaceHashInPacket(char* packet, int packetSize, const QUuid& connectionUUID,
+                         PacketType packetType = PacketTypeUnknown);
 
 void replaceSequenceNumberInPacket(QByteArray& packet, PacketSequenceNumber sequenceNumber,
                                    PacketType packetType = PacketTypeUnknown);
+void replaceSequenceNumberInPacket(char* packet, PacketSequenceNumber sequenceNumber,
+                                   PacketType packetType = PacketTypeUnknown);
 
 void replaceHashAndSequenceNumberInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketSequenceNumber sequenceNumber,
                                           PacketType packetType = PacketTypeUnknown);
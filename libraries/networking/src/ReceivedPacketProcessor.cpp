@@ -9,54 +9,135 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cstring>
+
 #include "NodeList.h"
 #include "ReceivedPacketProcessor.h"
 #include "SharedUtil.h"
 
+ReceivedPacketProcessor::ReceivedPacketProcessor(int capacity) :
+    _packets(capacity),
+    _numOverflowPackets(0),
+    _isWaitingForPackets(false)
+{
+}
+
 void ReceivedPacketProcessor::terminating() {
+    // take the wait mutex so that we can't slip in between process() checking isStillRunning() and going to sleep
+    _waitingOnPacketsMutex.lock();
     _hasPackets.wakeAll();
+    _waitingOnPacketsMutex.unlock();
+}
+
+ReceivedPacketProcessor::PacketCountPointer ReceivedPacketProcessor::packetCountForNode(const QUuid& nodeUUID) {
+    {
+        QReadLocker readLocker(&_nodePacketCountsLock);
+        QHash<QUuid, PacketCountPointer>::const_iterator it = _nodePacketCounts.constFind(nodeUUID);
+        if (it != _nodePacketCounts.constEnd()) {
+            return it.value();
+        }
+    }
+
+    // first packet from this node, another thread may have beaten us to adding it
+    QWriteLocker writeLocker(&_nodePacketCountsLock);
+    PacketCountPointer& nodePacketCount = _nodePacketCounts[nodeUUID];
+    if (!nodePacketCount) {
+        nodePacketCount = PacketCountPointer(new QAtomicInt(0));
+    }
+    return nodePacketCount;
 }
 
 void ReceivedPacketProcessor::queueReceivedPacket(const SharedNodePointer& sendingNode, const QByteArray& packet) {
     // Make sure our Node and NodeList knows we've heard from this node.
     sendingNode->setLastHeardMicrostamp(usecTimestampNow());
 
-    NetworkPacket networkPacket(sendingNode, packet);
-    lock();
-    _packets.push_back(networkPacket);
-    _nodePacketCounts[sendingNode->getUUID()]++;
-    unlock();
-    
-    // Make sure to wake our actual processing thread because we now have packets for it to process.
-    _hasPackets.wakeAll();
+    PacketCountPointer nodePacketCount = packetCountForNode(sendingNode->getUUID());
+    nodePacketCount->ref();
+
+    // once anything has spilled over we keep spilling until the processing thread catches up, so that packets from
+    // any one thread stay in order
+    bool wasQueued = _numOverflowPackets.load() == 0 && _packets.push([&](QueuedPacket& queuedPacket) {
+        queuedPacket.node = sendingNode;
+        queuedPacket.nodePacketCount = nodePacketCount;
+
+        // copy into the slot's buffer instead of sharing the caller's, which is usually reused for the next read
+        if (queuedPacket.packet.capacity() < MAX_PACKET_SIZE) {
+            queuedPacket.packet.reserve(MAX_PACKET_SIZE);
+        }
+        queuedPacket.packet.resize(packet.size());
+        memcpy(queuedPacket.packet.data(), packet.constData(), packet.size());
+    });
+
+    if (!wasQueued) {
+        QueuedPacket queuedPacket;
+        queuedPacket.node = sendingNode;
+        queuedPacket.packet = packet;
+        queuedPacket.nodePacketCount = nodePacketCount;
+
+        lock();
+        _overflowPackets.push_back(queuedPacket);
+        ++_numOverflowPackets;
+        unlock();
+    }
+
+    // Make sure to wake our actual processing thread if it is waiting for packets to process.
+    if (_isWaitingForPackets.load()) {
+        _waitingOnPacketsMutex.lock();
+        _hasPackets.wakeAll();
+        _waitingOnPacketsMutex.unlock();
+    }
+}
+
+void ReceivedPacketProcessor::processQueuedPacket(QueuedPacket& queuedPacket) {
+    processPacket(queuedPacket.node, queuedPacket.packet);
+    queuedPacket.nodePacketCount->deref();
+
+    // don't hold on to the node until this slot comes around again
+    queuedPacket.node.clear();
+    queuedPacket.nodePacketCount.clear();
+
+    midProcess();
 }
 
 bool ReceivedPacketProcessor::process() {
 
-    if (_packets.size() == 0) {
+    if (!hasPacketsToProcess()) {
+        // queueReceivedPacket() checks _isWaitingForPackets after queueing, we check for packets after setting it,
+        // so one of us is guaranteed to see the other
         _waitingOnPacketsMutex.lock();
-        _hasPackets.wait(&_waitingOnPacketsMutex, getMaxWait());
+        _isWaitingForPackets.store(true);
+        if (!hasPacketsToProcess() && isStillRunning()) {
+            _hasPackets.wait(&_waitingOnPacketsMutex, getMaxWait());
+        }
+        _isWaitingForPackets.store(false);
         _waitingOnPacketsMutex.unlock();
     }
     preProcess();
-    while (_packets.size() > 0) {
-        lock(); // lock to make sure nothing changes on us
-        NetworkPacket& packet = _packets.front(); // get the oldest packet
-        NetworkPacket temporary = packet; // make a copy of the packet in case the vector is resized on us
-        _packets.erase(_packets.begin()); // remove the oldest packet
-        if (!temporary.getNode().isNull()) {
-            _nodePacketCounts[temporary.getNode()->getUUID()]--;
+    while (true) {
+        if (_packets.pop([this](QueuedPacket& queuedPacket) { processQueuedPacket(queuedPacket); })) {
+            continue;
+        }
+
+        if (_numOverflowPackets.load() == 0) {
+            break;
+        }
+
+        // the ring is drained, everything that spilled over is next in line
+        QVector<QueuedPacket> overflowPackets;
+        lock();
+        overflowPackets.swap(_overflowPackets);
+        _numOverflowPackets.store(0);
+        unlock();
+
+        for (int i = 0; i < overflowPackets.size(); i++) {
+            processQueuedPacket(overflowPackets[i]);
         }
-        unlock(); // let others add to the packets
-        processPacket(temporary.getNode(), temporary.getByteArray()); // process our temporary copy
-        midProcess();
     }
     postProcess();
     return isStillRunning();  // keep running till they terminate us
 }
 
 void ReceivedPacketProcessor::nodeKilled(SharedNodePointer node) {
-    lock();
+    QWriteLocker writeLocker(&_nodePacketCountsLock);
     _nodePacketCounts.remove(node->getUUID());
-    unlock();
 }
@@ -12,25 +12,36 @@
 #ifndef hifi_ReceivedPacketProcessor_h
 #define hifi_ReceivedPacketProcessor_h
 
+#include <atomic>
+
+#include <QAtomicInt>
+#include <QReadWriteLock>
+#include <QSharedPointer>
 #include <QWaitCondition>
 
+#include <MPSCRingBuffer.h>
+
 #include "GenericThread.h"
-#include "NetworkPacket.h"
+#include "NodeList.h"
+
+const int DEFAULT_RECEIVED_PACKET_CAPACITY = 1024;
 
 /// Generalized threaded processor for handling received inbound packets. 
 class ReceivedPacketProcessor : public GenericThread {
     Q_OBJECT
 public:
-    ReceivedPacketProcessor() { }
+    /// \param int capacity how many packets can wait without locking, any more are still queued but behind a lock
+    ReceivedPacketProcessor(int capacity = DEFAULT_RECEIVED_PACKET_CAPACITY);
 
-    /// Add packet from network receive thread to the processing queue.
+    /// Add packet from network receive thread to the processing queue. Safe to call from any number of threads.
     void queueReceivedPacket(const SharedNodePointer& sendingNode, const QByteArray& packet);
 
     /// Are there received packets waiting to be processed
-    bool hasPacketsToProcess() const { return _packets.size() > 0; }
+    bool hasPacketsToProcess() const { return packetsToProcessCount() > 0; }
 
     /// Is a specified node still alive?
     bool isAlive(const QUuid& nodeUUID) const {
+        QReadLocker readLocker(&_nodePacketCountsLock);
         return _nodePacketCounts.contains(nodeUUID);
     }
 
@@ -41,11 +52,13 @@ public:
 
     /// Are there received packets waiting to be processed from a specified node
     bool hasPacketsToProcessFrom(const QUuid& nodeUUID) const {
-        return _nodePacketCounts[nodeUUID] > 0;
+        QReadLocker readLocker(&_nodePacketCountsLock);
+        PacketCountPointer nodePacketCount = _nodePacketCounts.value(nodeUUID);
+        return nodePacketCount && nodePacketCount->load() > 0;
     }
 
     /// How many received packets waiting are to be processed
-    int packetsToProcessCount() const { return _packets.size(); }
+    int packetsToProcessCount() const { return _packets.size() + _numOverflowPackets.load(); }
 
     virtual void terminating();
 
@@ -74,12 +87,32 @@ protected:
     virtual void postProcess() { }
 
 protected:
+    typedef QSharedPointer<QAtomicInt> PacketCountPointer;
+
+    /// A packet waiting in the ring. The packet bytes are copied into the slot's own buffer, which is kept from one lap
+    /// of the ring to the next so that queueing doesn't allocate once every slot has been used.
+    struct QueuedPacket {
+        SharedNodePointer node;
+        QByteArray packet;
+        PacketCountPointer nodePacketCount;
+    };
+
+    PacketCountPointer packetCountForNode(const QUuid& nodeUUID);
+    void processQueuedPacket(QueuedPacket& queuedPacket);
+
+    MPSCRingBuffer<QueuedPacket> _packets;
+
+    // packets that arrive while the ring is full wait here, under the GenericThread lock, until the ring is drained
+    QVector<QueuedPacket> _overflowPackets;
+    std::atomic<int> _numOverflowPackets;
 
-    QVector<NetworkPacket> _packets;
-    QHash<QUuid, int> _nodePacketCounts;
+    // the counts themselves are atomic, the lock only guards the hash against nodes being added and killed
+    QHash<QUuid, PacketCountPointer> _nodePacketCounts;
+    mutable QReadWriteLock _nodePacketCountsLock;
 
     QWaitCondition _hasPackets;
     QMutex _waitingOnPacketsMutex;
+    std::atomic<bool> _isWaitingForPackets;
 };
 
 #endif // hifi_ReceivedPacketProcessor_h
@@ -134,42 +134,64 @@ void ResourceCache::reserveUnusedResource(qint64 resourceSize) {
     }
 }
 
+void ResourceCache::setHostRequestLimit(int limit) {
+    DependencyManager::get<ResourceCacheSharedItems>()->_scheduler.setHostRequestLimit(limit);
+}
+
+void ResourceCache::setTypeRequestLimit(const QString& cacheClassName, int limit) {
+    DependencyManager::get<ResourceCacheSharedItems>()->_scheduler.setTypeRequestLimit(cacheClassName, limit);
+}
+
+void ResourceCache::setTypeWeight(const QString& cacheClassName, float weight) {
+    DependencyManager::get<ResourceCacheSharedItems>()->_scheduler.setTypeWeight(cacheClassName, weight);
+}
+
+static ResourceRequestScheduler::Key getRequestKey(Resource* resource) {
+    return reinterpret_cast<ResourceRequestScheduler::Key>(resource);
+}
+
 void ResourceCache::attemptRequest(Resource* resource) {
-    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
-    if (_requestLimit <= 0) {
-        // wait until a slot becomes available
-        sharedItems->_pendingRequests.append(resource);
-        return;
-    }
-    _requestLimit--;
-    sharedItems->_loadingRequests.append(resource);
-    resource->makeRequest();
+    // resources are scheduled by the cache they belong to, so that each kind gets its share of the bandwidth
+    QString type = resource->_cache ? resource->_cache->metaObject()->className() : resource->metaObject()->className();
+    DependencyManager::get<ResourceCacheSharedItems>()->_scheduler.addPending(getRequestKey(resource),
+        resource->_request.url().host(), type, resource->getLoadPriority());
+    startPendingRequests();
 }
 
 void ResourceCache::requestCompleted(Resource* resource) {
-    
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
     sharedItems->_loadingRequests.removeOne(resource);
+    sharedItems->_scheduler.completed(getRequestKey(resource), resource->getBytesReceived());
     _requestLimit++;
     
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    for (int i = 0; i < sharedItems->_pendingRequests.size(); ) {
-        Resource* resource = sharedItems->_pendingRequests.at(i).data();
-        if (!resource) {
-            sharedItems->_pendingRequests.removeAt(i);
-            continue;
-        }
-        float priority = resource->getLoadPriority();
-        if (priority >= highestPriority) {
-            highestPriority = priority;
-            highestIndex = i;
-        }
-        i++;
+    startPendingRequests();
+}
+
+void ResourceCache::updatePendingRequest(Resource* resource) {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    if (sharedItems->_scheduler.isPending(getRequestKey(resource))) {
+        sharedItems->_scheduler.updatePriority(getRequestKey(resource), resource->getLoadPriority());
+    }
+}
+
+void ResourceCache::cancelPendingRequest(Resource* resource) {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    if (sharedItems) {
+        sharedItems->_scheduler.removePending(getRequestKey(resource));
     }
-    if (highestIndex >= 0) {
-        attemptRequest(sharedItems->_pendingRequests.takeAt(highestIndex));
+}
+
+void ResourceCache::startPendingRequests() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    
+    // priorities only drop without notice (when an owner goes away), which the scheduler checks for as it goes
+    ResourceRequestScheduler::Key key;
+    while (_requestLimit > 0 && sharedItems->_scheduler.takeNext(key, [](ResourceRequestScheduler::Key key) {
+                return reinterpret_cast<Resource*>(key)->getLoadPriority(); })) {
+        Resource* resource = reinterpret_cast<Resource*>(key);
+        _requestLimit--;
+        sharedItems->_loadingRequests.append(resource);
+        resource->makeRequest();
     }
 }
 
@@ -185,9 +207,11 @@ Resource::Resource(const QUrl& url, bool delayLoad) :
     _request.setHeader(QNetworkRequest::UserAgentHeader, HIGH_FIDELITY_USER_AGENT);
     _request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
     
-    // start loading immediately unless instructed otherwise
-    if (!(_startedLoading || delayLoad)) {    
-        attemptRequest();
+    // start loading unless instructed otherwise, once the subclass is constructed and the owner has had the chance
+    // to set a load priority
+    if (!(_startedLoading || delayLoad)) {
+        _startedLoading = true;
+        QMetaObject::invokeMethod(this, "attemptRequest", Qt::QueuedConnection);
     }
 }
 
@@ -196,6 +220,8 @@ Resource::~Resource() {
         ResourceCache::requestCompleted(this);
         delete _reply;
         _reply = nullptr;
+    } else if (_startedLoading && !(_loaded || _failedToLoad)) {
+        ResourceCache::cancelPendingRequest(this);
     }
 }
 
@@ -208,6 +234,7 @@ void Resource::ensureLoading() {
 void Resource::setLoadPriority(const QPointer<QObject>& owner, float priority) {
     if (!(_failedToLoad || _loaded)) {
         _loadPriorities.insert(owner, priority);
+        ResourceCache::updatePendingRequest(this);
     }
 }
 
@@ -219,11 +246,13 @@ void Resource::setLoadPriorities(const QHash<QPointer<QObject>, float>& prioriti
             it != priorities.constEnd(); it++) {
         _loadPriorities.insert(it.key(), it.value());
     }
+    ResourceCache::updatePendingRequest(this);
 }
 
 void Resource::clearLoadPriority(const QPointer<QObject>& owner) {
     if (!(_failedToLoad || _loaded)) {
         _loadPriorities.remove(owner);
+        ResourceCache::updatePendingRequest(this);
     }
 }
 
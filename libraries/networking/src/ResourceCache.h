@@ -26,6 +26,8 @@
 
 #include <DependencyManager.h>
 
+#include "ResourceRequestScheduler.h"
+
 class QNetworkReply;
 class QTimer;
 
@@ -51,7 +53,7 @@ static const qint64 MAX_UNUSED_MAX_SIZE = 10 * BYTES_PER_GIGABYTES;
 class ResourceCacheSharedItems : public Dependency  {
     SINGLETON_DEPENDENCY
 public:
-    QList<QPointer<Resource> > _pendingRequests;
+    ResourceRequestScheduler _scheduler;
     QList<Resource*> _loadingRequests;
 private:
     ResourceCacheSharedItems() { }
@@ -66,6 +68,15 @@ class ResourceCache : public QObject {
 public:
     static void setRequestLimit(int limit) { _requestLimit = limit; }
     static int getRequestLimit() { return _requestLimit; }
+
+    /// Limits the requests made to any one host at once, zero for no limit.
+    static void setHostRequestLimit(int limit);
+
+    /// Limits the requests made at once for the resources of the named cache class, zero for no limit.
+    static void setTypeRequestLimit(const QString& cacheClassName, int limit);
+
+    /// Sets the share of the bandwidth given to the named cache class relative to the others (one by default).
+    static void setTypeWeight(const QString& cacheClassName, float weight);
     
     void setUnusedResourceCacheSize(qint64 unusedResourcesMaxSize);
     qint64 getUnusedResourceCacheSize() const { return _unusedResourcesMaxSize; }
@@ -74,7 +85,7 @@ public:
         { return DependencyManager::get<ResourceCacheSharedItems>()->_loadingRequests; }
 
     static int getPendingRequestCount() 
-        { return DependencyManager::get<ResourceCacheSharedItems>()->_pendingRequests.size(); }
+        { return DependencyManager::get<ResourceCacheSharedItems>()->_scheduler.getPendingCount(); }
 
     ResourceCache(QObject* parent = NULL);
     virtual ~ResourceCache();
@@ -106,6 +117,9 @@ protected:
     
     static void attemptRequest(Resource* resource);
     static void requestCompleted(Resource* resource);
+    static void updatePendingRequest(Resource* resource);
+    static void cancelPendingRequest(Resource* resource);
+    static void startPendingRequests();
 
 private:
     friend class Resource;
@@ -0,0 +1,208 @@
+//
+//  ResourceRequestScheduler.cpp
+//  libraries/networking/src
+//
+//  Created on 2015-06-20.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cfloat>
+
+#include "ResourceRequestScheduler.h"
+
+bool ResourceRequestScheduler::HeapEntry::isLower(const HeapEntry& first, const HeapEntry& second) {
+    if (first.priority != second.priority) {
+        return first.priority < second.priority;
+    }
+    return first.sequence > second.sequence;
+}
+
+void ResourceRequestScheduler::addPending(Key key, const QString& host, const QString& type, float priority) {
+    if (_pending.contains(key)) {
+        updatePriority(key, priority);
+        return;
+    }
+    Type& pendingType = _types[type];
+    if (pendingType.numPending == 0) {
+        // a type that had nothing waiting doesn't get to bank the share it didn't use
+        double minimumWeightedBytes = getMinimumPendingWeightedBytes();
+        if (minimumWeightedBytes != DBL_MAX) {
+            pendingType.weightedBytes = qMax(pendingType.weightedBytes, minimumWeightedBytes);
+        }
+    }
+    pendingType.numPending++;
+    _queues[qMakePair(host, type)].numPending++;
+    Pending& pending = _pending[key];
+    pending.host = host;
+    pending.type = type;
+    pending.priority = priority;
+    pending.sequence = _nextSequence++;
+    pending.generation = _nextGeneration++;
+    pushEntry(key, pending);
+}
+
+void ResourceRequestScheduler::updatePriority(Key key, float priority) {
+    QHash<Key, Pending>::iterator it = _pending.find(key);
+    if (it == _pending.end() || it->priority == priority) {
+        return;
+    }
+    // the old entry is left in the heap and skipped when it comes up
+    it->priority = priority;
+    it->generation = _nextGeneration++;
+    pushEntry(key, *it);
+}
+
+void ResourceRequestScheduler::removePending(Key key) {
+    QHash<Key, Pending>::iterator it = _pending.find(key);
+    if (it != _pending.end()) {
+        _types[it->type].numPending--;
+        QueueKey queueKey = qMakePair(it->host, it->type);
+        if (--_queues[queueKey].numPending == 0) {
+            _queues.remove(queueKey);
+        }
+        _pending.erase(it);
+    }
+}
+
+bool ResourceRequestScheduler::takeNext(Key& key, const PriorityFunction& getPriority) {
+    double minimumWeightedBytes = getMinimumPendingWeightedBytes();
+
+    // the best request of each host and type that may start, those of types that got ahead only if nothing else can
+    bool found = false;
+    HeapEntry best;
+    QueueKey bestQueue;
+    bool haveUnfairEntry = false;
+    HeapEntry unfairEntry;
+    QueueKey unfairQueue;
+    for (QHash<QueueKey, Queue>::iterator it = _queues.begin(); it != _queues.end(); it++) {
+        const Type& type = _types[it.key().second];
+        if ((_hostRequestLimit > 0 && _hostLoading.value(it.key().first) >= _hostRequestLimit) ||
+                (type.requestLimit > 0 && type.numLoading >= type.requestLimit)) {
+            continue;
+        }
+        HeapEntry top;
+        if (!findQueueTop(*it, getPriority, top)) {
+            continue;
+        }
+        if (type.weightedBytes - minimumWeightedBytes > _fairnessQuantum) {
+            if (!haveUnfairEntry || HeapEntry::isLower(unfairEntry, top)) {
+                unfairEntry = top;
+                unfairQueue = it.key();
+                haveUnfairEntry = true;
+            }
+        } else if (!found || HeapEntry::isLower(best, top)) {
+            best = top;
+            bestQueue = it.key();
+            found = true;
+        }
+    }
+    if (!found) {
+        if (!haveUnfairEntry) {
+            return false;
+        }
+        best = unfairEntry;
+        bestQueue = unfairQueue;
+    }
+
+    // findQueueTop() left the request on top of its heap
+    Queue& queue = _queues[bestQueue];
+    std::pop_heap(queue.heap.begin(), queue.heap.end(), HeapEntry::isLower);
+    queue.heap.pop_back();
+    if (--queue.numPending == 0) {
+        _queues.remove(bestQueue);
+    }
+
+    key = best.key;
+    Pending pending = _pending.take(key);
+    Type& type = _types[pending.type];
+    type.numPending--;
+    type.numLoading++;
+    _hostLoading[pending.host]++;
+    Loading& loading = _loading[key];
+    loading.host = pending.host;
+    loading.type = pending.type;
+    return true;
+}
+
+void ResourceRequestScheduler::completed(Key key, qint64 bytes) {
+    QHash<Key, Loading>::iterator it = _loading.find(key);
+    if (it == _loading.end()) {
+        return;
+    }
+    Type& type = _types[it->type];
+    type.numLoading--;
+    type.weightedBytes += qMax(bytes, (qint64)0) / (double)type.weight;
+    if (--_hostLoading[it->host] == 0) {
+        _hostLoading.remove(it->host);
+    }
+    _loading.erase(it);
+}
+
+void ResourceRequestScheduler::pushEntry(Key key, const Pending& pending) {
+    HeapEntry entry;
+    entry.priority = pending.priority;
+    entry.sequence = pending.sequence;
+    entry.generation = pending.generation;
+    entry.key = key;
+    Queue& queue = _queues[qMakePair(pending.host, pending.type)];
+    queue.heap.push_back(entry);
+    std::push_heap(queue.heap.begin(), queue.heap.end(), HeapEntry::isLower);
+    maybeCompactQueue(queue);
+}
+
+bool ResourceRequestScheduler::findQueueTop(Queue& queue, const PriorityFunction& getPriority, HeapEntry& top) {
+    while (!queue.heap.empty()) {
+        HeapEntry entry = queue.heap.front();
+        QHash<Key, Pending>::iterator it = _pending.find(entry.key);
+        bool isStale = (it == _pending.end() || it->generation != entry.generation);
+        float priority = entry.priority;
+        if (!isStale && getPriority) {
+            priority = getPriority(entry.key);
+        }
+        if (!isStale && priority >= entry.priority) {
+            top = entry; // left on top, takeNext() pops it if it is the one chosen
+            return true;
+        }
+        std::pop_heap(queue.heap.begin(), queue.heap.end(), HeapEntry::isLower);
+        queue.heap.pop_back();
+        if (!isStale) {
+            // the priority dropped since it was last set, so the request goes back in lower down
+            it->priority = priority;
+            it->generation = _nextGeneration++;
+            entry.priority = priority;
+            entry.generation = it->generation;
+            queue.heap.push_back(entry);
+            std::push_heap(queue.heap.begin(), queue.heap.end(), HeapEntry::isLower);
+        }
+    }
+    return false;
+}
+
+void ResourceRequestScheduler::maybeCompactQueue(Queue& queue) {
+    // drop the entries left behind by updates and removals once they outnumber the live ones
+    const size_t MIN_HEAP_SIZE_TO_COMPACT = 64;
+    if (queue.heap.size() <= MIN_HEAP_SIZE_TO_COMPACT || queue.heap.size() <= 2 * (size_t)queue.numPending) {
+        return;
+    }
+    std::vector<HeapEntry>::iterator liveEnd = std::remove_if(queue.heap.begin(), queue.heap.end(),
+        [this](const HeapEntry& entry) {
+            QHash<Key, Pending>::const_iterator it = _pending.constFind(entry.key);
+            return it == _pending.constEnd() || it->generation != entry.generation;
+        });
+    queue.heap.erase(liveEnd, queue.heap.end());
+    std::make_heap(queue.heap.begin(), queue.heap.end(), HeapEntry::isLower);
+}
+
+double ResourceRequestScheduler::getMinimumPendingWeightedBytes() const {
+    double minimumWeightedBytes = DBL_MAX;
+    for (QHash<QString, Type>::const_iterator it = _types.constBegin(); it != _types.constEnd(); it++) {
+        if (it->numPending > 0) {
+            minimumWeightedBytes = qMin(minimumWeightedBytes, it->weightedBytes);
+        }
+    }
+    return minimumWeightedBytes;
+}
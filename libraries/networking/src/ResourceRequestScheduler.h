@@ -0,0 +1,138 @@
+//
+//  ResourceRequestScheduler.h
+//  libraries/networking/src
+//
+//  Created on 2015-06-20.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceRequestScheduler_h
+#define hifi_ResourceRequestScheduler_h
+
+#include <functional>
+#include <vector>
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+
+const qint64 DEFAULT_FAIRNESS_QUANTUM = 1024 * 1024;
+
+/// Orders the resource requests waiting for a free request slot.
+///
+/// Pending requests are kept in one heap by load priority per host and type, which is updated in place when a priority
+/// is raised and checked again when a request reaches the top, since the priority of a resource drops silently when
+/// one of its owners goes away. A request is only started if its host and its type are under their request limits, so
+/// the heaps of a host or type at its limit are skipped as a whole and picking the next request only looks at the top
+/// of each heap.
+///
+/// Types are also served in byte-weighted fair shares: each type is charged the bytes of its completed requests,
+/// divided by its weight, and a type that is more than the fairness quantum ahead of another type with requests waiting
+/// is passed over for as long as something else can start. That keeps a flood of big textures from holding back the
+/// models and sounds of the same domain, without leaving a slot idle.
+class ResourceRequestScheduler {
+public:
+    typedef quintptr Key;
+    typedef std::function<float(Key)> PriorityFunction;
+
+    /// no more than this many requests to the same host at once, zero for no limit
+    void setHostRequestLimit(int limit) { _hostRequestLimit = limit; }
+    int getHostRequestLimit() const { return _hostRequestLimit; }
+
+    /// no more than this many requests of the type at once, zero for no limit
+    void setTypeRequestLimit(const QString& type, int limit) { _types[type].requestLimit = limit; }
+
+    /// the share of the bytes the type is given relative to other types, one by default
+    void setTypeWeight(const QString& type, float weight) { _types[type].weight = weight; }
+
+    /// how many weighted bytes a type can get ahead of another with requests waiting before it is passed over
+    void setFairnessQuantum(qint64 bytes) { _fairnessQuantum = bytes; }
+
+    /// Adds a request to wait for a slot, or updates its priority if it is already waiting.
+    void addPending(Key key, const QString& host, const QString& type, float priority);
+
+    /// Moves a waiting request to its new priority.
+    void updatePriority(Key key, float priority);
+
+    /// Drops a waiting request.
+    void removePending(Key key);
+
+    bool isPending(Key key) const { return _pending.contains(key); }
+    int getPendingCount() const { return _pending.size(); }
+    int getLoadingCount() const { return _loading.size(); }
+
+    /// Takes the waiting request to start in a free slot, returns false if none may start. The function, if any,
+    /// returns the current priority of a request.
+    bool takeNext(Key& key, const PriorityFunction& getPriority = PriorityFunction());
+
+    /// Frees the host and type of a request taken by takeNext() and charges its type for the bytes it transferred.
+    void completed(Key key, qint64 bytes);
+
+private:
+
+    class Pending {
+    public:
+        QString host;
+        QString type;
+        float priority;
+        quint64 sequence;
+        quint64 generation;
+    };
+
+    class Loading {
+    public:
+        QString host;
+        QString type;
+    };
+
+    class Type {
+    public:
+        int requestLimit = 0;
+        float weight = 1.0f;
+        int numLoading = 0;
+        int numPending = 0;
+        double weightedBytes = 0.0;
+    };
+
+    class HeapEntry {
+    public:
+        float priority;
+        quint64 sequence;
+        quint64 generation;
+        Key key;
+
+        /// the heap keeps the highest priority on top, then the earliest request
+        static bool isLower(const HeapEntry& first, const HeapEntry& second);
+    };
+
+    /// the requests waiting for one host and of one type
+    class Queue {
+    public:
+        int numPending = 0;
+        std::vector<HeapEntry> heap;
+    };
+    typedef QPair<QString, QString> QueueKey;
+
+    void pushEntry(Key key, const Pending& pending);
+    void maybeCompactQueue(Queue& queue);
+    bool findQueueTop(Queue& queue, const PriorityFunction& getPriority, HeapEntry& top);
+    double getMinimumPendingWeightedBytes() const;
+
+    QHash<Key, Pending> _pending;
+    QHash<Key, Loading> _loading;
+    QHash<QString, int> _hostLoading;
+    QHash<QString, Type> _types;
+    QHash<QueueKey, Queue> _queues;
+
+    int _hostRequestLimit = 0;
+    qint64 _fairnessQuantum = DEFAULT_FAIRNESS_QUANTUM;
+    quint64 _nextSequence = 0;
+
+    // drawn for every push, so that an entry left behind by a removed request never matches a later one of the same key
+    quint64 _nextGeneration = 0;
+};
+
+#endif // hifi_ResourceRequestScheduler_h
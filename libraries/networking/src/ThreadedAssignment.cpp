@@ -10,11 +10,14 @@
 //
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
 #include <QtCore/QJsonObject>
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
 #include <LogHandler.h>
+#include <PerfStat.h>
 
 #include "ThreadedAssignment.h"
 
@@ -79,6 +82,15 @@ void ThreadedAssignment::commonInit(const QString& targetName, NodeType_t nodeTy
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->setOwnerType(nodeType);
 
+    // when asked to, time this assignment and write a Chrome trace of it alongside its stats
+    const QString PERFORMANCE_TRACE_DIRECTORY_ENV = "HIFI_AC_PERFORMANCE_TRACE_DIR";
+    QString traceDirectory = QProcessEnvironment::systemEnvironment().value(PERFORMANCE_TRACE_DIRECTORY_ENV);
+    if (!traceDirectory.isEmpty()) {
+        _performanceTraceFilename = QDir(traceDirectory).filePath(QString("%1-%2.json").arg(targetName)
+                                                                   .arg(QCoreApplication::applicationPid()));
+        PerformanceTimer::setActive(true);
+    }
+
     // this is a temp fix for Qt 5.3 - rebinding the node socket gives us readyRead for the socket on this thread
     nodeList->rebindNodeSocket();
 
@@ -105,6 +117,27 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject &statsObje
     statsObject["packets_per_second"] = packetsPerSecond;
     statsObject["bytes_per_second"] = bytesPerSecond;
 
+    if (PerformanceTimer::isActive()) {
+        PerformanceTimer::tallyAllTimerRecords();
+
+        QJsonObject timersObject;
+        QMapIterator<QString, PerformanceTimerRecord> record(PerformanceTimer::getAllTimerRecords());
+        while (record.hasNext()) {
+            record.next();
+            timersObject[record.key()] = (double)record.value().getMovingAverage();
+        }
+        statsObject["performance_timer_usecs"] = timersObject;
+
+        // the trace holds the last hundred thousand scopes, no need to rewrite it every time we send stats
+        const quint64 PERFORMANCE_TRACE_WRITE_INTERVAL_USECS = 10 * USECS_PER_SECOND;
+        quint64 now = usecTimestampNow();
+        if (!_performanceTraceFilename.isEmpty()
+            && now - _lastPerformanceTraceWrite > PERFORMANCE_TRACE_WRITE_INTERVAL_USECS) {
+            PerformanceTimer::writeChromeTrace(_performanceTraceFilename);
+            _lastPerformanceTraceWrite = now;
+        }
+    }
+
     nodeList->sendStatsToDomainServer(statsObject);
 }
 
@@ -43,6 +43,8 @@ protected:
     QThread* _datagramProcessingThread;
     QTimer* _domainServerTimer = nullptr;
     QTimer* _statsTimer = nullptr;
+    QString _performanceTraceFilename;
+    quint64 _lastPerformanceTraceWrite = 0;
 
 private slots:
     void checkInWithDomainServerOrExit();
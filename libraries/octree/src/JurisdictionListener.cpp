@@ -17,6 +17,7 @@
 #include "JurisdictionListener.h"
 
 JurisdictionListener::JurisdictionListener(NodeType_t type) :
+    ReceivedPacketProcessor(JurisdictionListener::RECEIVED_PACKET_CAPACITY),
     _nodeType(type),
     _packetSender(JurisdictionListener::DEFAULT_PACKETS_PER_SECOND)
 {
@@ -28,6 +28,7 @@ class JurisdictionListener : public ReceivedPacketProcessor {
     Q_OBJECT
 public:
     static const int DEFAULT_PACKETS_PER_SECOND = 1;
+    static const int RECEIVED_PACKET_CAPACITY = 64; // jurisdiction traffic is light, keep the ring small
     static const int NO_SERVER_CHECK_RATE = 60; // if no servers yet detected, keep checking at 60fps
 
     JurisdictionListener(NodeType_t type = NodeType::EntityServer);
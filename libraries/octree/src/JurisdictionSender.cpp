@@ -18,7 +18,7 @@
 
 
 JurisdictionSender::JurisdictionSender(JurisdictionMap* map, NodeType_t type) :
-    ReceivedPacketProcessor(),
+    ReceivedPacketProcessor(JurisdictionSender::RECEIVED_PACKET_CAPACITY),
     _jurisdictionMap(map),
     _nodeType(type),
     _packetSender(JurisdictionSender::DEFAULT_PACKETS_PER_SECOND)
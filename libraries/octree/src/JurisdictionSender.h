@@ -26,6 +26,7 @@ class JurisdictionSender : public ReceivedPacketProcessor {
     Q_OBJECT
 public:
     static const int DEFAULT_PACKETS_PER_SECOND = 1;
+    static const int RECEIVED_PACKET_CAPACITY = 64; // jurisdiction traffic is light, keep the ring small
 
     JurisdictionSender(JurisdictionMap* map, NodeType_t type = NodeType::EntityServer);
     ~JurisdictionSender();
@@ -33,6 +33,7 @@
 #include <QString>
 
 #include <GeometryUtil.h>
+#include <JSONStreamReader.h>
 #include <LogHandler.h>
 #include <NetworkAccessManager.h>
 #include <OctalCode.h>
@@ -459,6 +460,88 @@ void Octree::readBitstreamToTree(const unsigned char * bitstream, unsigned long
     }
 }
 
+void Octree::readBitstreamChunksToTree(const QVector<BitstreamChunk>& chunks, ReadBitstreamToTreeParams& args) {
+    foreach (const BitstreamChunk& chunk, chunks) {
+        ReadBitstreamToTreeParams chunkArgs = args;
+        readBitstreamToTree(chunk.data, chunk.length, chunkArgs);
+    }
+}
+
+bool Octree::walkBitstream(const unsigned char* bitstream, unsigned long bufferSizeBytes,
+                           const ReadBitstreamToTreeParams& args,
+                           std::function<int(const unsigned char* data, int bytesLeftToRead, bool isRoot)> readElementData) const {
+    // this follows readBitstreamToTree() step for step, except that it leaves the tree alone
+    unsigned long bytesRead = 0;
+    while (bytesRead < bufferSizeBytes) {
+        const unsigned char* bitstreamAt = bitstream + bytesRead;
+        int numberOfThreeBitSectionsInStream = numberOfThreeBitSectionsInCode(bitstreamAt, bufferSizeBytes - bytesRead);
+        if (numberOfThreeBitSectionsInStream > UNREASONABLY_DEEP_RECURSION) {
+            qCDebug(octree) << "UNEXPECTED: parsing of the octal code would make UNREASONABLY_DEEP_RECURSION... "
+                        "numberOfThreeBitSectionsInStream:" << numberOfThreeBitSectionsInStream <<
+                        "This buffer is corrupt. Returning.";
+            return false;
+        }
+        if (numberOfThreeBitSectionsInStream == OVERFLOWED_OCTCODE_BUFFER) {
+            qCDebug(octree) << "UNEXPECTED: parsing of the octal code would overflow the buffer. "
+                        "This buffer is corrupt. Returning.";
+            return false;
+        }
+
+        int octalCodeBytes = bytesRequiredForCodeLength(numberOfThreeBitSectionsInStream);
+        int lowerLevelBytes = walkElementData(bitstreamAt + octalCodeBytes, bufferSizeBytes - (bytesRead + octalCodeBytes),
+                                              numberOfThreeBitSectionsInStream, args, readElementData);
+        bytesRead += octalCodeBytes + lowerLevelBytes;
+    }
+    return true;
+}
+
+int Octree::walkElementData(const unsigned char* nodeData, int bytesAvailable, int level,
+                            const ReadBitstreamToTreeParams& args,
+                            std::function<int(const unsigned char* data, int bytesLeftToRead, bool isRoot)>& readElementData) const {
+    int bytesLeftToRead = bytesAvailable;
+    int bytesRead = 0;
+
+    if ((size_t)bytesLeftToRead < sizeof(unsigned char) || level > DANGEROUSLY_DEEP_RECURSION) {
+        return bytesAvailable; // assume we read the entire buffer...
+    }
+
+    unsigned char colorInPacketMask = *nodeData;
+    bytesRead += sizeof(colorInPacketMask);
+    bytesLeftToRead -= sizeof(colorInPacketMask);
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        if (oneAtBit(colorInPacketMask, i)) {
+            int childElementDataRead = readElementData(nodeData + bytesRead, bytesLeftToRead, false);
+            bytesRead += childElementDataRead;
+            bytesLeftToRead -= childElementDataRead;
+        }
+    }
+
+    int bytesForMasks = args.includeExistsBits ? 2 * sizeof(unsigned char) : sizeof(unsigned char);
+    if (bytesLeftToRead < bytesForMasks) {
+        return bytesAvailable; // assume we read the entire buffer...
+    }
+    unsigned char childInBufferMask = *(nodeData + bytesRead + (args.includeExistsBits ? sizeof(unsigned char) : 0));
+    bytesRead += bytesForMasks;
+    bytesLeftToRead -= bytesForMasks;
+
+    for (int childIndex = 0; bytesLeftToRead > 0 && childIndex < NUMBER_OF_CHILDREN; childIndex++) {
+        if (oneAtBit(childInBufferMask, childIndex)) {
+            int lowerLevelBytes = walkElementData(nodeData + bytesRead, bytesLeftToRead, level + 1, args, readElementData);
+            bytesRead += lowerLevelBytes;
+            bytesLeftToRead -= lowerLevelBytes;
+        }
+    }
+
+    if (level == 0 && rootElementHasData() && bytesLeftToRead > 0) {
+        int rootDataSize = readElementData(nodeData + bytesRead, bytesLeftToRead, true);
+        bytesRead += rootDataSize;
+        bytesLeftToRead -= rootDataSize;
+    }
+
+    return bytesRead;
+}
+
 void Octree::deleteOctreeElementAt(float x, float y, float z, float s) {
     unsigned char* octalCode = pointToOctalCode(x,y,z,s);
     lockForWrite();
@@ -2014,6 +2097,49 @@ bool Octree::readSVOFromStream(unsigned long streamLength, QDataStream& inputStr
             unsigned long dataLength = streamLength - headerLength;
             unsigned long remainingLength = dataLength;
             const unsigned long MAX_CHUNK_LENGTH = MAX_OCTREE_PACKET_SIZE * 2;
+
+            // a local file is mapped and its chunks are handed over all at once, so that trees that can decode them
+            // on several threads get the chance to
+            QFile* file = qobject_cast<QFile*>(inputStream.device());
+            uchar* mappedData = file ? file->map(file->pos(), dataLength) : NULL;
+            if (mappedData) {
+                QVector<BitstreamChunk> chunks;
+                const unsigned char* dataAt = mappedData;
+                while (remainingLength > 0) {
+                    quint16 chunkLength = 0;
+                    if (remainingLength < sizeof(chunkLength)) {
+                        qCDebug(octree) << "UNEXPECTED trailing bytes after the last chunk:" << remainingLength;
+                        break;
+                    }
+                    memcpy(&chunkLength, dataAt, sizeof(chunkLength));
+                    dataAt += sizeof(chunkLength);
+                    remainingLength -= sizeof(chunkLength);
+
+                    if (chunkLength > remainingLength) {
+                        qCDebug(octree) << "UNEXPECTED chunk size of:" << chunkLength 
+                                    << "greater than remaining length:" << remainingLength;
+                        break;
+                    }
+
+                    if (chunkLength > MAX_CHUNK_LENGTH) {
+                        qCDebug(octree) << "UNEXPECTED chunk size of:" << chunkLength 
+                                    << "greater than MAX_CHUNK_LENGTH:" << MAX_CHUNK_LENGTH;
+                        break;
+                    }
+
+                    BitstreamChunk chunk = { dataAt, chunkLength };
+                    chunks.append(chunk);
+                    dataAt += chunkLength;
+                    remainingLength -= chunkLength;
+                }
+
+                ReadBitstreamToTreeParams args(WANT_COLOR, NO_EXISTS_BITS, NULL, 0, 
+                                                    SharedNodePointer(), wantImportProgress, gotVersion);
+                readBitstreamChunksToTree(chunks, args);
+                file->unmap(mappedData);
+                return fileOk;
+            }
+
             unsigned char* fileChunk = new unsigned char[MAX_CHUNK_LENGTH];
             
             while (remainingLength > 0) {
@@ -2056,15 +2182,41 @@ bool Octree::readSVOFromStream(unsigned long streamLength, QDataStream& inputStr
 }
 
 bool Octree::readJSONFromStream(unsigned long streamLength, QDataStream& inputStream) {
-    char* rawData = new char[streamLength + 1]; // allocate enough room to null terminate
-    inputStream.readRawData(rawData, streamLength);
-    rawData[streamLength] = 0; // make sure we null terminate this string
-
-    QJsonDocument asDocument = QJsonDocument::fromJson(rawData);
-    QVariant asVariant = asDocument.toVariant();
-    QVariantMap asMap = asVariant.toMap();
-    readFromMap(asMap);
-    delete[] rawData;
+    // the items are handed to readFromMap() a batch at a time as they are parsed, so that the document is never in
+    // memory whole
+    const int ITEMS_PER_BATCH = 256;
+    QVariantList items;
+    auto readItems = [&] {
+        QVariantMap itemDescription;
+        itemDescription["Entities"] = items;
+        items.clear();
+        readFromMap(itemDescription);
+    };
+
+    JSONStreamReader reader(*inputStream.device());
+    QString key;
+    QVariant item;
+    reader.beginObject();
+    while (reader.nextKey(key)) {
+        if (key == "Entities" && reader.beginArray()) {
+            while (reader.nextElement() && reader.readValue(item)) {
+                items.append(item);
+                if (items.size() == ITEMS_PER_BATCH) {
+                    readItems();
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+    if (!items.isEmpty()) {
+        readItems();
+    }
+
+    if (reader.hasError()) {
+        qCDebug(octree) << "ERROR reading JSON stream -" << reader.getError();
+        return false;
+    }
     return true;
 }
 
@@ -2085,7 +2237,6 @@ void Octree::writeToFile(const char* fileName, OctreeElement* element, QString p
 
 void Octree::writeToJSONFile(const char* fileName, OctreeElement* element) {
     QFile persistFile(fileName);
-    QVariantMap entityDescription;
 
     qCDebug(octree, "Saving JSON SVO to file %s...", fileName);
 
@@ -2096,18 +2247,34 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElement* element) {
         top = _rootElement;
     }
 
+    if (!persistFile.open(QIODevice::WriteOnly)) {
+        qCritical("Could not write to JSON description of entities.");
+        return;
+    }
+
+    // the items are written out as they are described, one per line, so that the whole description is never in memory
+    // at once. The document is the same one QJsonDocument would write, less the indentation.
+    persistFile.write("{\n\"Entities\": [\n");
+    bool isFirstItem = true;
+    QByteArray itemsJSON;
+    bool entityDescriptionSuccess = writeToVariants(top, true, [&](const QVariantList& items) {
+        itemsJSON.clear();
+        foreach (const QVariant& item, items) {
+            if (!isFirstItem) {
+                itemsJSON.append(",\n");
+            }
+            isFirstItem = false;
+            itemsJSON.append(QJsonDocument::fromVariant(item).toJson(QJsonDocument::Compact));
+        }
+        persistFile.write(itemsJSON);
+    });
+
     // include the "bitstream" version
     PacketType expectedType = expectedDataPacketType();
     PacketVersion expectedVersion = versionForPacketType(expectedType);
-    entityDescription["Version"] = (int) expectedVersion;
+    persistFile.write(QString("\n],\n\"Version\": %1\n}\n").arg((int)expectedVersion).toUtf8());
 
-    // store the entity data
-    bool entityDescriptionSuccess = writeToMap(entityDescription, top, true);
-
-    // convert the QVariantMap to JSON
-    if (entityDescriptionSuccess && persistFile.open(QIODevice::WriteOnly)) {
-        persistFile.write(QJsonDocument::fromVariant(entityDescription).toJson());
-    } else {
+    if (!entityDescriptionSuccess || persistFile.error() != QFile::NoError) {
         qCritical("Could not write to JSON description of entities.");
     }
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_Octree_h
 #define hifi_Octree_h
 
+#include <functional>
 #include <set>
 #include <SimpleMovingAverage.h>
 
@@ -28,6 +29,7 @@ class Shape;
 #include "ViewFrustum.h"
 #include "OctreeElement.h"
 #include "OctreeElementBag.h"
+#include "OctreeJournal.h"
 #include "OctreePacketData.h"
 #include "OctreeSceneStats.h"
 
@@ -214,6 +216,13 @@ public:
     {}
 };
 
+/// one of the buffer broken pieces of an SVO file, each is a self contained bitstream
+class BitstreamChunk {
+public:
+    const unsigned char* data;
+    unsigned long length;
+};
+
 class Octree : public QObject {
     Q_OBJECT
 public:
@@ -254,6 +263,16 @@ public:
 
     void processRemoveOctreeElementsBitstream(const unsigned char* bitstream, int bufferSizeBytes);
     void readBitstreamToTree(const unsigned char* bitstream,  unsigned long int bufferSizeBytes, ReadBitstreamToTreeParams& args);
+
+    /// reads the chunks of an SVO file in order, trees that can decode chunks away from the tree override this to
+    /// decode them on several threads
+    virtual void readBitstreamChunksToTree(const QVector<BitstreamChunk>& chunks, ReadBitstreamToTreeParams& args);
+
+    /// walks the elements encoded in a bitstream the way readBitstreamToTree() does, but without touching the tree.
+    /// readElementData is called on the data of each element, it returns the number of bytes it read. Safe to call
+    /// from any thread.
+    bool walkBitstream(const unsigned char* bitstream, unsigned long bufferSizeBytes, const ReadBitstreamToTreeParams& args,
+                       std::function<int(const unsigned char* data, int bytesLeftToRead, bool isRoot)> readElementData) const;
     void deleteOctalCodeFromTree(const unsigned char* codeBuffer, bool collapseEmptyTrees = DONT_COLLAPSE);
     void reaverageOctreeElements(OctreeElement* startElement = NULL);
 
@@ -332,6 +351,10 @@ public:
     void writeToJSONFile(const char* filename, OctreeElement* element = NULL);
     void writeToSVOFile(const char* filename, OctreeElement* element = NULL);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElement* element, bool skipDefaultValues) = 0;
+    /// the streaming counterpart of writeToMap(), hands the descriptions of the items under element to writeItems a
+    /// few at a time, only holding the read lock while describing each batch
+    virtual bool writeToVariants(OctreeElement* element, bool skipDefaultValues,
+                                 std::function<void(const QVariantList& items)> writeItems) = 0;
 
     // Octree importers
     bool readFromFile(const char* filename);
@@ -341,6 +364,15 @@ public:
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Incremental persistence, for trees that can record their changes in an OctreeJournal
+    virtual bool canJournal() const { return false; }
+    /// once enabled the tree remembers what changed so that writeJournal() can record it
+    virtual void setWantJournal(bool wantJournal) { }
+    /// appends a record for everything that changed since the last call, callers must hold at least a read lock
+    virtual void writeJournal(OctreeJournal& journal) { }
+    /// applies records read back from journals, in order, callers must hold the write lock
+    virtual void readJournal(const QVector<OctreeJournal::Record>& records) { }
+
     unsigned long getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -392,6 +424,8 @@ protected:
     OctreeElement* createMissingElement(OctreeElement* lastParentElement, const unsigned char* codeToReach, int recursionCount = 0);
     int readElementData(OctreeElement *destinationElement, const unsigned char* nodeData,
                 int bufferSizeBytes, ReadBitstreamToTreeParams& args);
+    int walkElementData(const unsigned char* nodeData, int bytesAvailable, int level, const ReadBitstreamToTreeParams& args,
+                        std::function<int(const unsigned char* data, int bytesLeftToRead, bool isRoot)>& readElementData) const;
 
     OctreeElement* _rootElement;
 
@@ -0,0 +1,165 @@
+//
+//  OctreeJournal.cpp
+//  libraries/octree/src
+//
+//  Created on 2015-06-13.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstring>
+
+#include <QDataStream>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "OctreeLogging.h"
+#include "OctreeJournal.h"
+
+static const char JOURNAL_SIGNATURE[] = { 'H', 'F', 'J', '1' };
+static const int JOURNAL_SIGNATURE_BYTES = sizeof(JOURNAL_SIGNATURE);
+static const int RECORD_HEADER_BYTES = sizeof(quint32) + sizeof(quint16);
+static const int UUID_BYTES = 16;
+
+OctreeJournal::OctreeJournal() :
+    _size(0),
+    _numRecords(0)
+{
+}
+
+OctreeJournal::~OctreeJournal() {
+    close();
+}
+
+bool OctreeJournal::open(const QString& filename) {
+    close();
+
+    _filename = filename;
+    _file.setFileName(filename);
+    if (!_file.open(QIODevice::ReadWrite | QIODevice::Append)) {
+        qCDebug(octree) << "ERROR opening journal" << filename << "-" << _file.errorString();
+        return false;
+    }
+
+    if (_file.size() == 0) {
+        _file.write(JOURNAL_SIGNATURE, JOURNAL_SIGNATURE_BYTES);
+    }
+    _size = 0;
+    _numRecords = 0;
+    return true;
+}
+
+void OctreeJournal::close() {
+    if (_file.isOpen()) {
+        sync();
+        _file.close();
+    }
+}
+
+void OctreeJournal::append(RecordType type, const QUuid& id, const QByteArray& data) {
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    QByteArray body;
+    body.reserve(sizeof(quint8) + UUID_BYTES + data.size());
+    body.append((char)type);
+    body.append(id.toRfc4122());
+    body.append(data);
+
+    QByteArray record;
+    QDataStream recordStream(&record, QIODevice::WriteOnly);
+    recordStream << (quint32)body.size() << qChecksum(body.constData(), body.size());
+    record.append(body);
+
+    if (_file.write(record) != record.size()) {
+        qCDebug(octree) << "ERROR appending to journal" << _filename << "-" << _file.errorString();
+        return;
+    }
+    _size += record.size();
+    _numRecords++;
+}
+
+bool OctreeJournal::sync() {
+    if (!_file.isOpen() || !_file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(_file.handle()) == 0;
+#else
+    return fsync(_file.handle()) == 0;
+#endif
+}
+
+bool OctreeJournal::roll() {
+    if (QFile::exists(getRolledFilename())) {
+        // the last rolled journal hasn't been removed, so the full save that should have covered it didn't happen.
+        // Keep appending to the current journal, it goes along with the rolled one until a save succeeds.
+        return true;
+    }
+
+    QString filename = _filename;
+    close();
+
+    if (!QFile::rename(filename, getRolledFilename())) {
+        qCDebug(octree) << "ERROR rolling journal" << filename << "to" << getRolledFilename();
+        open(filename);
+        return false;
+    }
+    return open(filename);
+}
+
+bool OctreeJournal::removeRolled() {
+    return !QFile::exists(getRolledFilename()) || QFile::remove(getRolledFilename());
+}
+
+bool OctreeJournal::readRecords(const QString& filename, QVector<Record>& records) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QByteArray contents = file.readAll();
+    if (contents.size() < JOURNAL_SIGNATURE_BYTES
+            || memcmp(contents.constData(), JOURNAL_SIGNATURE, JOURNAL_SIGNATURE_BYTES) != 0) {
+        qCDebug(octree) << "ERROR reading journal" << filename << "- not a journal file";
+        return false;
+    }
+
+    int offset = JOURNAL_SIGNATURE_BYTES;
+    while (offset < contents.size()) {
+        if (contents.size() - offset < RECORD_HEADER_BYTES) {
+            qCDebug(octree) << "Journal" << filename << "ends in a torn record header, ignoring it";
+            break;
+        }
+        QDataStream headerStream(contents.mid(offset, RECORD_HEADER_BYTES));
+        quint32 bodySize;
+        quint16 checksum;
+        headerStream >> bodySize >> checksum;
+        offset += RECORD_HEADER_BYTES;
+
+        if (bodySize < sizeof(quint8) + UUID_BYTES || bodySize > (quint32)(contents.size() - offset)) {
+            qCDebug(octree) << "Journal" << filename << "ends in a torn record, ignoring it";
+            break;
+        }
+        const char* body = contents.constData() + offset;
+        if (qChecksum(body, bodySize) != checksum) {
+            qCDebug(octree) << "Journal" << filename << "has a corrupt record, ignoring it and everything after it";
+            break;
+        }
+        offset += bodySize;
+
+        Record record;
+        record.type = (quint8)body[0];
+        record.id = QUuid::fromRfc4122(QByteArray::fromRawData(body + sizeof(quint8), UUID_BYTES));
+        record.data = QByteArray(body + sizeof(quint8) + UUID_BYTES, bodySize - sizeof(quint8) - UUID_BYTES);
+        records.append(record);
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+//
+//  OctreeJournal.h
+//  libraries/octree/src
+//
+//  Created on 2015-06-13.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Append only log of the changes made to an octree since its last full save
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournal_h
+#define hifi_OctreeJournal_h
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QUuid>
+#include <QVector>
+
+/// The journal holds one record per changed or deleted item, the latest record for an item wins when it is read back.
+/// Records are checksummed so that a record torn by a crash in the middle of a write ends the replay instead of
+/// corrupting it. OctreePersistThread appends to it on a short interval and folds it into a full save now and then.
+class OctreeJournal {
+public:
+    enum RecordType {
+        RECORD_CHANGED = 1, // data holds the complete current state of the item
+        RECORD_DELETED = 2  // data is empty
+    };
+
+    class Record {
+    public:
+        quint8 type;
+        QUuid id;
+        QByteArray data;
+    };
+
+    OctreeJournal();
+    ~OctreeJournal();
+
+    /// opens the journal for appending, creating it if needed
+    bool open(const QString& filename);
+    void close();
+    bool isOpen() const { return _file.isOpen(); }
+
+    void append(RecordType type, const QUuid& id, const QByteArray& data = QByteArray());
+
+    /// pushes everything appended so far to the disk, returns once the OS says it is there
+    bool sync();
+
+    /// bytes written to the journal since it was opened or last rolled
+    qint64 getSize() const { return _size; }
+    int getNumRecords() const { return _numRecords; }
+
+    /// moves the current journal aside to getRolledFilename() and starts an empty one. The rolled journal stays until
+    /// removeRolled() is called, which should be once the changes it holds are part of a full save. While it stays
+    /// rolling again does nothing, so no change is lost if that save fails.
+    bool roll();
+    bool removeRolled();
+
+    const QString& getFilename() const { return _filename; }
+    QString getRolledFilename() const { return _filename + ".rolled"; }
+
+    /// reads the records of a journal file, in the order they were appended. Returns false if the file can't be read,
+    /// a torn or corrupt record ends the read without failing it.
+    static bool readRecords(const QString& filename, QVector<Record>& records);
+
+private:
+    QString _filename;
+    QFile _file;
+    qint64 _size;
+    int _numRecords;
+};
+
+#endif // hifi_OctreeJournal_h
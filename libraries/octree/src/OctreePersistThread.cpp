@@ -30,10 +30,13 @@
 #include "OctreePersistThread.h"
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
+const int OctreePersistThread::DEFAULT_JOURNAL_INTERVAL = 1000; // every second
+const int OctreePersistThread::DEFAULT_COMPACT_INTERVAL = 1000 * 60 * 30; // every 30 minutes
+const qint64 OctreePersistThread::MAX_JOURNAL_BYTES = 64 * 1024 * 1024;
 
 OctreePersistThread::OctreePersistThread(Octree* tree, const QString& filename, int persistInterval, 
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
-                                         QString persistAsFileType) :
+                                         QString persistAsFileType, int journalInterval, int compactInterval) :
     _tree(tree),
     _filename(filename),
     _persistInterval(persistInterval),
@@ -43,7 +46,11 @@ OctreePersistThread::OctreePersistThread(Octree* tree, const QString& filename,
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _journalInterval(journalInterval),
+    _compactInterval(compactInterval),
+    _lastJournalSync(0),
+    _lastCompact(0)
 {
     parseSettings(settings);
 
@@ -126,6 +133,7 @@ bool OctreePersistThread::process() {
         qCDebug(octree) << "loading Octrees from file: " << _filename << "...";
 
         bool persistantFileRead;
+        bool journalReplayed = false;
 
         _tree->lockForWrite();
         {
@@ -150,6 +158,14 @@ bool OctreePersistThread::process() {
             }
 
             persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+
+            // replay any journals left behind even when we are no longer journaling, the save file alone is stale
+            if (_tree->canJournal()) {
+                journalReplayed = replayJournals();
+            }
+            if (wantJournal()) {
+                _tree->setWantJournal(true);
+            }
             _tree->pruneTree();
         }
         _tree->unlock();
@@ -160,6 +176,42 @@ bool OctreePersistThread::process() {
         _tree->clearDirtyBit(); // the tree is clean since we just loaded it
         qCDebug(octree, "DONE loading Octrees from file... fileRead=%s", debug::valueOf(persistantFileRead));
 
+        // fold the replayed journals into a full save, so that the journal files can go
+        QString journalFilename = _filename + ".journal";
+        bool journalsFolded = true;
+        if (journalReplayed) {
+            _tree->setDirtyBit();
+            journalsFolded = persist();
+            if (journalsFolded) {
+                QFile::remove(journalFilename + ".rolled");
+                QFile::remove(journalFilename);
+            } else {
+                qCDebug(octree) << "ERROR: unable to save replayed journal changes, keeping" << journalFilename;
+            }
+        }
+
+        if (wantJournal()) {
+            // start appending to an empty journal
+            bool journalStarted = journalsFolded;
+            if (journalStarted) {
+                QFile::remove(journalFilename + ".rolled");
+                QFile::remove(journalFilename);
+                journalStarted = _journal.open(journalFilename);
+            }
+
+            if (journalStarted) {
+                qCDebug(octree) << "Journaling Octree changes to:" << journalFilename;
+            } else {
+                qCDebug(octree) << "ERROR: unable to start journaling to" << journalFilename
+                    << "-- falling back to full saves every" << _persistInterval << "msecs";
+                _journal.close();
+                _tree->lockForWrite();
+                _tree->setWantJournal(false);
+                _tree->unlock();
+            }
+            _lastJournalSync = _lastCompact = usecTimestampNow();
+        }
+
         unsigned long nodeCount = OctreeElement::getNodeCount();
         unsigned long internalNodeCount = OctreeElement::getInternalNodeCount();
         unsigned long leafNodeCount = OctreeElement::getLeafNodeCount();
@@ -203,7 +255,18 @@ bool OctreePersistThread::process() {
         quint64 sinceLastSave = now - _lastCheck;
         quint64 intervalToCheck = _persistInterval * MSECS_TO_USECS;
 
-        if (sinceLastSave > intervalToCheck) {
+        if (_journal.isOpen()) {
+            if (now - _lastJournalSync > (quint64)_journalInterval * MSECS_TO_USECS) {
+                _lastJournalSync = now;
+                syncJournal();
+
+                if (_journal.getNumRecords() > 0 && (now - _lastCompact > (quint64)_compactInterval * MSECS_TO_USECS
+                                                     || _journal.getSize() > MAX_JOURNAL_BYTES)) {
+                    _lastCompact = now;
+                    compact();
+                }
+            }
+        } else if (sinceLastSave > intervalToCheck) {
             _lastCheck = now;
             persist();
         }
@@ -226,12 +289,19 @@ bool OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
-    persist();
+    if (_journal.isOpen()) {
+        // the journal already holds everything but the last few changes, no need for a full save
+        syncJournal();
+        _journal.close();
+    } else {
+        persist();
+    }
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
 }
 
-void OctreePersistThread::persist() {
+bool OctreePersistThread::persist() {
+    bool saved = false;
     if (_tree->isDirty()) {
         _tree->lockForWrite();
         {
@@ -255,6 +325,7 @@ void OctreePersistThread::persist() {
             _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
             time(&_lastPersistTime);
             _tree->clearDirtyBit(); // tree is clean after saving
+            saved = true;
             qCDebug(octree) << "DONE saving Octree to file...";
 
             lockFile.close();
@@ -263,6 +334,52 @@ void OctreePersistThread::persist() {
             qCDebug(octree) << "saving Octree lock file removed:" << lockFileName;
         }
     }
+    return saved;
+}
+
+bool OctreePersistThread::replayJournals() {
+    // the rolled journal is left behind when we stopped in the middle of a compaction, its changes came first
+    QString journalFilename = _filename + ".journal";
+    QStringList journalFilenames;
+    journalFilenames << journalFilename + ".rolled" << journalFilename;
+
+    bool replayed = false;
+    foreach (const QString& filename, journalFilenames) {
+        QVector<OctreeJournal::Record> records;
+        if (QFile::exists(filename) && OctreeJournal::readRecords(filename, records) && !records.isEmpty()) {
+            qCDebug(octree) << "Replaying" << records.size() << "journaled changes from:" << filename;
+            _tree->readJournal(records);
+            replayed = true;
+        }
+    }
+    return replayed;
+}
+
+void OctreePersistThread::syncJournal() {
+    _tree->lockForRead();
+    _tree->writeJournal(_journal);
+    _tree->unlock();
+
+    if (!_journal.sync()) {
+        qCDebug(octree) << "ERROR syncing journal:" << _journal.getFilename();
+    }
+}
+
+void OctreePersistThread::compact() {
+    PerformanceWarning warn(true, "Compacting Octree journal", true);
+
+    // what has been journaled so far moves to the rolled journal and is covered by the full save, anything that
+    // changes while we save goes to the new journal. Replaying those changes on top of the save is harmless since
+    // each record holds the complete state of what it changed.
+    syncJournal();
+    if (!_journal.roll()) {
+        return;
+    }
+
+    _tree->setDirtyBit();
+    if (persist()) {
+        _journal.removeRolled();
+    }
 }
 
 void OctreePersistThread::restoreFromMostRecentBackup() {
@@ -17,6 +17,7 @@
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeJournal.h"
 
 /// Generalized threaded processor for handling received inbound packets.
 class OctreePersistThread : public GenericThread {
@@ -32,10 +33,17 @@ public:
     };
 
     static const int DEFAULT_PERSIST_INTERVAL;
+    static const int DEFAULT_JOURNAL_INTERVAL;
+    static const int DEFAULT_COMPACT_INTERVAL;
+    static const qint64 MAX_JOURNAL_BYTES;
 
+    /// When journalInterval is non zero and the tree can journal, the changes to the tree are appended to a journal
+    /// every journalInterval msecs and the full save only happens every compactInterval msecs (or sooner if the journal
+    /// grows past MAX_JOURNAL_BYTES), instead of every persistInterval msecs.
     OctreePersistThread(Octree* tree, const QString& filename, int persistInterval = DEFAULT_PERSIST_INTERVAL, 
                         bool wantBackup = false, const QJsonObject& settings = QJsonObject(), 
-                        bool debugTimestampNow = false, QString persistAsFileType="svo");
+                        bool debugTimestampNow = false, QString persistAsFileType="svo",
+                        int journalInterval = 0, int compactInterval = DEFAULT_COMPACT_INTERVAL);
 
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
@@ -49,7 +57,11 @@ protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process();
     
-    void persist();
+    bool persist();
+    bool wantJournal() const { return _journalInterval > 0 && _tree->canJournal(); }
+    bool replayJournals();
+    void syncJournal();
+    void compact();
     void backup();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
@@ -74,6 +86,12 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    int _journalInterval;
+    int _compactInterval;
+    OctreeJournal _journal;
+    quint64 _lastJournalSync;
+    quint64 _lastCompact;
 };
 
 #endif // hifi_OctreePersistThread_h
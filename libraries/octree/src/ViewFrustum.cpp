@@ -360,6 +360,31 @@ ViewFrustum::location ViewFrustum::boxInFrustum(const AABox& box) const {
     return regularResult;
 }
 
+void ViewFrustum::boxesOutsidePlanes(int numBoxes, const float* cornerX, const float* cornerY, const float* cornerZ,
+                                     const float* scaleX, const float* scaleY, const float* scaleZ,
+                                     unsigned char* outside) const {
+    for (int i = 0; i < numBoxes; i++) {
+        outside[i] = 0;
+    }
+    // one plane at a time, so that the inner loop is the same straight arithmetic for every box. The vertex of each box
+    // furthest along the normal is picked with 0 or 1 multipliers instead of the branches of AABox::getVertexP(), which
+    // gives the same sums.
+    for (int plane = 0; plane < 6; plane++) {
+        const glm::vec3& normal = _planes[plane].getNormal();
+        float dCoefficient = _planes[plane].getDCoefficient();
+        float useScaleX = normal.x > 0.0f ? 1.0f : 0.0f;
+        float useScaleY = normal.y > 0.0f ? 1.0f : 0.0f;
+        float useScaleZ = normal.z > 0.0f ? 1.0f : 0.0f;
+        for (int i = 0; i < numBoxes; i++) {
+            float vertexX = cornerX[i] + scaleX[i] * useScaleX;
+            float vertexY = cornerY[i] + scaleY[i] * useScaleY;
+            float vertexZ = cornerZ[i] + scaleZ[i] * useScaleZ;
+            float distance = dCoefficient + (normal.x * vertexX + normal.y * vertexY + normal.z * vertexZ);
+            outside[i] |= (unsigned char)(distance < 0.0f);
+        }
+    }
+}
+
 bool testMatches(glm::quat lhs, glm::quat rhs, float epsilon = EPSILON) {
     return (fabs(lhs.x - rhs.x) <= epsilon && fabs(lhs.y - rhs.y) <= epsilon && fabs(lhs.z - rhs.z) <= epsilon
             && fabs(lhs.w - rhs.w) <= epsilon);
@@ -85,6 +85,16 @@ public:
     ViewFrustum::location cubeInFrustum(const AACube& cube) const;
     ViewFrustum::location boxInFrustum(const AABox& box) const;
 
+    /// Tests a batch of boxes, given as parallel arrays of their corners and dimensions, against the six planes in one
+    /// pass. outside[i] is set when box i is entirely outside of a plane, which is when boxInFrustum() would say OUTSIDE
+    /// if it weren't for the keyhole.
+    void boxesOutsidePlanes(int numBoxes, const float* cornerX, const float* cornerY, const float* cornerZ,
+                            const float* scaleX, const float* scaleY, const float* scaleZ, unsigned char* outside) const;
+
+    /// What boxInFrustum() says about boxes outside of the planes, so that those found by boxesOutsidePlanes() only
+    /// need to be tested against the keyhole. Only meaningful when the keyhole radius isn't negative.
+    ViewFrustum::location boxInKeyhole(const AABox& box) const;
+
     // some frustum comparisons
     bool matches(const ViewFrustum& compareTo, bool debug = false) const;
     bool matches(const ViewFrustum* compareTo, bool debug = false) const { return matches(*compareTo, debug); }
@@ -114,7 +124,6 @@ private:
     ViewFrustum::location pointInKeyhole(const glm::vec3& point) const;
     ViewFrustum::location sphereInKeyhole(const glm::vec3& center, float radius) const;
     ViewFrustum::location cubeInKeyhole(const AACube& cube) const;
-    ViewFrustum::location boxInKeyhole(const AABox& box) const;
 
     // camera location/orientation attributes
     glm::vec3 _position; // the position in world-frame
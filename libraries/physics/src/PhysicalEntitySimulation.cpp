@@ -195,6 +195,8 @@ void PhysicalEntitySimulation::handleOutgoingChanges(VectorOfMotionStates& motio
                     _outgoingChanges.insert(entityState);
                 }
                 _entitiesToSort.insert(entityState->getEntity());
+                noteMovedEntity(entityState->getEntity());
+                noteSteppedEntity(entityState->getEntity());
             }
         }
     }
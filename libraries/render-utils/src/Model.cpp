@@ -480,6 +480,13 @@ bool Model::updateGeometry() {
         foreach (const FBXMesh& mesh, fbxGeometry.meshes) {
             MeshState state;
             state.clusterMatrices.resize(mesh.clusters.size());
+            state.clusterJointIndices.resize(mesh.clusters.size());
+            state.inverseBindMatrices.resize(mesh.clusters.size());
+            for (int i = 0; i < mesh.clusters.size(); i++) {
+                const FBXCluster& cluster = mesh.clusters.at(i);
+                state.clusterJointIndices[i] = cluster.jointIndex;
+                state.inverseBindMatrices[i] = cluster.inverseBindMatrix;
+            }
             _meshStates.append(state);    
 
             gpu::BufferPointer buffer(new gpu::Buffer());
@@ -847,7 +854,11 @@ namespace render {
         if (!payload->model->isVisible()) {
             return ItemKey::Builder().withInvisible().build();
         }
-        return payload->transparent ? ItemKey::Builder::transparentShape() : ItemKey::Builder::opaqueShape();
+        auto builder = payload->transparent ? ItemKey::Builder::transparentShape() : ItemKey::Builder::opaqueShape();
+        if (!payload->model->isStaticInScene()) {
+            builder.withDynamic();
+        }
+        return builder.build();
     }
     
     template <> const Item::Bound payloadGetBound(const MeshPartPayload::Pointer& payload) { 
@@ -879,6 +890,28 @@ void Model::setVisibleInScene(bool newValue, std::shared_ptr<render::Scene> scen
     }
 }
 
+void Model::setStaticInScene(bool newValue, std::shared_ptr<render::Scene> scene) {
+    if (_isStaticInScene != newValue) {
+        _isStaticInScene = newValue;
+
+        // the parts move between the spatial tree and the dynamic items with their key
+        render::PendingChanges pendingChanges;
+        foreach (auto item, _renderItems.keys()) {
+            pendingChanges.resetItem(item, _renderItems[item]);
+        }
+        scene->enqueuePendingChanges(pendingChanges);
+    }
+}
+
+void Model::updateBoundsInScene(std::shared_ptr<render::Scene> scene) {
+    // nothing to change in the payloads, the update alone makes the scene re-place them by their new bounds
+    render::PendingChanges pendingChanges;
+    foreach (auto item, _renderItems.keys()) {
+        pendingChanges.updateItem<MeshPartPayload>(item, [](MeshPartPayload& payload) { });
+    }
+    scene->enqueuePendingChanges(pendingChanges);
+}
+
 
 bool Model::addToScene(std::shared_ptr<render::Scene> scene, render::PendingChanges& pendingChanges) {
     if (!_meshGroupsKnown && isLoadedWithTextures()) {
@@ -1357,8 +1390,30 @@ void Model::snapToRegistrationPoint() {
     _snappedToRegistrationPoint = true;
 }
 
+void Model::prepareSimulation() {
+    _preparedGeometryChanged = updateGeometry();
+    _simulationPrepared = true;
+}
+
+void Model::finishSimulation() {
+    _simulationPrepared = false;
+    if (_blendRequired) {
+        _blendRequired = false;
+        DependencyManager::get<ModelBlender>()->noteRequiresBlend(this);
+    }
+}
+
+bool Model::updatePreparedGeometry() {
+    if (_simulationPrepared) {
+        bool geometryChanged = _preparedGeometryChanged;
+        _preparedGeometryChanged = false;
+        return geometryChanged;
+    }
+    return updateGeometry();
+}
+
 void Model::simulate(float deltaTime, bool fullUpdate) {
-    fullUpdate = updateGeometry() || fullUpdate || (_scaleToFit && !_scaledToFit)
+    fullUpdate = updatePreparedGeometry() || fullUpdate || (_scaleToFit && !_scaledToFit)
                     || (_snapModelToRegistrationPoint && !_snappedToRegistrationPoint);
                     
     if (isActive() && fullUpdate) {
@@ -1399,26 +1454,27 @@ void Model::simulateInternal(float deltaTime) {
     
     const FBXGeometry& geometry = _geometry->getFBXGeometry();
     glm::mat4 modelToWorld = glm::mat4_cast(_rotation);
+    
+    // transform each joint once, however many clusters of however many meshes it moves
+    _jointPalette.resize(_jointStates.size());
+    for (int i = 0; i < _jointStates.size(); i++) {
+        const JointState& state = _jointStates.at(i);
+        _jointPalette[i] = modelToWorld * (_showTrueJointTransforms ? state.getTransform() : state.getVisibleTransform());
+    }
     for (int i = 0; i < _meshStates.size(); i++) {
         MeshState& state = _meshStates[i];
-        const FBXMesh& mesh = geometry.meshes.at(i);
-        if (_showTrueJointTransforms) {
-            for (int j = 0; j < mesh.clusters.size(); j++) {
-                const FBXCluster& cluster = mesh.clusters.at(j);
-                state.clusterMatrices[j] = modelToWorld * _jointStates[cluster.jointIndex].getTransform() * cluster.inverseBindMatrix;
-            }
-        } else {
-            for (int j = 0; j < mesh.clusters.size(); j++) {
-                const FBXCluster& cluster = mesh.clusters.at(j);
-                state.clusterMatrices[j] = modelToWorld * _jointStates[cluster.jointIndex].getVisibleTransform() * cluster.inverseBindMatrix;
-            }
-        }
+        multiplyPaletteMatrices(_jointPalette.constData(), state.clusterJointIndices.constData(),
+            state.inverseBindMatrices.constData(), state.clusterMatrices.data(), state.clusterMatrices.size());
     }
     
-    // post the blender if we're not currently waiting for one to finish
+    // post the blender if we're not currently waiting for one to finish, from the main thread if we may be off it
     if (geometry.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
         _blendedBlendshapeCoefficients = _blendshapeCoefficients;
-        DependencyManager::get<ModelBlender>()->noteRequiresBlend(this);
+        if (_simulationPrepared) {
+            _blendRequired = true;
+        } else {
+            DependencyManager::get<ModelBlender>()->noteRequiresBlend(this);
+        }
     }
 }
 
@@ -105,6 +105,12 @@ public:
 
     void setVisibleInScene(bool newValue, std::shared_ptr<render::Scene> scene);
     bool isVisible() const { return _isVisible; }
+
+    /// The parts of a model that is static in the scene are culled through the scene's spatial tree, so its owner has
+    /// to call updateBoundsInScene() whenever it moves it. Models are dynamic by default.
+    void setStaticInScene(bool newValue, std::shared_ptr<render::Scene> scene);
+    bool isStaticInScene() const { return _isStaticInScene; }
+    void updateBoundsInScene(std::shared_ptr<render::Scene> scene);
     
     bool isLoadedWithTextures() const { return _geometry && _geometry->isLoadedWithTextures(); }
     
@@ -112,6 +118,12 @@ public:
     void reset();
     virtual void simulate(float deltaTime, bool fullUpdate = true);
 
+    /// Splits simulate() so that models can be simulated on worker threads: prepareSimulation() updates the geometry,
+    /// which touches the geometry cache, on the main thread. simulate() may then run on any thread, touching nothing
+    /// outside the model and leaving any blend it requires to finishSimulation(), back on the main thread.
+    void prepareSimulation();
+    void finishSimulation();
+
     void renderSetup(RenderArgs* args);
     
     // new Scene/Engine rendering support
@@ -263,13 +275,20 @@ protected:
     class MeshState {
     public:
         QVector<glm::mat4> clusterMatrices;
+        QVector<int> clusterJointIndices; // the clusters' joints and inverse bind matrices, laid out for the batch
+        QVector<glm::mat4> inverseBindMatrices; // multiply of the joint palette into the cluster matrices
     };
     
     QVector<MeshState> _meshStates;
     
+    QVector<glm::mat4> _jointPalette; // the world-oriented transform of each joint, shared by the clusters of all meshes
+    
     // returns 'true' if needs fullUpdate after geometry change
     bool updateGeometry();
 
+    // updates the geometry unless prepareSimulation() already has, returns 'true' if needs fullUpdate
+    bool updatePreparedGeometry();
+
     virtual void initJointStates(QVector<JointState> states);
     
     void setScaleInternal(const glm::vec3& scale);
@@ -337,6 +356,7 @@ private:
     QUrl _url;
     QUrl _collisionUrl;
     bool _isVisible;
+    bool _isStaticInScene = false;
 
     gpu::Buffers _blendedVertexBuffers;
     std::vector<Transform> _transforms;
@@ -349,6 +369,9 @@ private:
     QList<AnimationHandlePointer> _runningAnimations;
 
     QVector<float> _blendedBlendshapeCoefficients;
+    bool _simulationPrepared = false;
+    bool _preparedGeometryChanged = false;
+    bool _blendRequired = false;
     int _blendNumber;
     int _appliedBlendNumber;
 
@@ -11,9 +11,16 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <memory>
 
 #include "DrawTask.h"
 
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
 #include <PerfStat.h>
 
 #include "gpu/Batch.h"
@@ -55,6 +62,96 @@ Job::~Job() {
 
 
 
+// Items are culled a block at a time: the bounds of a block are gathered into parallel arrays and tested against the
+// frustum planes together. Large buckets spread their blocks over the global thread pool.
+const int CULL_BLOCK_SIZE = 256;
+const int MIN_ITEMS_TO_CULL_IN_PARALLEL = 8192;
+
+static void findItemsOutsidePlanes(const ViewFrustum& frustum, const ItemIDsBounds& items, int begin, int end,
+                                   unsigned char* outside) {
+    float cornerX[CULL_BLOCK_SIZE], cornerY[CULL_BLOCK_SIZE], cornerZ[CULL_BLOCK_SIZE];
+    float scaleX[CULL_BLOCK_SIZE], scaleY[CULL_BLOCK_SIZE], scaleZ[CULL_BLOCK_SIZE];
+    for (int blockStart = begin; blockStart < end; blockStart += CULL_BLOCK_SIZE) {
+        int blockSize = std::min(CULL_BLOCK_SIZE, end - blockStart);
+        for (int i = 0; i < blockSize; i++) {
+            const AABox& bounds = items[blockStart + i].bounds;
+            cornerX[i] = bounds.getCorner().x;
+            cornerY[i] = bounds.getCorner().y;
+            cornerZ[i] = bounds.getCorner().z;
+            scaleX[i] = bounds.getScale().x;
+            scaleY[i] = bounds.getScale().y;
+            scaleZ[i] = bounds.getScale().z;
+        }
+        frustum.boxesOutsidePlanes(blockSize, cornerX, cornerY, cornerZ, scaleX, scaleY, scaleZ, outside + blockStart);
+    }
+}
+
+// the blocks of one cull shared between the render thread and the pool threads helping it. Pool threads may only get
+// to run once all the blocks are done, so they hold on to it with a shared pointer.
+class CullItemsJob {
+public:
+    CullItemsJob(const ViewFrustum& frustum, const ItemIDsBounds& items, unsigned char* outside) :
+        frustum(frustum), items(items), outside(outside),
+        numBlocks(((int)items.size() + CULL_BLOCK_SIZE - 1) / CULL_BLOCK_SIZE), nextBlock(0) { }
+
+    bool cullNextBlock() {
+        int block = nextBlock++;
+        if (block >= numBlocks) {
+            return false;
+        }
+        int begin = block * CULL_BLOCK_SIZE;
+        findItemsOutsidePlanes(frustum, items, begin, std::min(begin + CULL_BLOCK_SIZE, (int)items.size()), outside);
+        blocksDone.release();
+        return true;
+    }
+
+    const ViewFrustum& frustum;
+    const ItemIDsBounds& items;
+    unsigned char* outside;
+    const int numBlocks;
+    std::atomic<int> nextBlock;
+    QSemaphore blocksDone;
+};
+
+class CullItemsTask : public QRunnable {
+public:
+    CullItemsTask(const std::shared_ptr<CullItemsJob>& job) : _job(job) { }
+
+    virtual void run() {
+        while (_job->cullNextBlock()) {
+        }
+    }
+
+private:
+    std::shared_ptr<CullItemsJob> _job;
+};
+
+static void findItemsOutsideFrustum(const ViewFrustum& frustum, const ItemIDsBounds& items, unsigned char* outside) {
+    int numItems = (int)items.size();
+    if (numItems < MIN_ITEMS_TO_CULL_IN_PARALLEL || QThread::idealThreadCount() < 2) {
+        findItemsOutsidePlanes(frustum, items, 0, numItems, outside);
+    } else {
+        // the render thread works through the blocks too, so the cull never waits on a busy pool to get started
+        std::shared_ptr<CullItemsJob> job = std::make_shared<CullItemsJob>(frustum, items, outside);
+        int numHelpers = std::min(QThread::idealThreadCount() - 1, job->numBlocks - 1);
+        for (int i = 0; i < numHelpers; i++) {
+            QThreadPool::globalInstance()->start(new CullItemsTask(job));
+        }
+        while (job->cullNextBlock()) {
+        }
+        job->blocksDone.acquire(job->numBlocks);
+    }
+
+    // the planes can't tell about the keyhole, anything they reject is still in view if it is in the keyhole
+    if (frustum.getKeyholeRadius() >= 0.0f) {
+        for (int i = 0; i < numItems; i++) {
+            if (outside[i]) {
+                outside[i] = frustum.boxInKeyhole(items[i].bounds) == ViewFrustum::OUTSIDE;
+            }
+        }
+    }
+}
+
 void render::cullItems(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, const ItemIDsBounds& inItems, ItemIDsBounds& outItems) {
     assert(renderContext->args);
     assert(renderContext->args->_viewFrustum);
@@ -64,9 +161,17 @@ void render::cullItems(const SceneContextPointer& sceneContext, const RenderCont
     auto renderDetails = renderContext->args->_details._item;
 
     renderDetails->_considered += inItems.size();
-    
+
+    std::vector<unsigned char> outside(inItems.size());
+    {
+        PerformanceTimer perfTimer("boxInFrustum");
+        findItemsOutsideFrustum(*args->_viewFrustum, inItems, outside.data());
+    }
+
     // Culling / LOD
-    for (auto item : inItems) {
+    PerformanceTimer perfTimer("shouldRender");
+    for (size_t i = 0; i < inItems.size(); i++) {
+        const ItemIDAndBounds& item = inItems[i];
         if (item.bounds.isNull()) {
             outItems.emplace_back(item); // One more Item to render
             continue;
@@ -74,17 +179,8 @@ void render::cullItems(const SceneContextPointer& sceneContext, const RenderCont
 
         // TODO: some entity types (like lights) might want to be rendered even
         // when they are outside of the view frustum...
-        bool outOfView;
-        {
-            PerformanceTimer perfTimer("boxInFrustum");
-            outOfView = args->_viewFrustum->boxInFrustum(item.bounds) == ViewFrustum::OUTSIDE;
-        }
-        if (!outOfView) {
-            bool bigEnoughToRender;
-            {
-                PerformanceTimer perfTimer("shouldRender");
-                bigEnoughToRender = (args->_shouldRender) ? args->_shouldRender(args, item.bounds) : true;
-            }
+        if (!outside[i]) {
+            bool bigEnoughToRender = (args->_shouldRender) ? args->_shouldRender(args, item.bounds) : true;
             if (bigEnoughToRender) {
                 outItems.emplace_back(item); // One more Item to render
             } else {
@@ -100,14 +196,34 @@ void render::cullItems(const SceneContextPointer& sceneContext, const RenderCont
 
 void FetchItems::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, ItemIDsBounds& outItems) {
     auto& scene = sceneContext->_scene;
-    auto& items = scene->getMasterBucket().at(_filter);
     auto& renderDetails = renderContext->args->_details;
+    auto viewFrustum = renderContext->args->_viewFrustum;
 
     outItems.clear();
-    outItems.reserve(items.size());
-    for (auto id : items) {
-        auto& item = scene->getItem(id);
-        outItems.emplace_back(ItemIDAndBounds(id, item.getBound()));
+    if (!viewFrustum) {
+        auto& items = scene->getMasterBucket().at(_filter);
+        outItems.reserve(items.size());
+        for (auto id : items) {
+            auto& item = scene->getItem(id);
+            outItems.emplace_back(ItemIDAndBounds(id, item.getBound()));
+        }
+    } else {
+        // the items that can move on their own are all fetched, the others only from the cells of the spatial tree
+        // that can be seen
+        auto& unindexedItems = scene->getUnindexedBucket().at(_filter);
+        for (auto id : unindexedItems) {
+            auto& item = scene->getItem(id);
+            outItems.emplace_back(ItemIDAndBounds(id, item.getBound()));
+        }
+
+        _selectedItems.clear();
+        scene->getSpatialTree().selectItems(*viewFrustum, _selectedItems);
+        for (auto id : _selectedItems) {
+            auto& item = scene->getItem(id);
+            if (_filter.test(item.getKey())) {
+                outItems.emplace_back(ItemIDAndBounds(id, item.getBound()));
+            }
+        }
     }
 
     if (_probeNumItems) {
@@ -82,7 +82,7 @@ public:
     const Varying getOutput() const { return _concept->getOutput(); }
 
     void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
-        PerformanceTimer perfTimer(getName().c_str());
+        PerformanceTimer perfTimer(_concept->getTimerName());
         PROFILE_RANGE(getName().c_str());
         _concept->run(sceneContext, renderContext);
     }
@@ -92,13 +92,19 @@ public:
 
     class Concept {
         std::string _name;
+        const char* _timerName; // the name interned for PerformanceTimer when the job is built, not on every run
     public:
-        Concept() : _name() {}
-        Concept(const std::string& name) : _name(name) {}
+        Concept() : _name(), _timerName(PerformanceTimer::internName(QString())) {}
+        Concept(const std::string& name) :
+            _name(name), _timerName(PerformanceTimer::internName(QString::fromStdString(name))) {}
         virtual ~Concept() = default;
         
-        void setName(const std::string& name) { _name = name; }
+        void setName(const std::string& name) {
+            _name = name;
+            _timerName = PerformanceTimer::internName(QString::fromStdString(name));
+        }
         const std::string& getName() const { return _name; }
+        const char* getTimerName() const { return _timerName; }
         
         virtual const Varying getInput() const { return Varying(); }
         virtual const Varying getOutput() const { return Varying(); }
@@ -201,6 +207,7 @@ public:
 
     ItemFilter _filter = ItemFilter::Builder::opaqueShape().withoutLayered();
     ProbeNumItems _probeNumItems;
+    ItemIDs _selectedItems; // kept from one frame to the next for its storage
 
     void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext, ItemIDsBounds& outItems);
 
@@ -0,0 +1,138 @@
+//
+//  ItemSpatialTree.cpp
+//  render/src/render
+//
+//  Created on 2015-06-17.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ItemSpatialTree.h"
+
+#include "ViewFrustum.h"
+
+using namespace render;
+
+// the root cell spans far past any domain, items outside of it stay in the root, which is never culled
+const float ROOT_HALF_SIZE = 32768.0f;
+
+ItemSpatialTree::Cell::Cell(const glm::vec3& center, float halfSize, int parent) :
+    center(center),
+    halfSize(halfSize),
+    parent(parent),
+    numItemsInSubtree(0)
+{
+    for (int i = 0; i < 8; i++) {
+        children[i] = INVALID_CELL;
+    }
+}
+
+ItemSpatialTree::ItemSpatialTree() {
+    _cells.push_back(Cell(glm::vec3(0.0f), ROOT_HALF_SIZE, INVALID_CELL));
+}
+
+void ItemSpatialTree::insert(ItemID id, const AABox& bound) {
+    if (contains(id)) {
+        remove(id);
+    }
+    if (id >= _locations.size()) {
+        _locations.resize(id + 1);
+    }
+
+    int cell = findCell(bound);
+    Location& location = _locations[id];
+    location.cell = cell;
+    location.slot = (int)_cells[cell].items.size();
+    _cells[cell].items.push_back(id);
+    for (int parent = cell; parent != INVALID_CELL; parent = _cells[parent].parent) {
+        _cells[parent].numItemsInSubtree++;
+    }
+}
+
+void ItemSpatialTree::update(ItemID id, const AABox& bound) {
+    // an item that stays in its cell is left alone
+    if (contains(id) && findCell(bound) == _locations[id].cell) {
+        return;
+    }
+    insert(id, bound);
+}
+
+void ItemSpatialTree::remove(ItemID id) {
+    if (!contains(id)) {
+        return;
+    }
+    Location& location = _locations[id];
+    std::vector<ItemID>& items = _cells[location.cell].items;
+    ItemID lastItem = items.back();
+    items[location.slot] = lastItem;
+    _locations[lastItem].slot = location.slot;
+    items.pop_back();
+
+    // empty cells are kept, the counts let the selection skip them
+    for (int parent = location.cell; parent != INVALID_CELL; parent = _cells[parent].parent) {
+        _cells[parent].numItemsInSubtree--;
+    }
+    location.cell = INVALID_CELL;
+}
+
+int ItemSpatialTree::findCell(const AABox& bound) {
+    glm::vec3 center = bound.calcCenter();
+    float size = bound.getLargestDimension();
+    if (glm::any(glm::greaterThan(glm::abs(center), glm::vec3(ROOT_HALF_SIZE)))) {
+        return ROOT_CELL;
+    }
+
+    // go down for as long as the item is no bigger than the child cell it would go into
+    int cell = ROOT_CELL;
+    for (int depth = 0; depth < MAX_DEPTH; depth++) {
+        float childHalfSize = _cells[cell].halfSize * 0.5f;
+        if (size > 2.0f * childHalfSize) {
+            break;
+        }
+        glm::vec3 cellCenter = _cells[cell].center;
+        int childIndex = (center.x >= cellCenter.x ? 1 : 0) | (center.y >= cellCenter.y ? 2 : 0)
+            | (center.z >= cellCenter.z ? 4 : 0);
+        int child = _cells[cell].children[childIndex];
+        if (child == INVALID_CELL) {
+            glm::vec3 childCenter = cellCenter + glm::vec3((childIndex & 1) ? childHalfSize : -childHalfSize,
+                                                           (childIndex & 2) ? childHalfSize : -childHalfSize,
+                                                           (childIndex & 4) ? childHalfSize : -childHalfSize);
+            child = (int)_cells.size();
+            _cells.push_back(Cell(childCenter, childHalfSize, cell));
+            _cells[cell].children[childIndex] = child;
+        }
+        cell = child;
+    }
+    return cell;
+}
+
+void ItemSpatialTree::selectItems(const ViewFrustum& frustum, std::vector<ItemID>& selectedItems) const {
+    selectCellItems(ROOT_CELL, frustum, false, selectedItems);
+}
+
+void ItemSpatialTree::selectCellItems(int cell, const ViewFrustum& frustum, bool isInside,
+                                      std::vector<ItemID>& selectedItems) const {
+    const Cell& thisCell = _cells[cell];
+    if (thisCell.numItemsInSubtree == 0) {
+        return;
+    }
+    if (!isInside && cell != ROOT_CELL) {
+        // the loose bounds are the cell grown by half its size on every side
+        float looseHalfSize = 2.0f * thisCell.halfSize;
+        AABox looseBounds(thisCell.center - glm::vec3(looseHalfSize), 2.0f * looseHalfSize);
+        ViewFrustum::location location = frustum.boxInFrustum(looseBounds);
+        if (location == ViewFrustum::OUTSIDE) {
+            return;
+        }
+        isInside = (location == ViewFrustum::INSIDE);
+    }
+
+    selectedItems.insert(selectedItems.end(), thisCell.items.begin(), thisCell.items.end());
+    for (int i = 0; i < 8; i++) {
+        if (thisCell.children[i] != INVALID_CELL) {
+            selectCellItems(thisCell.children[i], frustum, isInside, selectedItems);
+        }
+    }
+}
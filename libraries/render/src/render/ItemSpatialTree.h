@@ -0,0 +1,80 @@
+//
+//  ItemSpatialTree.h
+//  render/src/render
+//
+//  Created on 2015-06-17.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_ItemSpatialTree_h
+#define hifi_render_ItemSpatialTree_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AABox.h>
+
+class ViewFrustum;
+
+namespace render {
+
+// A loose octree of the items of a Scene, so that whole regions of items behind the camera can be skipped at once.
+// Each cell holds the items whose center falls in it and that are no bigger than the cell. The bounds a cell is tested
+// with are twice its size, which is enough to hold all of those items wherever their center is, so an item never has
+// to be split between cells or pushed up the tree for straddling a boundary.
+// Items are placed by the bound they had when inserted or updated, so only items whose bound changes through the
+// Scene's PendingChanges belong in it.
+class ItemSpatialTree {
+public:
+    typedef unsigned int ItemID;
+
+    ItemSpatialTree();
+
+    void insert(ItemID id, const AABox& bound);
+    void update(ItemID id, const AABox& bound);
+    void remove(ItemID id);
+    bool contains(ItemID id) const { return id < _locations.size() && _locations[id].cell != INVALID_CELL; }
+
+    // Appends the items of every cell whose loose bounds aren't outside the frustum. The items still need to be culled
+    // one by one, only those of cells entirely outside are left out.
+    void selectItems(const ViewFrustum& frustum, std::vector<ItemID>& selectedItems) const;
+
+    int getNumItems() const { return _cells[ROOT_CELL].numItemsInSubtree; }
+
+private:
+    static const int INVALID_CELL = -1;
+    static const int ROOT_CELL = 0;
+    static const int MAX_DEPTH = 16;
+
+    class Cell {
+    public:
+        Cell(const glm::vec3& center, float halfSize, int parent);
+
+        glm::vec3 center;
+        float halfSize;
+        int parent;
+        int children[8];
+        int numItemsInSubtree;
+        std::vector<ItemID> items;
+    };
+
+    class Location {
+    public:
+        int cell = INVALID_CELL;
+        int slot = 0;
+    };
+
+    int findCell(const AABox& bound);
+    void selectCellItems(int cell, const ViewFrustum& frustum, bool isInside, std::vector<ItemID>& selectedItems) const;
+
+    std::vector<Cell> _cells;
+    std::vector<Location> _locations; // indexed by ItemID, which the Scene hands out densely
+};
+
+}
+
+#endif // hifi_render_ItemSpatialTree_h
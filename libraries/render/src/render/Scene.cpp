@@ -89,6 +89,7 @@ void PendingChanges::merge(PendingChanges& changes) {
 Scene::Scene() {
     _items.push_back(Item()); // add the itemID #0 to nothing
     _masterBucketMap.allocateStandardOpaqueTranparentBuckets();
+    _unindexedBucketMap.allocateStandardOpaqueTranparentBuckets();
 }
 
 ItemID Scene::allocateID() {
@@ -143,6 +144,7 @@ void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
         item.resetPayload(*resetPayload);
 
         _masterBucketMap.reset((*resetID), oldKey, item.getKey());
+        indexItem((*resetID), oldKey);
     }
 
 }
@@ -150,6 +152,11 @@ void Scene::resetItems(const ItemIDs& ids, Payloads& payloads) {
 void Scene::removeItems(const ItemIDs& ids) {
     for (auto removedID :ids) {
         _masterBucketMap.erase(removedID, _items[removedID].getKey());
+        if (_spatialTree.contains(removedID)) {
+            _spatialTree.remove(removedID);
+        } else {
+            _unindexedBucketMap.erase(removedID, _items[removedID].getKey());
+        }
         _items[removedID].kill();
     }
 }
@@ -158,6 +165,36 @@ void Scene::updateItems(const ItemIDs& ids, UpdateFunctors& functors) {
     auto updateID = ids.begin();
     auto updateFunctor = functors.begin();
     for (;updateID != ids.end(); updateID++, updateFunctor++) {
-        _items[(*updateID)].update((*updateFunctor));
+        auto& item = _items[(*updateID)];
+        item.update((*updateFunctor));
+
+        // the update is the item's chance to have moved
+        if (_spatialTree.contains((*updateID))) {
+            _spatialTree.update((*updateID), item.getBound());
+        }
+    }
+}
+
+void Scene::indexItem(const ItemID& id, const ItemKey& oldKey) {
+    // Only the items that promise to tell the scene when they move can be placed in the spatial tree, the others
+    // stay in the unindexed buckets that are walked every frame
+    if (_spatialTree.contains(id)) {
+        _spatialTree.remove(id);
+    } else {
+        _unindexedBucketMap.erase(id, oldKey);
+    }
+
+    auto& item = _items[id];
+    if (!item._payload) {
+        return;
+    }
+    auto key = item.getKey();
+    if (key.isWorldSpace() && key.isStatic()) {
+        auto bound = item.getBound();
+        if (!bound.isNull()) {
+            _spatialTree.insert(id, bound);
+            return;
+        }
     }
+    _unindexedBucketMap.insert(id, key);
 }
@@ -26,6 +26,8 @@
 
 #include "model/Material.h"
 
+#include "ItemSpatialTree.h"
+
 namespace render {
 
 class Context;
@@ -435,6 +437,12 @@ public:
     /// Access the main bucketmap of items
     const ItemBucketMap& getMasterBucket() const { return _masterBucketMap; }
 
+    /// Access the items that are in the spatial tree: static world space items with a bound
+    const ItemSpatialTree& getSpatialTree() const { return _spatialTree; }
+
+    /// Access the bucketmap of the items that are not in the spatial tree, and so have to be considered every frame
+    const ItemBucketMap& getUnindexedBucket() const { return _unindexedBucketMap; }
+
     /// Access a particular item form its ID
     /// WARNING, There is No check on the validity of the ID, so this could return a bad Item
     const Item& getItem(const ItemID& id) const { return _items[id]; }
@@ -455,7 +463,10 @@ protected:
     std::mutex _itemsMutex;
     Item::Vector _items;
     ItemBucketMap _masterBucketMap;
+    ItemSpatialTree _spatialTree;
+    ItemBucketMap _unindexedBucketMap;
 
+    void indexItem(const ItemID& id, const ItemKey& oldKey);
     void resetItems(const ItemIDs& ids, Payloads& payloads);
     void removeItems(const ItemIDs& ids);
     void updateItems(const ItemIDs& ids, UpdateFunctors& functors);
@@ -13,6 +13,12 @@
 
 #include "NumericalConstants.h"
 
+// SSE is part of every x86-64 processor
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define HAVE_SSE_MATRICES
+#include <xmmintrin.h>
+#endif
+
 //  Safe version of glm::mix; based on the code in Nick Bobick's article,
 //  http://www.gamasutra.com/features/19980703/quaternions_01.htm (via Clyde,
 //  https://github.com/threerings/clyde/blob/master/src/main/java/com/threerings/math/Quaternion.java)
@@ -112,6 +118,67 @@ int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatO
     return sizeof(quatParts);
 }
 
+const float SMALLEST_THREE_COMPONENT_MAX = 0.70710678f; // 1/sqrt(2)
+const int SMALLEST_THREE_COMPONENT_BITS = 15;
+const uint16_t SMALLEST_THREE_COMPONENT_MASK = (1 << SMALLEST_THREE_COMPONENT_BITS) - 1;
+const uint16_t SMALLEST_THREE_INDEX_BIT = 1 << SMALLEST_THREE_COMPONENT_BITS;
+
+int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput) {
+    glm::quat quatNormalized = glm::normalize(quatInput);
+    float components[4] = { quatNormalized.x, quatNormalized.y, quatNormalized.z, quatNormalized.w };
+
+    int largestIndex = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largestIndex])) {
+            largestIndex = i;
+        }
+    }
+
+    // q and -q are the same rotation, flip it so the component we drop is positive
+    float sign = components[largestIndex] < 0.0f ? -1.0f : 1.0f;
+
+    uint16_t quatParts[3];
+    int part = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float component = glm::clamp(sign * components[i], -SMALLEST_THREE_COMPONENT_MAX, SMALLEST_THREE_COMPONENT_MAX);
+            float ratio = (component + SMALLEST_THREE_COMPONENT_MAX) / (2.0f * SMALLEST_THREE_COMPONENT_MAX);
+            quatParts[part++] = (uint16_t)lrintf(ratio * SMALLEST_THREE_COMPONENT_MASK);
+        }
+    }
+    if (largestIndex & 2) {
+        quatParts[0] |= SMALLEST_THREE_INDEX_BIT;
+    }
+    if (largestIndex & 1) {
+        quatParts[1] |= SMALLEST_THREE_INDEX_BIT;
+    }
+
+    memcpy(buffer, &quatParts, sizeof(quatParts));
+    return sizeof(quatParts);
+}
+
+int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput) {
+    uint16_t quatParts[3];
+    memcpy(&quatParts, buffer, sizeof(quatParts));
+
+    int largestIndex = ((quatParts[0] & SMALLEST_THREE_INDEX_BIT) ? 2 : 0) + ((quatParts[1] & SMALLEST_THREE_INDEX_BIT) ? 1 : 0);
+
+    float components[4];
+    float sumOfSquares = 0.0f;
+    int part = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float ratio = (quatParts[part++] & SMALLEST_THREE_COMPONENT_MASK) / (float)SMALLEST_THREE_COMPONENT_MASK;
+            components[i] = ratio * 2.0f * SMALLEST_THREE_COMPONENT_MAX - SMALLEST_THREE_COMPONENT_MAX;
+            sumOfSquares += components[i] * components[i];
+        }
+    }
+    components[largestIndex] = sqrtf(glm::max(0.0f, 1.0f - sumOfSquares));
+
+    quatOutput = glm::quat(components[3], components[0], components[1], components[2]);
+    return sizeof(quatParts);
+}
+
 //  Safe version of glm::eulerAngles; uses the factorization method described in David Eberly's
 //  http://www.geometrictools.com/Documentation/EulerAngles.pdf (via Clyde,
 // https://github.com/threerings/clyde/blob/master/src/main/java/com/threerings/math/Quaternion.java)
@@ -289,6 +356,35 @@ float extractUniformScale(const glm::vec3& scale) {
     return (scale.x + scale.y + scale.z) / 3.0f;
 }
 
+void multiplyPaletteMatrices(const glm::mat4* palette, const int* paletteIndices, const glm::mat4* matrices,
+                             glm::mat4* results, int count) {
+#ifdef HAVE_SSE_MATRICES
+    for (int i = 0; i < count; i++) {
+        const float* left = &palette[paletteIndices[i]][0][0];
+        __m128 left0 = _mm_loadu_ps(left);
+        __m128 left1 = _mm_loadu_ps(left + 4);
+        __m128 left2 = _mm_loadu_ps(left + 8);
+        __m128 left3 = _mm_loadu_ps(left + 12);
+
+        // each column of the product is the left columns weighted by that column of the right, summed in glm's order
+        const float* right = &matrices[i][0][0];
+        float* result = &results[i][0][0];
+        for (int j = 0; j < 4; j++) {
+            const float* column = right + j * 4;
+            __m128 sum = _mm_mul_ps(left0, _mm_set1_ps(column[0]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(left1, _mm_set1_ps(column[1])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(left2, _mm_set1_ps(column[2])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(left3, _mm_set1_ps(column[3])));
+            _mm_storeu_ps(result + j * 4, sum);
+        }
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        results[i] = palette[paletteIndices[i]] * matrices[i];
+    }
+#endif
+}
+
 QByteArray createByteArray(const glm::vec3& vector) {
     return QByteArray::number(vector.x) + ',' + QByteArray::number(vector.y) + ',' + QByteArray::number(vector.z);
 }
@@ -62,6 +62,13 @@ int unpackFloatAngleFromTwoByte(const uint16_t* byteAnglePointer, float* destina
 int packOrientationQuatToBytes(unsigned char* buffer, const glm::quat& quatInput);
 int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatOutput);
 
+// A unit quat is fully described by its three smallest components, since the largest can be recovered from them
+// and can always be made positive by negating the quat. Each of the three is within +/- 1/sqrt(2) and is encoded
+// in 15 bits, the spare bit of the first two words holds the index of the dropped component. Always six bytes.
+const int SMALLEST_THREE_QUAT_BYTES = 6;
+int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput);
+int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput);
+
 // Ratios need the be highly accurate when less than 10, but not very accurate above 10, and they
 // are never greater than 1000 to 1, this allows us to encode each component in 16bits
 int packFloatRatioToTwoByte(unsigned char* buffer, float ratio);
@@ -105,6 +112,11 @@ float extractUniformScale(const glm::mat4& matrix);
 
 float extractUniformScale(const glm::vec3& scale);
 
+/// Sets each of the results to palette[paletteIndices[i]] * matrices[i], rounding as glm's own product does. Uses SSE
+/// where available. The results must not overlap the inputs.
+void multiplyPaletteMatrices(const glm::mat4* palette, const int* paletteIndices, const glm::mat4* matrices,
+                             glm::mat4* results, int count);
+
 QByteArray createByteArray(const glm::vec3& vector);
 QByteArray createByteArray(const glm::quat& quat);
 
@@ -0,0 +1,403 @@
+//
+//  JSONStreamReader.cpp
+//  libraries/shared/src
+//
+//  Created on 2015-06-14.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "JSONStreamReader.h"
+
+JSONStreamReader::JSONStreamReader(QIODevice& device) :
+    _device(device),
+    _position(0),
+    _bufferOffset(0)
+{
+}
+
+bool JSONStreamReader::beginObject() {
+    if (!expect('{')) {
+        return false;
+    }
+    _isFirstMember.push_back(true);
+    return true;
+}
+
+bool JSONStreamReader::nextKey(QString& key) {
+    if (hasError() || _isFirstMember.isEmpty()) {
+        return false;
+    }
+
+    char next;
+    if (!skipWhitespace() || !peek(next)) {
+        return setError("unexpected end of document in object");
+    }
+    if (next == '}') {
+        _position++;
+        _isFirstMember.pop_back();
+        return false;
+    }
+
+    if (_isFirstMember.last()) {
+        _isFirstMember.last() = false;
+    } else if (!expect(',')) {
+        return false;
+    }
+
+    if (!skipWhitespace() || !peek(next) || next != '"') {
+        return setError("expected a key");
+    }
+    return readString(&key) && expect(':');
+}
+
+bool JSONStreamReader::beginArray() {
+    if (!expect('[')) {
+        return false;
+    }
+    _isFirstMember.push_back(true);
+    return true;
+}
+
+bool JSONStreamReader::nextElement() {
+    if (hasError() || _isFirstMember.isEmpty()) {
+        return false;
+    }
+
+    char next;
+    if (!skipWhitespace() || !peek(next)) {
+        return setError("unexpected end of document in array");
+    }
+    if (next == ']') {
+        _position++;
+        _isFirstMember.pop_back();
+        return false;
+    }
+
+    if (_isFirstMember.last()) {
+        _isFirstMember.last() = false;
+        return true;
+    }
+    return expect(',');
+}
+
+bool JSONStreamReader::readValue(QVariant& value) {
+    return !hasError() && readValue(&value, 0);
+}
+
+bool JSONStreamReader::skipValue() {
+    return !hasError() && readValue(NULL, 0);
+}
+
+bool JSONStreamReader::fill() {
+    if (_position < _buffer.size()) {
+        return true;
+    }
+    _bufferOffset += _buffer.size();
+    _buffer = _device.read(READ_CHUNK_BYTES);
+    _position = 0;
+    return !_buffer.isEmpty();
+}
+
+bool JSONStreamReader::peek(char& next) {
+    if (!fill()) {
+        return false;
+    }
+    next = _buffer.at(_position);
+    return true;
+}
+
+bool JSONStreamReader::expect(char expected) {
+    char next;
+    if (!skipWhitespace() || !peek(next) || next != expected) {
+        return setError(QString("expected '%1'").arg(expected));
+    }
+    _position++;
+    return true;
+}
+
+bool JSONStreamReader::skipWhitespace() {
+    char next;
+    while (peek(next)) {
+        if (next != ' ' && next != '\n' && next != '\r' && next != '\t') {
+            return true;
+        }
+        _position++;
+    }
+    return false;
+}
+
+bool JSONStreamReader::setError(const QString& error) {
+    if (!hasError()) {
+        _error = QString("JSON error at byte %1: %2").arg(_bufferOffset + _position).arg(error);
+    }
+    return false;
+}
+
+bool JSONStreamReader::readValue(QVariant* value, int depth) {
+    if (depth > MAX_DEPTH) {
+        return setError("values nested too deep");
+    }
+
+    char next;
+    if (!skipWhitespace() || !peek(next)) {
+        return setError("unexpected end of document, expected a value");
+    }
+    switch (next) {
+        case '{':
+            return readObject(value, depth);
+
+        case '[':
+            return readArray(value, depth);
+
+        case '"': {
+            QString string;
+            if (!readString(value ? &string : NULL)) {
+                return false;
+            }
+            if (value) {
+                *value = string;
+            }
+            return true;
+        }
+        case 't':
+            return readLiteral("true", true, value);
+
+        case 'f':
+            return readLiteral("false", false, value);
+
+        case 'n':
+            return readLiteral("null", QVariant(), value);
+
+        default:
+            return readNumber(value);
+    }
+}
+
+bool JSONStreamReader::readObject(QVariant* value, int depth) {
+    _position++; // '{'
+
+    QVariantMap map;
+    char next;
+    if (!skipWhitespace() || !peek(next)) {
+        return setError("unexpected end of document in object");
+    }
+    if (next == '}') {
+        _position++;
+    } else {
+        QString key;
+        QVariant member;
+        while (true) {
+            if (!skipWhitespace() || !peek(next) || next != '"') {
+                return setError("expected a key");
+            }
+            if (!readString(value ? &key : NULL) || !expect(':') || !readValue(value ? &member : NULL, depth + 1)) {
+                return false;
+            }
+            if (value) {
+                map.insert(key, member);
+            }
+
+            if (!skipWhitespace() || !peek(next)) {
+                return setError("unexpected end of document in object");
+            }
+            _position++;
+            if (next == '}') {
+                break;
+            } else if (next != ',') {
+                return setError("expected ',' or '}'");
+            }
+        }
+    }
+
+    if (value) {
+        *value = map;
+    }
+    return true;
+}
+
+bool JSONStreamReader::readArray(QVariant* value, int depth) {
+    _position++; // '['
+
+    QVariantList list;
+    char next;
+    if (!skipWhitespace() || !peek(next)) {
+        return setError("unexpected end of document in array");
+    }
+    if (next == ']') {
+        _position++;
+    } else {
+        QVariant element;
+        while (true) {
+            if (!readValue(value ? &element : NULL, depth + 1)) {
+                return false;
+            }
+            if (value) {
+                list.append(element);
+            }
+
+            if (!skipWhitespace() || !peek(next)) {
+                return setError("unexpected end of document in array");
+            }
+            _position++;
+            if (next == ']') {
+                break;
+            } else if (next != ',') {
+                return setError("expected ',' or ']'");
+            }
+        }
+    }
+
+    if (value) {
+        *value = list;
+    }
+    return true;
+}
+
+static int hexDigitValue(char digit) {
+    if (digit >= '0' && digit <= '9') {
+        return digit - '0';
+    } else if (digit >= 'a' && digit <= 'f') {
+        return digit - 'a' + 10;
+    } else if (digit >= 'A' && digit <= 'F') {
+        return digit - 'A' + 10;
+    }
+    return -1;
+}
+
+bool JSONStreamReader::readString(QString* value) {
+    _position++; // '"'
+
+    // runs of plain characters are copied straight out of the read buffer, only escapes are handled one at a time
+    QByteArray utf8;
+    while (true) {
+        if (!fill()) {
+            return setError("unterminated string");
+        }
+        const char* data = _buffer.constData();
+        int runStart = _position;
+        while (_position < _buffer.size()) {
+            unsigned char character = data[_position];
+            if (character == '"' || character == '\\' || character < 0x20) {
+                break;
+            }
+            _position++;
+        }
+        if (value) {
+            utf8.append(data + runStart, _position - runStart);
+        }
+        if (_position == _buffer.size()) {
+            continue;
+        }
+
+        char character = data[_position++];
+        if (character == '"') {
+            break;
+        } else if (character != '\\') {
+            return setError("control character in string");
+        }
+
+        char escape;
+        if (!peek(escape)) {
+            return setError("unterminated string");
+        }
+        _position++;
+        switch (escape) {
+            case '"':
+            case '\\':
+            case '/':
+                utf8.append(escape);
+                break;
+            case 'b':
+                utf8.append('\b');
+                break;
+            case 'f':
+                utf8.append('\f');
+                break;
+            case 'n':
+                utf8.append('\n');
+                break;
+            case 'r':
+                utf8.append('\r');
+                break;
+            case 't':
+                utf8.append('\t');
+                break;
+            case 'u': {
+                // a character outside the basic plane comes as a pair of escaped surrogates
+                QString escapedCharacters;
+                while (true) {
+                    ushort codeUnit = 0;
+                    for (int i = 0; i < 4; i++) {
+                        char digit;
+                        if (!peek(digit) || hexDigitValue(digit) < 0) {
+                            return setError("bad \\u escape in string");
+                        }
+                        _position++;
+                        codeUnit = (codeUnit << 4) | hexDigitValue(digit);
+                    }
+                    escapedCharacters.append(QChar(codeUnit));
+
+                    char backslash;
+                    char u;
+                    if (!QChar(codeUnit).isHighSurrogate() || !peek(backslash) || backslash != '\\') {
+                        break;
+                    }
+                    _position++;
+                    if (!peek(u) || u != 'u') {
+                        return setError("bad surrogate pair in string");
+                    }
+                    _position++;
+                }
+                utf8.append(escapedCharacters.toUtf8());
+                break;
+            }
+            default:
+                return setError("bad escape in string");
+        }
+    }
+
+    if (value) {
+        *value = QString::fromUtf8(utf8);
+    }
+    return true;
+}
+
+bool JSONStreamReader::readNumber(QVariant* value) {
+    QByteArray number;
+    char next;
+    while (peek(next) && ((next >= '0' && next <= '9') || next == '-' || next == '+' || next == '.'
+                          || next == 'e' || next == 'E')) {
+        number.append(next);
+        _position++;
+    }
+
+    bool ok;
+    double result = number.toDouble(&ok);
+    if (number.isEmpty() || !ok) {
+        return setError("expected a value");
+    }
+    if (value) {
+        *value = result;
+    }
+    return true;
+}
+
+bool JSONStreamReader::readLiteral(const char* literal, const QVariant& literalValue, QVariant* value) {
+    for (const char* expected = literal; *expected; expected++) {
+        char next;
+        if (!peek(next) || next != *expected) {
+            return setError("expected a value");
+        }
+        _position++;
+    }
+    if (value) {
+        *value = literalValue;
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+//
+//  JSONStreamReader.h
+//  libraries/shared/src
+//
+//  Created on 2015-06-14.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Pull parser that walks a JSON document straight off a QIODevice
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JSONStreamReader_h
+#define hifi_JSONStreamReader_h
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+/// Reads a JSON document a piece at a time, so that a large document never has to be held in memory whole. The caller
+/// steps through the containers it cares about with beginObject()/nextKey() and beginArray()/nextElement(), and reads
+/// the values inside them with readValue(), which builds the same QVariant that QJsonDocument::toVariant() would.
+///
+///     reader.beginObject();
+///     while (reader.nextKey(key)) {
+///         if (key == "Entities" && reader.beginArray()) {
+///             while (reader.nextElement() && reader.readValue(entity)) { ... }
+///         } else {
+///             reader.skipValue();
+///         }
+///     }
+///
+/// Every call returns false on malformed input, after which hasError() is true and getError() says where.
+class JSONStreamReader {
+public:
+    JSONStreamReader(QIODevice& device);
+
+    /// consumes the '{' of an object
+    bool beginObject();
+
+    /// reads the next key of the current object, along with its ':'. Returns false at the end of the object.
+    bool nextKey(QString& key);
+
+    /// consumes the '[' of an array
+    bool beginArray();
+
+    /// moves to the next element of the current array. Returns false at the end of the array.
+    bool nextElement();
+
+    /// reads the next value whole
+    bool readValue(QVariant& value);
+
+    /// reads past the next value without building it
+    bool skipValue();
+
+    bool hasError() const { return !_error.isEmpty(); }
+    const QString& getError() const { return _error; }
+
+private:
+    static const int READ_CHUNK_BYTES = 64 * 1024;
+    static const int MAX_DEPTH = 256;
+
+    bool fill();
+    bool peek(char& next);
+    bool expect(char expected);
+    bool skipWhitespace();
+    bool setError(const QString& error);
+
+    bool readValue(QVariant* value, int depth);
+    bool readObject(QVariant* value, int depth);
+    bool readArray(QVariant* value, int depth);
+    bool readString(QString* value);
+    bool readNumber(QVariant* value);
+    bool readLiteral(const char* literal, const QVariant& literalValue, QVariant* value);
+
+    QIODevice& _device;
+    QByteArray _buffer;
+    int _position;
+    qint64 _bufferOffset;
+
+    // whether the containers opened with beginObject()/beginArray() are still waiting for their first member
+    QVector<bool> _isFirstMember;
+
+    QString _error;
+};
+
+#endif // hifi_JSONStreamReader_h
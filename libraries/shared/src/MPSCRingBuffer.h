@@ -0,0 +1,124 @@
+//
+//  MPSCRingBuffer.h
+//  libraries/shared/src
+//
+//  Created on 2015-06-11.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Bounded lock-free queue for many producer threads and a single consumer thread
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MPSCRingBuffer_h
+#define hifi_MPSCRingBuffer_h
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/// A fixed number of slots that are written in place by any number of producer threads and read in place by one
+/// consumer thread, without locks. Each slot carries a sequence number that says whose turn it is: producers claim a
+/// position by advancing the enqueue position and publish the slot by bumping its sequence, the consumer hands the
+/// slot back by bumping it again a lap later. Slots are never destroyed while the buffer lives, so a T that owns
+/// memory (a QByteArray, say) keeps it from one lap to the next.
+template <typename T>
+class MPSCRingBuffer {
+public:
+    /// capacity is rounded up to a power of two
+    MPSCRingBuffer(int capacity) :
+        _capacity(roundUpToPowerOfTwo(capacity)),
+        _mask(_capacity - 1),
+        _slots(new Slot[_capacity]),
+        _enqueuePosition(0),
+        _dequeuePosition(0)
+    {
+        for (size_t i = 0; i < _capacity; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// Claims a free slot and calls writeSlot(T&) on it before making it visible to the consumer. Safe to call from
+    /// any number of threads. Returns false, without calling writeSlot, if every slot is in use.
+    template <typename Writer>
+    bool push(Writer writeSlot) {
+        size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &_slots[position & _mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (difference == 0) {
+                // the slot is free for this lap, try to claim it
+                if (_enqueuePosition.compare_exchange_weak(position, position + 1)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // the consumer hasn't handed this slot back yet, we're full
+                return false;
+            } else {
+                // another producer claimed it first
+                position = _enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        writeSlot(slot->value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Calls readSlot(T&) on the oldest published slot and then hands the slot back to the producers. Only one thread
+    /// may pop. Returns false if nothing has been published yet.
+    template <typename Reader>
+    bool pop(Reader readSlot) {
+        size_t position = _dequeuePosition.load(std::memory_order_relaxed);
+        Slot& slot = _slots[position & _mask];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+
+        readSlot(slot.value);
+        _dequeuePosition.store(position + 1);
+        slot.sequence.store(position + _capacity, std::memory_order_release);
+        return true;
+    }
+
+    /// Number of slots claimed by producers and not yet popped. Some may still be in the middle of being written.
+    int size() const {
+        size_t dequeuePosition = _dequeuePosition.load();
+        return (int)(_enqueuePosition.load() - dequeuePosition);
+    }
+
+    bool isEmpty() const { return size() == 0; }
+
+    int getCapacity() const { return (int)_capacity; }
+
+private:
+    static size_t roundUpToPowerOfTwo(int value) {
+        size_t rounded = 1;
+        while (rounded < (size_t)value) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // keep the positions the producers fight over off the cache line the consumer writes
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    const size_t _capacity;
+    const size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+
+    char _enqueuePadding[CACHE_LINE_SIZE];
+    std::atomic<size_t> _enqueuePosition;
+    char _dequeuePadding[CACHE_LINE_SIZE];
+    std::atomic<size_t> _dequeuePosition;
+};
+
+#endif // hifi_MPSCRingBuffer_h
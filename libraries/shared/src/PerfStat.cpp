@@ -13,8 +13,13 @@
 #include <map>
 #include <string>
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
 #include <QThread>
+#include <QThreadStorage>
 
 #include "PerfStat.h"
 
@@ -79,28 +84,198 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
 // PerformanceTimer
 // ----------------------------------------------------------------------------
 
+// Names are interned into a fixed open addressed table keyed by the address of the name, so that the same string
+// literal always finds the same slot without a lock. The slot index is the name ID, zero is never used.
+const int MAX_TIMER_NAMES = 4096;
+static std::atomic<const char*> timerNames[MAX_TIMER_NAMES];
+
+static int nameIDForName(const char* name) {
+    const int NAME_ID_MASK = MAX_TIMER_NAMES - 1;
+    int index = (int)(((quintptr)name >> 3) * 2654435761U) & NAME_ID_MASK;
+    for (int probe = 0; probe < MAX_TIMER_NAMES; probe++) {
+        int nameID = (index + probe) & NAME_ID_MASK;
+        if (nameID == 0) {
+            continue;
+        }
+        const char* existing = timerNames[nameID].load(std::memory_order_acquire);
+        if (existing == name) {
+            return nameID;
+        }
+        if (!existing && timerNames[nameID].compare_exchange_strong(existing, name)) {
+            return nameID;
+        }
+        if (existing == name) {
+            // another thread interned it as we tried to
+            return nameID;
+        }
+    }
+
+    qCDebug(shared) << "PerformanceTimer ran out of room for names, not timing" << name;
+    return 0;
+}
+
+// names that aren't literals are copied once and kept for the life of the program
+static QMutex dynamicNamesMutex;
+static QHash<QString, QByteArray> dynamicNames;
+
+// static
+const char* PerformanceTimer::internName(const QString& name) {
+    QMutexLocker locker(&dynamicNamesMutex);
+    QHash<QString, QByteArray>::iterator dynamicName = dynamicNames.find(name);
+    if (dynamicName == dynamicNames.end()) {
+        dynamicName = dynamicNames.insert(name, name.toUtf8());
+    }
+    return dynamicName.value().constData();
+}
+
+static int nameIDForName(const QString& name) {
+    return nameIDForName(PerformanceTimer::internName(name));
+}
+
+// timestamps come from a monotonic clock that is cheap to read, they are only ever compared to each other
+class PerformanceTimerClock {
+public:
+    PerformanceTimerClock() { _timer.start(); }
+    quint64 now() const { return _timer.nsecsElapsed() / NSECS_PER_USEC; }
+private:
+    QElapsedTimer _timer;
+};
+static PerformanceTimerClock timerClock;
+
+static quint64 timerTimestampNow() {
+    return timerClock.now();
+}
+
+struct PerformanceTimerEvent {
+    quint64 timestamp;
+    quint16 nameID;
+    quint8 depth;
+    bool isEnd;
+};
+
+struct PerformanceTimerTraceEvent {
+    int nameID;
+    int threadIndex;
+    quint64 start;
+    quint64 end;
+};
+
+/// The events of one thread. Only that thread writes them and only the collector reads them, the two indices are
+/// free running counters so the ring needs no lock.
+class PerformanceTimerThread {
+public:
+    static const int MAX_EVENTS = 16384;
+
+    PerformanceTimerThread(int threadIndex, const QString& threadName) :
+        threadIndex(threadIndex),
+        threadName(threadName),
+        events(MAX_EVENTS),
+        writeIndex(0),
+        readIndex(0),
+        numDroppedEvents(0),
+        isFinished(false),
+        depth(0)
+    {
+    }
+
+    void record(int nameID, bool isEnd) {
+        quint32 index = writeIndex.load(std::memory_order_relaxed);
+        if (index - readIndex.load(std::memory_order_acquire) >= (quint32)MAX_EVENTS) {
+            // the collector hasn't kept up, it resynchronizes using the depth of the events that do make it
+            numDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        PerformanceTimerEvent& event = events[index % MAX_EVENTS];
+        event.timestamp = timerTimestampNow();
+        event.nameID = nameID;
+        event.depth = depth;
+        event.isEnd = isEnd;
+        writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    const int threadIndex;
+    const QString threadName;
+
+    QVector<PerformanceTimerEvent> events;
+    std::atomic<quint32> writeIndex;
+    std::atomic<quint32> readIndex;
+    std::atomic<quint32> numDroppedEvents;
+    std::atomic<bool> isFinished;
+
+    // only touched by the owning thread
+    quint8 depth;
+
+    // only touched by the collector, the scopes of this thread that have begun but not ended
+    QVector<int> openNameIDs;
+    QVector<quint64> openStarts;
+    QVector<int> openPathLengths;
+    QString openPath;
+};
+
+// lets the collector know when a thread has gone away, so its ring can be freed once drained
+class PerformanceTimerThreadHolder {
+public:
+    PerformanceTimerThreadHolder(PerformanceTimerThread* thread) : thread(thread) { }
+    ~PerformanceTimerThreadHolder() { thread->isFinished.store(true); }
+    PerformanceTimerThread* thread;
+};
+
+static QThreadStorage<PerformanceTimerThreadHolder*> currentTimerThread;
+static QMutex timerThreadsMutex;
+static QVector<PerformanceTimerThread*> timerThreads;
+static int nextTimerThreadIndex = 0;
+
+// everything the collector builds is guarded by this
+static QMutex collectorMutex;
+static QMap<QString, PerformanceTimerRecord> timerRecords;
+const int MAX_TRACE_EVENTS = 100000;
+static QVector<PerformanceTimerTraceEvent> traceEvents;
+static int nextTraceEvent = 0;
+static QHash<int, QString> traceThreadNames;
+
+static PerformanceTimerThread* timerThreadForCurrentThread() {
+    if (!currentTimerThread.hasLocalData()) {
+        QMutexLocker locker(&timerThreadsMutex);
+        int threadIndex = ++nextTimerThreadIndex;
+        QString threadName = QThread::currentThread()->objectName();
+        if (threadName.isEmpty()) {
+            threadName = QString("Thread %1").arg(threadIndex);
+        }
+        PerformanceTimerThread* thread = new PerformanceTimerThread(threadIndex, threadName);
+        timerThreads.append(thread);
+        currentTimerThread.setLocalData(new PerformanceTimerThreadHolder(thread));
+    }
+    return currentTimerThread.localData()->thread;
+}
+
 std::atomic<bool> PerformanceTimer::_isActive(false);
-QHash<QThread*, QString> PerformanceTimer::_fullNames;
-QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
+PerformanceTimer::PerformanceTimer(const char* name) {
+    if (_isActive) {
+        begin(nameIDForName(name));
+    }
+}
 
 PerformanceTimer::PerformanceTimer(const QString& name) {
     if (_isActive) {
-        _name = name;
-        QString& fullName = _fullNames[QThread::currentThread()];
-        fullName.append("/");
-        fullName.append(_name);
-        _start = usecTimestampNow();
+        begin(nameIDForName(name));
+    }
+}
+
+void PerformanceTimer::begin(int nameID) {
+    if (nameID != 0) {
+        _nameID = nameID;
+        _thread = timerThreadForCurrentThread();
+        _thread->record(_nameID, false);
+        ++_thread->depth;
     }
 }
 
 PerformanceTimer::~PerformanceTimer() {
-    if (_isActive && _start != 0) {
-        quint64 elapsedusec = (usecTimestampNow() - _start);
-        QString& fullName = _fullNames[QThread::currentThread()];
-        PerformanceTimerRecord& namedRecord = _records[fullName];
-        namedRecord.accumulateResult(elapsedusec);
-        fullName.resize(fullName.size() - (_name.size() + 1));
+    // a scope that began is always ended, even if we were turned off meanwhile, so the depth stays balanced
+    if (_thread) {
+        --_thread->depth;
+        _thread->record(_nameID, true);
     }
 }
 
@@ -109,29 +284,122 @@ bool PerformanceTimer::isActive() {
     return _isActive;
 }
 
+static void collectTimerThread(PerformanceTimerThread* thread) {
+    quint32 readIndex = thread->readIndex.load(std::memory_order_relaxed);
+    quint32 writeIndex = thread->writeIndex.load(std::memory_order_acquire);
+
+    // closes the scopes past the given number, when their ends were lost they never make it into the records
+    auto truncateOpenScopes = [thread](int numOpenScopes) {
+        if (thread->openNameIDs.size() > numOpenScopes) {
+            thread->openPath.truncate(thread->openPathLengths[numOpenScopes]);
+            thread->openNameIDs.resize(numOpenScopes);
+            thread->openStarts.resize(numOpenScopes);
+            thread->openPathLengths.resize(numOpenScopes);
+        }
+    };
+
+    for (; readIndex != writeIndex; ++readIndex) {
+        const PerformanceTimerEvent& event = thread->events[readIndex % PerformanceTimerThread::MAX_EVENTS];
+        int depth = event.depth;
+
+        if (!event.isEnd) {
+            truncateOpenScopes(depth);
+            if (thread->openNameIDs.size() == depth) {
+                thread->openPathLengths.append(thread->openPath.size());
+                thread->openPath.append("/");
+                thread->openPath.append(timerNames[event.nameID].load());
+                thread->openNameIDs.append(event.nameID);
+                thread->openStarts.append(event.timestamp);
+            }
+        } else {
+            truncateOpenScopes(depth + 1);
+            if (thread->openNameIDs.size() == depth + 1 && thread->openNameIDs.last() == event.nameID) {
+                quint64 start = thread->openStarts.last();
+                timerRecords[thread->openPath].accumulateResult(event.timestamp - start);
+
+                if (traceEvents.size() < MAX_TRACE_EVENTS) {
+                    traceEvents.append(PerformanceTimerTraceEvent());
+                }
+                PerformanceTimerTraceEvent& traceEvent = traceEvents[nextTraceEvent];
+                traceEvent.nameID = event.nameID;
+                traceEvent.threadIndex = thread->threadIndex;
+                traceEvent.start = start;
+                traceEvent.end = event.timestamp;
+                nextTraceEvent = (nextTraceEvent + 1) % MAX_TRACE_EVENTS;
+
+                truncateOpenScopes(depth);
+            }
+        }
+    }
+
+    thread->readIndex.store(readIndex, std::memory_order_release);
+}
+
+static void collectAllTimerThreads() {
+    QMutexLocker locker(&timerThreadsMutex);
+    for (int i = 0; i < timerThreads.size(); ) {
+        PerformanceTimerThread* thread = timerThreads[i];
+
+        // check if it finished first, so that we can't miss events it wrote just before
+        bool isFinished = thread->isFinished.load();
+        collectTimerThread(thread);
+        traceThreadNames[thread->threadIndex] = thread->threadName;
+
+        quint32 numDroppedEvents = thread->numDroppedEvents.exchange(0);
+        if (numDroppedEvents > 0) {
+            qCDebug(shared) << "PerformanceTimer dropped" << numDroppedEvents << "events on" << thread->threadName;
+        }
+
+        if (isFinished) {
+            timerThreads.remove(i);
+            delete thread;
+        } else {
+            ++i;
+        }
+    }
+}
+
 // static
 void PerformanceTimer::setActive(bool active) {
     if (active != _isActive) {
         _isActive.store(active);
         if (!active) {
-            _fullNames.clear();
-            _records.clear();
+            QMutexLocker locker(&collectorMutex);
+            collectAllTimerThreads();
+            timerRecords.clear();
+            traceEvents.clear();
+            nextTraceEvent = 0;
         }
         
         qDebug() << "PerformanceTimer has been turned" << ((active) ? "on" : "off");
     }
 }
 
+// static
+PerformanceTimerRecord PerformanceTimer::getTimerRecord(const QString& name) {
+    QMutexLocker locker(&collectorMutex);
+    return timerRecords.value(name);
+}
+
+// static
+QMap<QString, PerformanceTimerRecord> PerformanceTimer::getAllTimerRecords() {
+    QMutexLocker locker(&collectorMutex);
+    return timerRecords;
+}
+
 // static
 void PerformanceTimer::tallyAllTimerRecords() {
-    QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
-    QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
+    QMutexLocker locker(&collectorMutex);
+    collectAllTimerThreads();
+
+    QMap<QString, PerformanceTimerRecord>::iterator recordsItr = timerRecords.begin();
+    QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = timerRecords.end();
     quint64 now = usecTimestampNow();
     while (recordsItr != recordsEnd) {
         recordsItr.value().tallyResult(now);
         if (recordsItr.value().isStale(now)) {
             // purge stale records
-            recordsItr = _records.erase(recordsItr);
+            recordsItr = timerRecords.erase(recordsItr);
         } else {
             ++recordsItr;
         }
@@ -139,7 +407,7 @@ void PerformanceTimer::tallyAllTimerRecords() {
 }
 
 void PerformanceTimer::dumpAllTimerRecords() {
-    QMapIterator<QString, PerformanceTimerRecord> i(_records);
+    QMapIterator<QString, PerformanceTimerRecord> i(getAllTimerRecords());
     while (i.hasNext()) {
         i.next();
         qCDebug(shared) << i.key() << ": average " << i.value().getAverage() 
@@ -147,3 +415,75 @@ void PerformanceTimer::dumpAllTimerRecords() {
             << "usecs over" << i.value().getCount() << "calls";
     }
 }
+
+// names come from anywhere, so they are escaped to keep the trace valid JSON
+static void appendJSONString(QByteArray& trace, const char* string) {
+    trace.append('"');
+    for (; *string; string++) {
+        char c = *string;
+        if (c == '"' || c == '\\') {
+            trace.append('\\');
+            trace.append(c);
+        } else if ((unsigned char)c < 0x20) {
+            trace.append(QString("\\u%1").arg((int)(unsigned char)c, 4, 16, QChar('0')).toLatin1());
+        } else {
+            trace.append(c);
+        }
+    }
+    trace.append('"');
+}
+
+// static
+QByteArray PerformanceTimer::getChromeTrace() {
+    QMutexLocker locker(&collectorMutex);
+
+    QByteArray trace;
+    trace.reserve(traceEvents.size() * 96);
+    trace.append("{\"traceEvents\":[");
+
+    qint64 pid = QCoreApplication::applicationPid();
+    bool isFirst = true;
+    QHashIterator<int, QString> threadName(traceThreadNames);
+    while (threadName.hasNext()) {
+        threadName.next();
+        trace.append(isFirst ? "\n" : ",\n");
+        isFirst = false;
+        trace.append(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%1,\"tid\":%2,\"args\":{\"name\":")
+            .arg(pid).arg(threadName.key()).toUtf8());
+        appendJSONString(trace, threadName.value().toUtf8().constData());
+        trace.append("}}");
+    }
+
+    // oldest first, the ring wraps at nextTraceEvent once it is full
+    int firstEvent = (traceEvents.size() < MAX_TRACE_EVENTS) ? 0 : nextTraceEvent;
+    for (int i = 0; i < traceEvents.size(); i++) {
+        const PerformanceTimerTraceEvent& event = traceEvents[(firstEvent + i) % traceEvents.size()];
+        trace.append(isFirst ? "\n" : ",\n");
+        isFirst = false;
+        trace.append("{\"name\":");
+        appendJSONString(trace, timerNames[event.nameID].load());
+        trace.append(",\"ph\":\"X\",\"pid\":");
+        trace.append(QByteArray::number(pid));
+        trace.append(",\"tid\":");
+        trace.append(QByteArray::number(event.threadIndex));
+        trace.append(",\"ts\":");
+        trace.append(QByteArray::number(event.start));
+        trace.append(",\"dur\":");
+        trace.append(QByteArray::number(event.end - event.start));
+        trace.append("}");
+    }
+
+    trace.append("\n]}\n");
+    return trace;
+}
+
+// static
+bool PerformanceTimer::writeChromeTrace(const QString& filename) {
+    QFile traceFile(filename);
+    if (!traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCDebug(shared) << "PerformanceTimer could not open" << filename << "to write a trace";
+        return false;
+    }
+    traceFile.write(getChromeTrace());
+    return true;
+}
@@ -71,26 +71,41 @@ private:
     SimpleMovingAverage _movingAverage;
 };
 
+class PerformanceTimerThread;
+
+/// Times the scope it lives in. Scopes are recorded into a preallocated ring per thread without taking any lock, they
+/// only become timer records (and trace events) when tallyAllTimerRecords() collects them.
 class PerformanceTimer {
 public:
 
+    /// name must stay valid for the life of the program, a string literal is the common case and the cheapest,
+    /// since literals are looked up by address
+    PerformanceTimer(const char* name);
     PerformanceTimer(const QString& name);
     ~PerformanceTimer();
+
+    /// a copy of name that lives as long as the program, the same for equal names. Scopes timed often under a name
+    /// that isn't a literal intern it once and pass the copy to the const char* constructor, which takes no lock.
+    static const char* internName(const QString& name);
     
     static bool isActive();
     static void setActive(bool active);
     
-    static const PerformanceTimerRecord& getTimerRecord(const QString& name) { return _records[name]; };
-    static const QMap<QString, PerformanceTimerRecord>& getAllTimerRecords() { return _records; };
+    static PerformanceTimerRecord getTimerRecord(const QString& name);
+    static QMap<QString, PerformanceTimerRecord> getAllTimerRecords();
     static void tallyAllTimerRecords();
     static void dumpAllTimerRecords();
 
+    /// the most recent scopes collected by tallyAllTimerRecords() as Chrome trace_event JSON, for chrome://tracing
+    static QByteArray getChromeTrace();
+    static bool writeChromeTrace(const QString& filename);
+
 private:
-    quint64 _start = 0;
-    QString _name;
+    void begin(int nameID);
+
+    PerformanceTimerThread* _thread = nullptr;
+    int _nameID = 0;
     static std::atomic<bool> _isActive;
-    static QHash<QThread*, QString> _fullNames;
-    static QMap<QString, PerformanceTimerRecord> _records;
 };
 
 
@@ -0,0 +1,106 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Created on 2015-06-09.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t readLittleEndian64(const unsigned char* bytes) {
+    return (uint64_t)bytes[0] | ((uint64_t)bytes[1] << 8) | ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24)
+        | ((uint64_t)bytes[4] << 32) | ((uint64_t)bytes[5] << 40) | ((uint64_t)bytes[6] << 48) | ((uint64_t)bytes[7] << 56);
+}
+
+static inline void writeLittleEndian64(uint64_t value, unsigned char* bytes) {
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1;
+    v1 = rotateLeft(v1, 13);
+    v1 ^= v0;
+    v0 = rotateLeft(v0, 32);
+    v2 += v3;
+    v3 = rotateLeft(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotateLeft(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotateLeft(v1, 17);
+    v1 ^= v2;
+    v2 = rotateLeft(v2, 32);
+}
+
+static void sipHash(const unsigned char* key, const unsigned char* data, size_t length,
+                    unsigned char* result, int resultBytes) {
+    const int COMPRESSION_ROUNDS = 2;
+    const int FINALIZATION_ROUNDS = 4;
+
+    uint64_t k0 = readLittleEndian64(key);
+    uint64_t k1 = readLittleEndian64(key + 8);
+
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+    if (resultBytes == SIPHASH_128_BYTES) {
+        v1 ^= 0xee;
+    }
+
+    const unsigned char* end = data + (length - (length % 8));
+    for (const unsigned char* word = data; word != end; word += 8) {
+        uint64_t m = readLittleEndian64(word);
+        v3 ^= m;
+        for (int i = 0; i < COMPRESSION_ROUNDS; i++) {
+            sipRound(v0, v1, v2, v3);
+        }
+        v0 ^= m;
+    }
+
+    // the last word holds the remaining bytes and the low byte of the length
+    uint64_t lastWord = ((uint64_t)length) << 56;
+    for (size_t i = 0; i < length % 8; i++) {
+        lastWord |= ((uint64_t)end[i]) << (8 * i);
+    }
+
+    v3 ^= lastWord;
+    for (int i = 0; i < COMPRESSION_ROUNDS; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    v0 ^= lastWord;
+
+    v2 ^= (resultBytes == SIPHASH_128_BYTES) ? 0xee : 0xff;
+    for (int i = 0; i < FINALIZATION_ROUNDS; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian64(v0 ^ v1 ^ v2 ^ v3, result);
+
+    if (resultBytes == SIPHASH_128_BYTES) {
+        v1 ^= 0xdd;
+        for (int i = 0; i < FINALIZATION_ROUNDS; i++) {
+            sipRound(v0, v1, v2, v3);
+        }
+        writeLittleEndian64(v0 ^ v1 ^ v2 ^ v3, result + 8);
+    }
+}
+
+void sipHash64(const unsigned char* key, const unsigned char* data, size_t length, unsigned char* result) {
+    sipHash(key, data, length, result, SIPHASH_64_BYTES);
+}
+
+void sipHash128(const unsigned char* key, const unsigned char* data, size_t length, unsigned char* result) {
+    sipHash(key, data, length, result, SIPHASH_128_BYTES);
+}
@@ -0,0 +1,30 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Created on 2015-06-09.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  SipHash-2-4 keyed hash, see https://131002.net/siphash/
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <cstddef>
+#include <cstdint>
+
+const int SIPHASH_KEY_BYTES = 16;
+const int SIPHASH_64_BYTES = 8;
+const int SIPHASH_128_BYTES = 16;
+
+/// hashes length bytes of data with a 16 byte key, writing the 8 byte hash to result
+void sipHash64(const unsigned char* key, const unsigned char* data, size_t length, unsigned char* result);
+
+/// hashes length bytes of data with a 16 byte key, writing the 16 byte hash to result
+void sipHash128(const unsigned char* key, const unsigned char* data, size_t length, unsigned char* result);
+
+#endif // hifi_SipHash_h
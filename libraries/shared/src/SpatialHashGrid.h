@@ -0,0 +1,202 @@
+//
+//  SpatialHashGrid.h
+//  libraries/shared/src
+//
+//  Created on 2015-06-04.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Uniform grid of positioned values, hashed by cell, meant to be rebuilt once per frame so that
+//  "who is near me" questions only visit the cells around a position instead of every value.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SpatialHashGrid_h
+#define hifi_SpatialHashGrid_h
+
+#include <cassert>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtGlobal>
+
+template <typename T>
+class SpatialHashGrid {
+public:
+    class Cell {
+    public:
+        glm::vec3 corner;
+        int numEntries;
+
+    private:
+        friend class SpatialHashGrid<T>;
+        int firstEntry;
+    };
+
+    SpatialHashGrid(float cellSize) : _cellSize(cellSize), _inverseCellSize(1.0f / cellSize) { assert(cellSize > 0.0f); }
+
+    float getCellSize() const { return _cellSize; }
+    int getNumEntries() const { return (int)_entries.size(); }
+    int getNumCells() const { return (int)_cells.size(); }
+
+    /// removes every value but keeps the allocated storage around for the next frame
+    void clear() {
+        _entries.clear();
+        _cells.clear();
+        _cellIndices.clear();
+    }
+
+    void insert(const glm::vec3& position, const T& value) {
+        glm::ivec3 cellCoordinates = cellCoordinatesForPosition(position);
+        quint64 key = keyForCellCoordinates(cellCoordinates);
+
+        int cellIndex;
+        auto cellMatch = _cellIndices.find(key);
+        if (cellMatch == _cellIndices.end()) {
+            cellIndex = (int)_cells.size();
+            _cellIndices[key] = cellIndex;
+
+            Cell newCell;
+            newCell.corner = glm::vec3(cellCoordinates) * _cellSize;
+            newCell.numEntries = 0;
+            newCell.firstEntry = -1;
+            _cells.push_back(newCell);
+        } else {
+            cellIndex = cellMatch->second;
+        }
+
+        Cell& cell = _cells[cellIndex];
+
+        Entry entry = { position, value, cell.firstEntry, cellIndex };
+        cell.firstEntry = (int)_entries.size();
+        ++cell.numEntries;
+
+        _entries.push_back(entry);
+    }
+
+    /// distance from position to the closest point of the cell, zero if position is inside it
+    float getMinDistanceToCell(const glm::vec3& position, const Cell& cell) const {
+        glm::vec3 closestPoint = glm::clamp(position, cell.corner, cell.corner + glm::vec3(_cellSize));
+        return glm::length(position - closestPoint);
+    }
+
+    /// calls functor(const Cell&) for every occupied cell
+    template <typename F>
+    void eachCell(F functor) const {
+        for (auto& cell : _cells) {
+            functor(cell);
+        }
+    }
+
+    /// calls functor(const Cell&) for every occupied cell that intersects the sphere at center with radius
+    template <typename F>
+    void eachCellWithinRadius(const glm::vec3& center, float radius, F functor) const {
+        // if the sphere covers more cells than we have occupied it is cheaper to just test the occupied ones
+        float cellsAcross = (2.0f * radius * _inverseCellSize) + 1.0f;
+        if (cellsAcross * cellsAcross * cellsAcross > (float)_cells.size()) {
+            for (auto& cell : _cells) {
+                if (getMinDistanceToCell(center, cell) <= radius) {
+                    functor(cell);
+                }
+            }
+            return;
+        }
+
+        glm::ivec3 minimum = cellCoordinatesForPosition(center - glm::vec3(radius));
+        glm::ivec3 maximum = cellCoordinatesForPosition(center + glm::vec3(radius));
+
+        for (int x = minimum.x; x <= maximum.x; ++x) {
+            for (int y = minimum.y; y <= maximum.y; ++y) {
+                for (int z = minimum.z; z <= maximum.z; ++z) {
+                    auto cellMatch = _cellIndices.find(keyForCellCoordinates(glm::ivec3(x, y, z)));
+                    if (cellMatch != _cellIndices.end()) {
+                        const Cell& cell = _cells[cellMatch->second];
+                        if (getMinDistanceToCell(center, cell) <= radius) {
+                            functor(cell);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /// calls functor(const T& value, const glm::vec3& position) for every value in the cell,
+    /// stopping early if the functor returns false
+    template <typename F>
+    void eachEntryInCell(const Cell& cell, F functor) const {
+        for (int entryIndex = cell.firstEntry; entryIndex != -1; entryIndex = _entries[entryIndex].next) {
+            const Entry& entry = _entries[entryIndex];
+            if (!functor(entry.value, entry.position)) {
+                break;
+            }
+        }
+    }
+
+    /// calls functor(const T& value, const glm::vec3& position, const Cell& cell) for numEntries values in insertion
+    /// order, starting at firstEntry and wrapping around, so that a random firstEntry gives a sample whose cost doesn't
+    /// depend on how the values are spread over the cells
+    template <typename F>
+    void eachEntryFrom(int firstEntry, int numEntries, F functor) const {
+        int size = (int)_entries.size();
+        assert(numEntries <= size && (size == 0 || (firstEntry >= 0 && firstEntry < size)));
+        int entryIndex = firstEntry;
+        for (int i = 0; i < numEntries; i++) {
+            const Entry& entry = _entries[entryIndex];
+            functor(entry.value, entry.position, _cells[entry.cell]);
+            if (++entryIndex == size) {
+                entryIndex = 0;
+            }
+        }
+    }
+
+    /// calls functor(const T& value, const glm::vec3& position, float distance) for every value within radius of center
+    template <typename F>
+    void eachWithinRadius(const glm::vec3& center, float radius, F functor) const {
+        eachCellWithinRadius(center, radius, [&](const Cell& cell) {
+            eachEntryInCell(cell, [&](const T& value, const glm::vec3& position)->bool {
+                float distance = glm::length(position - center);
+                if (distance <= radius) {
+                    functor(value, position, distance);
+                }
+                return true;
+            });
+        });
+    }
+
+private:
+    struct Entry {
+        glm::vec3 position;
+        T value;
+        int next;
+        int cell;
+    };
+
+    // keep cell coordinates inside the 21 bits per axis that fit in a key
+    static const int MAX_CELL_COORDINATE = (1 << 20) - 1;
+
+    glm::ivec3 cellCoordinatesForPosition(const glm::vec3& position) const {
+        glm::vec3 cellPosition = glm::clamp(glm::floor(position * _inverseCellSize),
+                                            glm::vec3((float)-MAX_CELL_COORDINATE),
+                                            glm::vec3((float)MAX_CELL_COORDINATE));
+        return glm::ivec3(cellPosition);
+    }
+
+    static quint64 keyForCellCoordinates(const glm::ivec3& cellCoordinates) {
+        const quint64 AXIS_MASK = (1 << 21) - 1;
+        return ((quint64)(cellCoordinates.x + MAX_CELL_COORDINATE) & AXIS_MASK)
+            | (((quint64)(cellCoordinates.y + MAX_CELL_COORDINATE) & AXIS_MASK) << 21)
+            | (((quint64)(cellCoordinates.z + MAX_CELL_COORDINATE) & AXIS_MASK) << 42);
+    }
+
+    float _cellSize;
+    float _inverseCellSize;
+
+    std::vector<Entry> _entries;
+    std::vector<Cell> _cells;
+    std::unordered_map<quint64, int> _cellIndices;
+};
+
+#endif // hifi_SpatialHashGrid_h
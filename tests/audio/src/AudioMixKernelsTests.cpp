@@ -0,0 +1,238 @@
+//
+//  AudioMixKernelsTests.cpp
+//  tests/audio/src
+//
+//  Created on 2015-06-23.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstring>
+
+#include <QDebug>
+
+#include <AudioConstants.h>
+#include <AudioFilterBank.h>
+#include <AudioMixKernels.h>
+#include <SharedUtil.h>
+
+#include "AudioMixKernelsTests.h"
+
+using namespace AudioMixKernels;
+
+static quint32 randomSeed = 12345;
+
+static int randomInt(int range) {
+    randomSeed = randomSeed * 1664525 + 1013904223;
+    return (int)((randomSeed >> 8) % range);
+}
+
+static int16_t randomSample() {
+    return (int16_t)(randomInt(1 << 16) - (1 << 15));
+}
+
+static float randomFloat(float minimum, float maximum) {
+    return minimum + (maximum - minimum) * randomInt(1 << 20) / (float)(1 << 20);
+}
+
+static void randomBiquad(Biquad& biquad) {
+    // a stable section, so the cascade neither blows up nor dies out over the test
+    biquad.a0 = randomFloat(0.0f, 1.0f);
+    biquad.a1 = randomFloat(-1.0f, 1.0f);
+    biquad.a2 = randomFloat(-0.5f, 0.5f);
+    biquad.b1 = randomFloat(-0.9f, 0.9f);
+    biquad.b2 = randomFloat(-0.4f, 0.4f);
+    biquad.xm1 = randomFloat(-0.5f, 0.5f);
+    biquad.xm2 = randomFloat(-0.5f, 0.5f);
+    biquad.ym1 = (randomInt(4) == 0) ? 0.0f : randomFloat(-0.5f, 0.5f);
+    biquad.ym2 = randomFloat(-EPSILON, EPSILON);
+}
+
+void AudioMixKernelsTests::runAllTests() {
+    bitExactnessTest();
+    filterBankTest();
+    mixBenchmark();
+}
+
+void AudioMixKernelsTests::bitExactnessTest() {
+    const int MAX_DELAY = 20;
+    const int MAX_SAMPLES = 1000;
+    const int NUM_TRIALS = 500;
+    const int NUM_STAGES = 3;
+    const float GAINS[] = { 0.0f, 1.0f, -1.0f, 2.0f, 0.5f, 0.999f };
+
+    InstructionSet supportedSet = getSupportedInstructionSet();
+    for (int set = SSE2; set <= supportedSet; set++) {
+        qDebug() << "testing" << getInstructionSetName((InstructionSet)set) << "kernels match the scalar ones...";
+        bool fail = false;
+
+        for (int trial = 0; trial < NUM_TRIALS && !fail; trial++) {
+            // odd lengths and offsets exercise the unaligned heads and the tails
+            int numSamples = randomInt(MAX_SAMPLES);
+            int offset = randomInt(8);
+            float gain = (trial < 6) ? GAINS[trial] : randomFloat(-2.0f, 2.0f);
+            float otherGain = randomFloat(0.0f, 1.5f);
+            int leftDelay = randomInt(MAX_DELAY + 1);
+            int rightDelay = (randomInt(2) == 0) ? 0 : randomInt(MAX_DELAY + 1);
+
+            int16_t source[MAX_DELAY + MAX_SAMPLES + 8];
+            int16_t scalarOutput[2 * MAX_SAMPLES + 8];
+            int16_t vectorOutput[2 * MAX_SAMPLES + 8];
+            for (int i = 0; i < MAX_DELAY + MAX_SAMPLES + 8; i++) {
+                source[i] = randomSample();
+            }
+            for (int i = 0; i < 2 * MAX_SAMPLES + 8; i++) {
+                scalarOutput[i] = vectorOutput[i] = randomSample();
+            }
+            const int16_t* delayedSource = source + MAX_DELAY + offset;
+
+            Biquad scalarLeft[NUM_STAGES], scalarRight[NUM_STAGES], vectorLeft[NUM_STAGES], vectorRight[NUM_STAGES];
+            for (int j = 0; j < NUM_STAGES; j++) {
+                randomBiquad(scalarLeft[j]);
+                randomBiquad(scalarRight[j]);
+                vectorLeft[j] = scalarLeft[j];
+                vectorRight[j] = scalarRight[j];
+            }
+            int numFrames = numSamples / 2;
+            int16_t scalarFiltered[MAX_SAMPLES];
+            int16_t vectorFiltered[MAX_SAMPLES];
+
+            setInstructionSet(Scalar);
+            accumulate(scalarOutput + offset, delayedSource, numSamples);
+            accumulateWithGain(scalarOutput + offset, delayedSource, gain, numSamples);
+            spreadMonoToStereo(scalarOutput, delayedSource, numSamples, gain, leftDelay, otherGain, rightDelay);
+            renderBiquadCascadeStereo(scalarLeft, scalarRight, NUM_STAGES, source, scalarFiltered, numFrames, 65536.0f);
+
+            setInstructionSet((InstructionSet)set);
+            accumulate(vectorOutput + offset, delayedSource, numSamples);
+            accumulateWithGain(vectorOutput + offset, delayedSource, gain, numSamples);
+            spreadMonoToStereo(vectorOutput, delayedSource, numSamples, gain, leftDelay, otherGain, rightDelay);
+            renderBiquadCascadeStereo(vectorLeft, vectorRight, NUM_STAGES, source, vectorFiltered, numFrames, 65536.0f);
+
+            fail = memcmp(scalarOutput, vectorOutput, sizeof(scalarOutput)) != 0 ||
+                memcmp(scalarFiltered, vectorFiltered, numFrames * 2 * sizeof(int16_t)) != 0 ||
+                memcmp(scalarLeft, vectorLeft, sizeof(scalarLeft)) != 0 ||
+                memcmp(scalarRight, vectorRight, sizeof(scalarRight)) != 0;
+            if (fail) {
+                qDebug() << "\t mismatch in trial" << trial << "with" << numSamples << "samples";
+            }
+        }
+        setInstructionSet(supportedSet);
+
+        qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+    }
+}
+
+void AudioMixKernelsTests::filterBankTest() {
+    qDebug() << "testing stereo filter bank matches its channels filtered one by one...";
+    bool fail = false;
+
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    const int NUM_BLOCKS = 20;
+    const float SCALE = 65536.0f;
+
+    AudioFilterHSF1s filterBank;
+    filterBank.initialize(AudioConstants::SAMPLE_RATE, NUM_FRAMES);
+    AudioFilterHSF channels[2];
+    for (int i = 0; i < 2; i++) {
+        float gain = (i == 0) ? 0.891f : 0.708f;
+        filterBank.setParameters(0, i, AudioConstants::SAMPLE_RATE, 1000.0f, gain, 0.708f);
+        channels[i].setParameters(AudioConstants::SAMPLE_RATE, 1000.0f, gain, 0.708f);
+    }
+
+    // several blocks, so the delay lines are carried across renders
+    for (int block = 0; block < NUM_BLOCKS && !fail; block++) {
+        int16_t input[2 * NUM_FRAMES];
+        for (int i = 0; i < 2 * NUM_FRAMES; i++) {
+            input[i] = randomSample();
+        }
+        int16_t output[2 * NUM_FRAMES];
+        filterBank.render(input, output, NUM_FRAMES);
+
+        for (int i = 0; i < 2 && !fail; i++) {
+            float samples[NUM_FRAMES];
+            for (int j = 0; j < NUM_FRAMES; j++) {
+                samples[j] = ((float)input[2 * j + i]) / SCALE;
+            }
+            channels[i].render(samples, samples, NUM_FRAMES);
+            for (int j = 0; j < NUM_FRAMES; j++) {
+                fail = fail || output[2 * j + i] != (int16_t)(samples[j] * SCALE);
+            }
+        }
+    }
+    filterBank.finalize();
+
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+/// The per source loops of the mixer before the kernels: a mono source spread with the right channel delayed, then the
+/// clamped add into the mix.
+static void mixMonoSourceLoops(int16_t* preMix, int16_t* mix, const int16_t* source, float leftGain, float rightGain,
+                               int numSamplesDelay) {
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    int rightIndex = 1 + 2 * numSamplesDelay;
+    int historyIndex = 1;
+    for (int i = 0; i < numSamplesDelay; i++) {
+        preMix[historyIndex] += source[i - numSamplesDelay] * rightGain;
+        historyIndex += 2;
+    }
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        preMix[2 * i] += (int16_t)(source[i] * leftGain);
+        if (rightIndex <= AudioConstants::NETWORK_FRAME_SAMPLES_STEREO) {
+            preMix[rightIndex] += (int16_t)(source[i] * rightGain);
+        }
+        rightIndex += 2;
+    }
+    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
+        int sample = mix[s] + preMix[s];
+        mix[s] = (int16_t)(sample < AudioConstants::MIN_SAMPLE_VALUE ? AudioConstants::MIN_SAMPLE_VALUE :
+            (sample > AudioConstants::MAX_SAMPLE_VALUE ? AudioConstants::MAX_SAMPLE_VALUE : sample));
+    }
+}
+
+static void mixMonoSourceKernels(int16_t* preMix, int16_t* mix, const int16_t* source, float leftGain, float rightGain,
+                                 int numSamplesDelay) {
+    spreadMonoToStereo(preMix, source, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, leftGain, 0, rightGain,
+                       numSamplesDelay);
+    accumulate(mix, preMix, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+}
+
+void AudioMixKernelsTests::mixBenchmark() {
+    const int NUM_SOURCES = 200000;
+    const int MAX_DELAY = 20;
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+    int16_t source[MAX_DELAY + NUM_FRAMES];
+    for (int i = 0; i < MAX_DELAY + NUM_FRAMES; i++) {
+        source[i] = randomSample() / 8;
+    }
+    int16_t preMix[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + 2 * MAX_DELAY];
+    int16_t mix[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + 2 * MAX_DELAY];
+    memset(mix, 0, sizeof(mix));
+
+    qDebug() << "mixing" << NUM_SOURCES << "mono sources of" << NUM_FRAMES << "frames with phase delay";
+
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < NUM_SOURCES; i++) {
+        memset(preMix, 0, sizeof(preMix));
+        mixMonoSourceLoops(preMix, mix, source + MAX_DELAY, 0.5f, 0.25f, i % MAX_DELAY);
+    }
+    quint64 loopsElapsed = usecTimestampNow() - start;
+    qDebug() << "\t previous mixer loops:" << (float)loopsElapsed / NUM_SOURCES << "usecs per source";
+
+    InstructionSet supportedSet = getSupportedInstructionSet();
+    for (int set = Scalar; set <= supportedSet; set++) {
+        setInstructionSet((InstructionSet)set);
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_SOURCES; i++) {
+            memset(preMix, 0, sizeof(preMix));
+            mixMonoSourceKernels(preMix, mix, source + MAX_DELAY, 0.5f, 0.25f, i % MAX_DELAY);
+        }
+        quint64 elapsed = usecTimestampNow() - start;
+        qDebug() << "\t" << getInstructionSetName((InstructionSet)set) << "kernels:" << (float)elapsed / NUM_SOURCES
+            << "usecs per source";
+    }
+    setInstructionSet(supportedSet);
+}
@@ -0,0 +1,76 @@
+//
+//  AvatarDataTests.cpp
+//  tests/avatars/src
+//
+//  Created on 2015-06-20.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AvatarData.h>
+
+#include "AvatarDataTests.h"
+
+const int NUM_JOINTS = 20;
+const int MOVED_JOINT = 7;
+
+static bool receivedRotation(AvatarData& receiver, const glm::quat& expected) {
+    return fabsf(glm::dot(receiver.getJointRotation(MOVED_JOINT), expected)) >= AVATAR_MIN_JOINT_ROTATION_DOT;
+}
+
+// a joint turns in one packet and turns back in the next, which has to be a delta for the return to be at risk
+static void testJointReverts(bool turnInFullSend) {
+    qDebug() << "testing a joint that turns and turns back reaches the receiver, turning in a"
+        << (turnInFullSend ? "full send..." : "delta...");
+    bool fail = false;
+
+    AvatarData sender;
+    AvatarData receiver;
+    glm::quat rest;
+    glm::quat turned = glm::angleAxis(0.5f, glm::vec3(1.0f, 0.0f, 0.0f));
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        sender.setJointData(i, rest);
+    }
+
+    // the first packet is a keyframe
+    receiver.parseDataAtOffset(sender.toByteArray(), 0);
+    if (!receivedRotation(receiver, rest)) {
+        qDebug() << "\t\t the keyframe didn't carry the rest rotation";
+        fail = true;
+    }
+
+    sender.setJointData(MOVED_JOINT, turned);
+    receiver.parseDataAtOffset(sender.toByteArray(turnInFullSend), 0);
+    if (!receivedRotation(receiver, turned)) {
+        qDebug() << "\t\t the turned rotation didn't arrive";
+        fail = true;
+    }
+
+    sender.setJointData(MOVED_JOINT, rest);
+    receiver.parseDataAtOffset(sender.toByteArray(), 0);
+    if (!receivedRotation(receiver, rest)) {
+        qDebug() << "\t\t the receiver kept the turned rotation";
+        fail = true;
+    }
+
+    // and nothing else moved along the way
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        if (i != MOVED_JOINT && fabsf(glm::dot(receiver.getJointRotation(i), rest)) < AVATAR_MIN_JOINT_ROTATION_DOT) {
+            qDebug() << "\t\t joint" << i << "moved";
+            fail = true;
+        }
+    }
+
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+void AvatarDataTests::runAllTests() {
+    testJointReverts(false);
+    testJointReverts(true);
+}
@@ -0,0 +1,19 @@
+//
+//  AvatarDataTests.h
+//  tests/avatars/src
+//
+//  Created on 2015-06-20.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarDataTests_h
+#define hifi_AvatarDataTests_h
+
+namespace AvatarDataTests {
+    void runAllTests();
+}
+
+#endif // hifi_AvatarDataTests_h
@@ -0,0 +1,16 @@
+//
+//  main.cpp
+//  tests/avatars/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarDataTests.h"
+
+int main(int argc, char** argv) {
+    AvatarDataTests::runAllTests();
+    return 0;
+}
@@ -0,0 +1,95 @@
+//
+//  ClusterMatrixBenchmarks.cpp
+//  tests/fbx/src
+//
+//  Created on 2015-06-25.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#include <FBXReader.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "ClusterMatrixBenchmarks.h"
+
+// the cluster matrix update of Model::simulateInternal, on the default avatar's body in its default pose
+void ClusterMatrixBenchmarks::runAllTests() {
+    QDir path(__FILE__);
+    path.cdUp();
+    QString fileName = path.cleanPath(path.absoluteFilePath("../../../interface/resources/meshes/defaultAvatar/body.fbx"));
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "couldn't open" << fileName << "skipping cluster matrix benchmark";
+        return;
+    }
+    FBXGeometry geometry = readFBX(file.readAll(), QVariantHash());
+
+    QVector<glm::mat4> jointTransforms;
+    foreach (const FBXJoint& joint, geometry.joints) {
+        jointTransforms.append(joint.transform);
+    }
+    glm::mat4 modelToWorld = glm::mat4_cast(glm::angleAxis(PI_OVER_TWO, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+    // what Model keeps for each mesh
+    QVector<QVector<glm::mat4> > clusterMatrices;
+    QVector<QVector<int> > clusterJointIndices;
+    QVector<QVector<glm::mat4> > inverseBindMatrices;
+    int numClusters = 0;
+    foreach (const FBXMesh& mesh, geometry.meshes) {
+        clusterMatrices.append(QVector<glm::mat4>(mesh.clusters.size()));
+        QVector<int> jointIndices;
+        QVector<glm::mat4> matrices;
+        foreach (const FBXCluster& cluster, mesh.clusters) {
+            jointIndices.append(cluster.jointIndex);
+            matrices.append(cluster.inverseBindMatrix);
+        }
+        clusterJointIndices.append(jointIndices);
+        inverseBindMatrices.append(matrices);
+        numClusters += mesh.clusters.size();
+    }
+    qDebug() << "cluster matrix benchmark:" << geometry.joints.size() << "joints," << geometry.meshes.size()
+        << "meshes," << numClusters << "clusters";
+
+    const int NUM_ITERATIONS = 10000;
+
+    // the previous path: three matrices multiplied for each cluster of each mesh
+    quint64 start = usecTimestampNow();
+    for (int iteration = 0; iteration < NUM_ITERATIONS; iteration++) {
+        for (int i = 0; i < geometry.meshes.size(); i++) {
+            const FBXMesh& mesh = geometry.meshes.at(i);
+            QVector<glm::mat4>& matrices = clusterMatrices[i];
+            for (int j = 0; j < mesh.clusters.size(); j++) {
+                const FBXCluster& cluster = mesh.clusters.at(j);
+                matrices[j] = modelToWorld * jointTransforms.at(cluster.jointIndex) * cluster.inverseBindMatrix;
+            }
+        }
+    }
+    quint64 previousElapsed = usecTimestampNow() - start;
+    QVector<QVector<glm::mat4> > expectedMatrices = clusterMatrices;
+
+    // a palette of joints transformed once, then one batch multiply for each mesh
+    QVector<glm::mat4> jointPalette(jointTransforms.size());
+    start = usecTimestampNow();
+    for (int iteration = 0; iteration < NUM_ITERATIONS; iteration++) {
+        for (int i = 0; i < jointTransforms.size(); i++) {
+            jointPalette[i] = modelToWorld * jointTransforms.at(i);
+        }
+        for (int i = 0; i < geometry.meshes.size(); i++) {
+            multiplyPaletteMatrices(jointPalette.constData(), clusterJointIndices.at(i).constData(),
+                inverseBindMatrices.at(i).constData(), clusterMatrices[i].data(), clusterMatrices.at(i).size());
+        }
+    }
+    quint64 paletteElapsed = usecTimestampNow() - start;
+
+    qDebug() << "\t per cluster (previous path):" << (float)previousElapsed / NUM_ITERATIONS << "usecs";
+    qDebug() << "\t joint palette:" << (float)paletteElapsed / NUM_ITERATIONS << "usecs";
+    qDebug() << "\t\t" << ((clusterMatrices == expectedMatrices) ? "PASS" : "FAIL for differing cluster matrices");
+}
@@ -0,0 +1,19 @@
+//
+//  ClusterMatrixBenchmarks.h
+//  tests/fbx/src
+//
+//  Created on 2015-06-25.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ClusterMatrixBenchmarks_h
+#define hifi_ClusterMatrixBenchmarks_h
+
+namespace ClusterMatrixBenchmarks {
+    void runAllTests();
+}
+
+#endif // hifi_ClusterMatrixBenchmarks_h
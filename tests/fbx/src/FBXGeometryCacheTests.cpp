@@ -0,0 +1,198 @@
+//
+//  FBXGeometryCacheTests.cpp
+//  tests/fbx/src
+//
+//  Created on 2015-06-19.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+
+#include <FBXGeometryCache.h>
+#include <SharedUtil.h>
+
+#include "FBXGeometryCacheTests.h"
+
+static QStringList getSampleModels() {
+    QDir path(__FILE__);
+    path.cdUp();
+    QString resourcesDir = path.cleanPath(path.absoluteFilePath("../../../interface/resources/"));
+
+    QStringList models;
+    QDirIterator iterator(resourcesDir, QStringList() << "*.fbx", QDir::Files, QDirIterator::Subdirectories);
+    while (iterator.hasNext()) {
+        models.append(iterator.next());
+    }
+    return models;
+}
+
+static QByteArray readModel(const QString& fileName) {
+    QFile file(fileName);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+static bool texturesEqual(const FBXTexture& first, const FBXTexture& second) {
+    return first.name == second.name && first.filename == second.filename && first.content == second.content &&
+        first.transform.getTranslation() == second.transform.getTranslation() &&
+        first.transform.getRotation() == second.transform.getRotation() &&
+        first.transform.getScale() == second.transform.getScale() && first.texcoordSet == second.texcoordSet;
+}
+
+static bool meshesEqual(const FBXMesh& first, const FBXMesh& second) {
+    if (first.parts.size() != second.parts.size() || first.clusters.size() != second.clusters.size() ||
+            first.blendshapes.size() != second.blendshapes.size()) {
+        return false;
+    }
+    for (int i = 0; i < first.parts.size(); i++) {
+        const FBXMeshPart& firstPart = first.parts.at(i);
+        const FBXMeshPart& secondPart = second.parts.at(i);
+        if (firstPart.quadIndices != secondPart.quadIndices || firstPart.triangleIndices != secondPart.triangleIndices ||
+                firstPart.diffuseColor != secondPart.diffuseColor || firstPart.opacity != secondPart.opacity ||
+                firstPart.materialID != secondPart.materialID || !firstPart._material != !secondPart._material ||
+                !texturesEqual(firstPart.diffuseTexture, secondPart.diffuseTexture) ||
+                !texturesEqual(firstPart.normalTexture, secondPart.normalTexture)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < first.clusters.size(); i++) {
+        if (first.clusters.at(i).jointIndex != second.clusters.at(i).jointIndex ||
+                first.clusters.at(i).inverseBindMatrix != second.clusters.at(i).inverseBindMatrix) {
+            return false;
+        }
+    }
+    for (int i = 0; i < first.blendshapes.size(); i++) {
+        if (first.blendshapes.at(i).indices != second.blendshapes.at(i).indices ||
+                first.blendshapes.at(i).vertices != second.blendshapes.at(i).vertices ||
+                first.blendshapes.at(i).normals != second.blendshapes.at(i).normals) {
+            return false;
+        }
+    }
+    return first.vertices == second.vertices && first.normals == second.normals && first.tangents == second.tangents &&
+        first.colors == second.colors && first.texCoords == second.texCoords && first.texCoords1 == second.texCoords1 &&
+        first.clusterIndices == second.clusterIndices && first.clusterWeights == second.clusterWeights &&
+        first.meshExtents.minimum == second.meshExtents.minimum && first.meshExtents.maximum == second.meshExtents.maximum &&
+        first.modelTransform == second.modelTransform && first.isEye == second.isEye &&
+        first.meshIndex == second.meshIndex && first._mesh.getNumVertices() == second._mesh.getNumVertices() &&
+        first._mesh.getNumIndices() == second._mesh.getNumIndices();
+}
+
+static bool geometriesEqual(const FBXGeometry& first, const FBXGeometry& second) {
+    if (first.joints.size() != second.joints.size() || first.meshes.size() != second.meshes.size()) {
+        return false;
+    }
+    for (int i = 0; i < first.joints.size(); i++) {
+        const FBXJoint& firstJoint = first.joints.at(i);
+        const FBXJoint& secondJoint = second.joints.at(i);
+        if (firstJoint.name != secondJoint.name || firstJoint.parentIndex != secondJoint.parentIndex ||
+                firstJoint.freeLineage != secondJoint.freeLineage || firstJoint.rotation != secondJoint.rotation ||
+                firstJoint.bindTransform != secondJoint.bindTransform || firstJoint.boneRadius != secondJoint.boneRadius) {
+            return false;
+        }
+    }
+    for (int i = 0; i < first.meshes.size(); i++) {
+        if (!meshesEqual(first.meshes.at(i), second.meshes.at(i))) {
+            return false;
+        }
+    }
+    return first.author == second.author && first.jointIndices == second.jointIndices &&
+        first.offset == second.offset && first.headJointIndex == second.headJointIndex &&
+        first.rightToeJointIndex == second.rightToeJointIndex &&
+        first.humanIKJointIndices == second.humanIKJointIndices && first.sittingPoints == second.sittingPoints &&
+        first.bindExtents.minimum == second.bindExtents.minimum && first.meshExtents.maximum == second.meshExtents.maximum &&
+        first.meshIndicesToModelNames == second.meshIndicesToModelNames &&
+        first.blendshapeChannelNames == second.blendshapeChannelNames;
+}
+
+void FBXGeometryCacheTests::runAllTests() {
+    geometryRoundTrip();
+    geometryCacheBenchmark();
+}
+
+void FBXGeometryCacheTests::geometryRoundTrip() {
+    qDebug() << "testing geometry cache entries read back as written...";
+
+    QStringList models = getSampleModels();
+    bool fail = models.isEmpty();
+    foreach (const QString& fileName, models) {
+        FBXGeometry geometry = readFBX(readModel(fileName), QVariantHash());
+        QByteArray entry = writeFBXGeometry(geometry);
+
+        FBXGeometry readGeometry;
+        if (!readFBXGeometry(entry.constData(), entry.size(), readGeometry) || !geometriesEqual(geometry, readGeometry)) {
+            qDebug() << "\t" << fileName << "reads back differently";
+            fail = true;
+        }
+
+        // a cut short or stale entry is refused rather than read
+        FBXGeometry truncatedGeometry;
+        if (readFBXGeometry(entry.constData(), entry.size() - 1, truncatedGeometry)) {
+            qDebug() << "\t" << fileName << "reads with its last byte cut off";
+            fail = true;
+        }
+        QByteArray otherVersion = entry;
+        otherVersion[4] = otherVersion[4] + 1;
+        if (readFBXGeometry(otherVersion.constData(), otherVersion.size(), truncatedGeometry)) {
+            qDebug() << "\t" << fileName << "reads under another version";
+            fail = true;
+        }
+    }
+
+    // the key covers the mapping, whatever order its hash happens to iterate in
+    QByteArray model = "model";
+    QVariantHash mapping;
+    mapping.insert("scale", 0.5);
+    mapping.insert("joint", QVariantHash());
+    QVariantHash sameMapping;
+    sameMapping.insert("joint", QVariantHash());
+    sameMapping.insert("scale", 0.5);
+    QVariantHash otherMapping = mapping;
+    otherMapping.insert("scale", 0.25);
+    QByteArray key = FBXGeometryCache::getKey(model, mapping, true, 1.0f);
+    fail = fail || key != FBXGeometryCache::getKey(model, sameMapping, true, 1.0f)
+        || key == FBXGeometryCache::getKey(model, otherMapping, true, 1.0f)
+        || key == FBXGeometryCache::getKey(model, mapping, false, 1.0f)
+        || key == FBXGeometryCache::getKey("other", mapping, true, 1.0f);
+
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+void FBXGeometryCacheTests::geometryCacheBenchmark() {
+    const int NUM_ITERATIONS = 20;
+
+    QString directory = QDir::temp().filePath("fbx-tests-geometry-cache");
+    QDir(directory).removeRecursively();
+    FBXGeometryCache::setCacheDirectory(directory);
+
+    foreach (const QString& fileName, getSampleModels()) {
+        QByteArray model = readModel(fileName);
+
+        quint64 start = usecTimestampNow();
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            readFBX(model, QVariantHash());
+        }
+        quint64 readElapsed = usecTimestampNow() - start;
+
+        // the first read misses and stores the entry, the rest load it
+        readCachedFBX(model, QVariantHash());
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            readCachedFBX(model, QVariantHash());
+        }
+        quint64 cachedElapsed = usecTimestampNow() - start;
+
+        qDebug() << "reading" << QFileInfo(fileName).fileName() << "," << model.size() << "bytes";
+        qDebug() << "\t parse + extraction:" << (float)readElapsed / NUM_ITERATIONS << "usecs";
+        qDebug() << "\t hash + cache entry load:" << (float)cachedElapsed / NUM_ITERATIONS << "usecs";
+    }
+
+    FBXGeometryCache::setCacheDirectory(QString());
+    QDir(directory).removeRecursively();
+}
@@ -0,0 +1,23 @@
+//
+//  FBXGeometryCacheTests.h
+//  tests/fbx/src
+//
+//  Created on 2015-06-19.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXGeometryCacheTests_h
+#define hifi_FBXGeometryCacheTests_h
+
+namespace FBXGeometryCacheTests {
+
+    void runAllTests();
+
+    void geometryRoundTrip();
+    void geometryCacheBenchmark();
+}
+
+#endif // hifi_FBXGeometryCacheTests_h
@@ -0,0 +1,296 @@
+//
+//  FBXReaderTests.cpp
+//  tests/fbx/src
+//
+//  Created on 2015-06-18.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+
+#include <FBXReader.h>
+#include <SharedUtil.h>
+
+#include "FBXReaderTests.h"
+
+// the binary parser as it was before it read from memory, streaming every value through a QDataStream, to check the
+// new one against and to time it against
+
+template<class T> int streamSize() {
+    return sizeof(T);
+}
+
+template<bool> int streamSize() {
+    return 1;
+}
+
+template<class T> QVariant streamBinaryArray(QDataStream& in, int& position) {
+    quint32 arrayLength;
+    quint32 encoding;
+    quint32 compressedLength;
+
+    in >> arrayLength;
+    in >> encoding;
+    in >> compressedLength;
+    position += sizeof(quint32) * 3;
+
+    QVector<T> values;
+    const unsigned int DEFLATE_ENCODING = 1;
+    if (encoding == DEFLATE_ENCODING) {
+        QByteArray compressed(sizeof(quint32) + compressedLength, 0);
+        *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
+        in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
+        position += compressedLength;
+        QByteArray uncompressed = qUncompress(compressed);
+        QDataStream uncompressedIn(uncompressed);
+        uncompressedIn.setByteOrder(QDataStream::LittleEndian);
+        uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
+        for (quint32 i = 0; i < arrayLength; i++) {
+            T value;
+            uncompressedIn >> value;
+            values.append(value);
+        }
+    } else {
+        for (quint32 i = 0; i < arrayLength; i++) {
+            T value;
+            in >> value;
+            position += streamSize<T>();
+            values.append(value);
+        }
+    }
+    return QVariant::fromValue(values);
+}
+
+template<class T> QVariant streamBinaryValue(QDataStream& in, int& position) {
+    T value;
+    in >> value;
+    position += streamSize<T>();
+    return QVariant::fromValue(value);
+}
+
+static QVariant streamBinaryProperty(QDataStream& in, int& position) {
+    char ch;
+    in.device()->getChar(&ch);
+    position++;
+    switch (ch) {
+        case 'Y': return streamBinaryValue<qint16>(in, position);
+        case 'C': return streamBinaryValue<bool>(in, position);
+        case 'I': return streamBinaryValue<qint32>(in, position);
+        case 'F': return streamBinaryValue<float>(in, position);
+        case 'D': return streamBinaryValue<double>(in, position);
+        case 'L': return streamBinaryValue<qint64>(in, position);
+        case 'f': return streamBinaryArray<float>(in, position);
+        case 'd': return streamBinaryArray<double>(in, position);
+        case 'l': return streamBinaryArray<qint64>(in, position);
+        case 'i': return streamBinaryArray<qint32>(in, position);
+        case 'b': return streamBinaryArray<bool>(in, position);
+        case 'S':
+        case 'R': {
+            quint32 length;
+            in >> length;
+            position += sizeof(quint32) + length;
+            return QVariant::fromValue(in.device()->read(length));
+        }
+        default:
+            throw QString("Unknown property type: ") + ch;
+    }
+}
+
+static FBXNode streamBinaryNode(QDataStream& in, int& position) {
+    qint32 endOffset;
+    quint32 propertyCount;
+    quint32 propertyListLength;
+    quint8 nameLength;
+
+    in >> endOffset;
+    in >> propertyCount;
+    in >> propertyListLength;
+    in >> nameLength;
+    position += sizeof(quint32) * 3 + sizeof(quint8);
+
+    FBXNode node;
+    const int MIN_VALID_OFFSET = 40;
+    if (endOffset < MIN_VALID_OFFSET || nameLength == 0) {
+        return node;
+    }
+    node.name = in.device()->read(nameLength);
+    position += nameLength;
+
+    for (quint32 i = 0; i < propertyCount; i++) {
+        node.properties.append(streamBinaryProperty(in, position));
+    }
+    while (endOffset > position) {
+        FBXNode child = streamBinaryNode(in, position);
+        if (child.name.isNull()) {
+            return node;
+        }
+        node.children.append(child);
+    }
+    return node;
+}
+
+static FBXNode streamBinaryFBX(const QByteArray& model) {
+    QBuffer buffer(const_cast<QByteArray*>(&model));
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream in(&buffer);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setVersion(QDataStream::Qt_4_5);
+
+    const int HEADER_SIZE = 27;
+    in.skipRawData(HEADER_SIZE);
+    int position = HEADER_SIZE;
+
+    FBXNode top;
+    while (buffer.bytesAvailable()) {
+        FBXNode next = streamBinaryNode(in, position);
+        if (next.name.isNull()) {
+            break;
+        }
+        top.children.append(next);
+    }
+    return top;
+}
+
+static FBXNode parseModel(const QByteArray& model) {
+    QBuffer buffer(const_cast<QByteArray*>(&model));
+    buffer.open(QIODevice::ReadOnly);
+    return parseFBX(&buffer);
+}
+
+template<class T> bool arraysEqual(const QVariant& first, const QVariant& second) {
+    return first.value<QVector<T> >() == second.value<QVector<T> >();
+}
+
+static bool propertiesEqual(const QVariant& first, const QVariant& second) {
+    if (first.userType() != second.userType()) {
+        return false;
+    }
+    // QVariant only compares the vectors it holds by address
+    int type = first.userType();
+    if (type == qMetaTypeId<QVector<float> >()) {
+        return arraysEqual<float>(first, second);
+    } else if (type == qMetaTypeId<QVector<double> >()) {
+        return arraysEqual<double>(first, second);
+    } else if (type == qMetaTypeId<QVector<qint64> >()) {
+        return arraysEqual<qint64>(first, second);
+    } else if (type == qMetaTypeId<QVector<qint32> >()) {
+        return arraysEqual<qint32>(first, second);
+    } else if (type == qMetaTypeId<QVector<bool> >()) {
+        return arraysEqual<bool>(first, second);
+    }
+    return first == second;
+}
+
+static bool nodesEqual(const FBXNode& first, const FBXNode& second) {
+    if (first.name != second.name || first.properties.size() != second.properties.size() ||
+            first.children.size() != second.children.size()) {
+        return false;
+    }
+    for (int i = 0; i < first.properties.size(); i++) {
+        if (!propertiesEqual(first.properties.at(i), second.properties.at(i))) {
+            return false;
+        }
+    }
+    for (int i = 0; i < first.children.size(); i++) {
+        if (!nodesEqual(first.children.at(i), second.children.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static QStringList getSampleModels() {
+    QDir path(__FILE__);
+    path.cdUp();
+    QString resourcesDir = path.cleanPath(path.absoluteFilePath("../../../interface/resources/"));
+
+    QStringList models;
+    QDirIterator iterator(resourcesDir, QStringList() << "*.fbx", QDir::Files, QDirIterator::Subdirectories);
+    while (iterator.hasNext()) {
+        models.append(iterator.next());
+    }
+    return models;
+}
+
+static QByteArray readModel(const QString& fileName) {
+    QFile file(fileName);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+void FBXReaderTests::runAllTests() {
+    binaryParseMatchesStreamedParse();
+    binaryParseBenchmark();
+}
+
+void FBXReaderTests::binaryParseMatchesStreamedParse() {
+    qDebug() << "testing binary FBX parse against the streamed parse...";
+
+    QStringList models = getSampleModels();
+    bool fail = models.isEmpty();
+    foreach (const QString& fileName, models) {
+        QByteArray model = readModel(fileName);
+        try {
+            if (!nodesEqual(parseModel(model), streamBinaryFBX(model))) {
+                qDebug() << "\t" << fileName << "parses differently";
+                fail = true;
+            }
+        } catch (const QString& error) {
+            qDebug() << "\t" << fileName << error;
+            fail = true;
+        }
+
+        // a file cut short is an error rather than a tree padded with zeroes
+        bool threw = false;
+        try {
+            parseModel(model.left(model.size() / 2));
+        } catch (const QString&) {
+            threw = true;
+        }
+        if (!threw) {
+            qDebug() << "\t" << fileName << "cut in half parses";
+            fail = true;
+        }
+    }
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+void FBXReaderTests::binaryParseBenchmark() {
+    const int NUM_ITERATIONS = 20;
+
+    foreach (const QString& fileName, getSampleModels()) {
+        QByteArray model = readModel(fileName);
+
+        quint64 start = usecTimestampNow();
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            streamBinaryFBX(model);
+        }
+        quint64 streamedElapsed = usecTimestampNow() - start;
+
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            parseModel(model);
+        }
+        quint64 parsedElapsed = usecTimestampNow() - start;
+
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            readFBX(model, QVariantHash());
+        }
+        quint64 readElapsed = usecTimestampNow() - start;
+
+        qDebug() << "reading" << QFileInfo(fileName).fileName() << "," << model.size() << "bytes";
+        qDebug() << "\t streamed parse (previous path):" << (float)streamedElapsed / NUM_ITERATIONS << "usecs";
+        qDebug() << "\t in memory parse:" << (float)parsedElapsed / NUM_ITERATIONS << "usecs";
+        qDebug() << "\t in memory parse + geometry extraction:" << (float)readElapsed / NUM_ITERATIONS << "usecs";
+    }
+}
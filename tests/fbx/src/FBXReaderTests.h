@@ -0,0 +1,23 @@
+//
+//  FBXReaderTests.h
+//  tests/fbx/src
+//
+//  Created on 2015-06-18.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXReaderTests_h
+#define hifi_FBXReaderTests_h
+
+namespace FBXReaderTests {
+
+    void runAllTests();
+
+    void binaryParseMatchesStreamedParse();
+    void binaryParseBenchmark();
+}
+
+#endif // hifi_FBXReaderTests_h
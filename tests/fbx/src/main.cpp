@@ -0,0 +1,25 @@
+//
+//  main.cpp
+//  tests/fbx/src
+//
+//  Created on 2015-06-18.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <stdio.h>
+
+#include "ClusterMatrixBenchmarks.h"
+#include "FBXGeometryCacheTests.h"
+#include "FBXReaderTests.h"
+
+int main(int argc, char** argv) {
+    FBXReaderTests::runAllTests();
+    FBXGeometryCacheTests::runAllTests();
+    ClusterMatrixBenchmarks::runAllTests();
+    printf("tests complete, press enter to exit\n");
+    getchar();
+    return 0;
+}
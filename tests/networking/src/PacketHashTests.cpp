@@ -0,0 +1,154 @@
+//
+//  PacketHashTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstring>
+
+#include <QDebug>
+
+#include <PacketHeaders.h>
+#include <SharedUtil.h>
+#include <SipHash.h>
+
+#include "PacketHashTests.h"
+
+void PacketHashTests::runAllTests() {
+    sipHashVectorsTest();
+    packetHashRoundTripTest();
+    packetHashBenchmark();
+}
+
+void PacketHashTests::sipHashVectorsTest() {
+    qDebug() << "testing SipHash-2-4 against the reference vectors...";
+
+    // key 00 01 .. 0f, messages 00 01 .. (length - 1)
+    unsigned char key[SIPHASH_KEY_BYTES];
+    unsigned char message[15];
+    for (int i = 0; i < SIPHASH_KEY_BYTES; i++) {
+        key[i] = i;
+    }
+    for (int i = 0; i < (int)sizeof(message); i++) {
+        message[i] = i;
+    }
+
+    const unsigned char EMPTY_64[SIPHASH_64_BYTES] = { 0x31, 0x0e, 0x0e, 0xdd, 0x47, 0xdb, 0x6f, 0x72 };
+    const unsigned char FIFTEEN_64[SIPHASH_64_BYTES] = { 0xe5, 0x45, 0xbe, 0x49, 0x61, 0xca, 0x29, 0xa1 };
+    const unsigned char EMPTY_128[SIPHASH_128_BYTES] = { 0xa3, 0x81, 0x7f, 0x04, 0xba, 0x25, 0xa8, 0xe6,
+                                                         0x6d, 0xf6, 0x72, 0x14, 0xc7, 0x55, 0x02, 0x93 };
+    const unsigned char FIFTEEN_128[SIPHASH_128_BYTES] = { 0x54, 0x93, 0xe9, 0x99, 0x33, 0xb0, 0xa8, 0x11,
+                                                           0x7e, 0x08, 0xec, 0x0f, 0x97, 0xcf, 0xc3, 0xd9 };
+
+    unsigned char result[SIPHASH_128_BYTES];
+    bool fail = false;
+
+    sipHash64(key, message, 0, result);
+    fail |= memcmp(result, EMPTY_64, SIPHASH_64_BYTES) != 0;
+    sipHash64(key, message, sizeof(message), result);
+    fail |= memcmp(result, FIFTEEN_64, SIPHASH_64_BYTES) != 0;
+    sipHash128(key, message, 0, result);
+    fail |= memcmp(result, EMPTY_128, SIPHASH_128_BYTES) != 0;
+    sipHash128(key, message, sizeof(message), result);
+    fail |= memcmp(result, FIFTEEN_128, SIPHASH_128_BYTES) != 0;
+
+    qDebug() << (fail ? "\t FAIL" : "\t PASS");
+}
+
+static QByteArray createTestPacket(PacketType packetType, int payloadSize) {
+    QByteArray packet = byteArrayWithUUIDPopulatedHeader(packetType, QUuid::createUuid());
+    for (int i = 0; i < payloadSize; i++) {
+        packet.append((char)randIntInRange(0, 255));
+    }
+    return packet;
+}
+
+void PacketHashTests::packetHashRoundTripTest() {
+    PacketAuthenticationMode originalMode = getPacketAuthenticationMode();
+
+    QList<PacketAuthenticationMode> modes;
+    modes << PacketAuthenticationMD5 << PacketAuthenticationSipHash;
+
+    foreach (PacketAuthenticationMode mode, modes) {
+        qDebug() << "testing packet hash round trip with authentication mode" << mode << "...";
+        setPacketAuthenticationMode(mode);
+
+        bool fail = false;
+        QUuid connectionSecret = QUuid::createUuid();
+        QUuid otherSecret = QUuid::createUuid();
+
+        QByteArray packet = createTestPacket(PacketTypeMixedAudio, 960);
+        replaceHashInPacket(packet, connectionSecret);
+
+        fail |= !packetHashMatches(packet, connectionSecret);
+        fail |= packetHashMatches(packet, otherSecret);
+
+        // the in place hash must match the allocating version that is still used by existing callers
+        fail |= hashFromPacketHeader(packet) != hashForPacketAndConnectionUUID(packet, connectionSecret);
+
+        if (mode == PacketAuthenticationMD5) {
+            // and MD5 mode has to stay compatible with what older builds put in the header
+            QByteArray legacyHash = QCryptographicHash::hash(packet.mid(numBytesForPacketHeader(packet))
+                                                             + connectionSecret.toRfc4122(), QCryptographicHash::Md5);
+            fail |= hashFromPacketHeader(packet) != legacyHash;
+        }
+
+        // flipping any bit in the payload must break verification
+        QByteArray tamperedPacket = packet;
+        tamperedPacket[tamperedPacket.size() - 1] = (char)(tamperedPacket.at(tamperedPacket.size() - 1) ^ 0x01);
+        fail |= packetHashMatches(tamperedPacket, connectionSecret);
+
+        // a packet too short to hold its own header never verifies
+        fail |= packetHashMatches(packet.left(numBytesForPacketHeader(packet) - 1), connectionSecret);
+
+        qDebug() << (fail ? "\t FAIL" : "\t PASS");
+    }
+
+    setPacketAuthenticationMode(originalMode);
+}
+
+void PacketHashTests::packetHashBenchmark() {
+    const int NUM_PACKETS = 100000;
+    const int PAYLOAD_SIZE = 1200;
+
+    PacketAuthenticationMode originalMode = getPacketAuthenticationMode();
+
+    QUuid connectionSecret = QUuid::createUuid();
+    QByteArray packet = createTestPacket(PacketTypeMixedAudio, PAYLOAD_SIZE);
+
+    // what every verified send used to do, copy the packet, build the payload + secret, then MD5 it
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        QByteArray packetCopy = packet;
+        PacketType packetType = packetTypeForPacket(packetCopy);
+        packetCopy.replace(hashOffsetForPacketType(packetType), NUM_BYTES_MD5_HASH,
+                           QCryptographicHash::hash(packetCopy.mid(numBytesForPacketHeader(packetCopy))
+                                                    + connectionSecret.toRfc4122(), QCryptographicHash::Md5));
+    }
+    quint64 legacyElapsed = usecTimestampNow() - start;
+
+    QList<PacketAuthenticationMode> modes;
+    modes << PacketAuthenticationMD5 << PacketAuthenticationSipHash;
+
+    quint64 modeElapsed[2];
+    for (int m = 0; m < modes.size(); m++) {
+        setPacketAuthenticationMode(modes[m]);
+
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_PACKETS; i++) {
+            replaceHashInPacket(packet.data(), packet.size(), connectionSecret);
+        }
+        modeElapsed[m] = usecTimestampNow() - start;
+    }
+
+    setPacketAuthenticationMode(originalMode);
+
+    qDebug() << "hashing" << NUM_PACKETS << "packets with" << PAYLOAD_SIZE << "byte payloads";
+    qDebug() << "\t copy + MD5 (previous send path):" << (float)legacyElapsed / NUM_PACKETS << "usecs per packet";
+    qDebug() << "\t in place MD5:" << (float)modeElapsed[0] / NUM_PACKETS << "usecs per packet";
+    qDebug() << "\t in place SipHash:" << (float)modeElapsed[1] / NUM_PACKETS << "usecs per packet";
+}
@@ -0,0 +1,23 @@
+//
+//  PacketHashTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketHashTests_h
+#define hifi_PacketHashTests_h
+
+namespace PacketHashTests {
+
+    void runAllTests();
+
+    void sipHashVectorsTest();
+    void packetHashRoundTripTest();
+    void packetHashBenchmark();
+}
+
+#endif // hifi_PacketHashTests_h
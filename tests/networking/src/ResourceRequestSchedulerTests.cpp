@@ -0,0 +1,406 @@
+//
+//  ResourceRequestSchedulerTests.cpp
+//  tests/networking/src
+//
+//  Created on 2015-06-20.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cfloat>
+
+#include <QDebug>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+#include <ResourceRequestScheduler.h>
+
+#include "ResourceRequestSchedulerTests.h"
+
+typedef ResourceRequestScheduler::Key Key;
+
+static QList<Key> takeAll(ResourceRequestScheduler& scheduler,
+        const ResourceRequestScheduler::PriorityFunction& getPriority = ResourceRequestScheduler::PriorityFunction()) {
+    QList<Key> keys;
+    Key key;
+    while (scheduler.takeNext(key, getPriority)) {
+        keys.append(key);
+    }
+    return keys;
+}
+
+void ResourceRequestSchedulerTests::runAllTests() {
+    priorityOrderTest();
+    requestLimitTest();
+    fairnessTest();
+    domainArrivalBenchmark();
+}
+
+void ResourceRequestSchedulerTests::priorityOrderTest() {
+    qDebug() << "testing requests start in priority order...";
+    bool fail = false;
+
+    // highest first, earliest first among equals
+    ResourceRequestScheduler scheduler;
+    const float PRIORITIES[] = { 1.0f, 5.0f, 3.0f, 5.0f, 2.0f };
+    for (Key key = 0; key < 5; key++) {
+        scheduler.addPending(key, "host", "type", PRIORITIES[key]);
+    }
+    fail = fail || takeAll(scheduler) != (QList<Key>() << 1 << 3 << 2 << 4 << 0);
+    fail = fail || scheduler.getPendingCount() != 0 || scheduler.getLoadingCount() != 5;
+
+    // raised and lowered priorities take effect, removed requests never start
+    ResourceRequestScheduler updatedScheduler;
+    for (Key key = 0; key < 4; key++) {
+        updatedScheduler.addPending(key, "host", "type", (float)key);
+    }
+    updatedScheduler.updatePriority(0, 10.0f);
+    updatedScheduler.updatePriority(3, -1.0f);
+    updatedScheduler.removePending(2);
+    fail = fail || takeAll(updatedScheduler) != (QList<Key>() << 0 << 1 << 3);
+
+    // a removed request's key reused for another host doesn't bring its old entry back
+    ResourceRequestScheduler reusedScheduler;
+    reusedScheduler.addPending(0, "a", "type", 3.0f);
+    reusedScheduler.addPending(1, "a", "type", 2.0f);
+    reusedScheduler.removePending(0);
+    reusedScheduler.addPending(0, "b", "type", 1.0f);
+    fail = fail || takeAll(reusedScheduler) != (QList<Key>() << 1 << 0);
+    fail = fail || reusedScheduler.getPendingCount() != 0 || reusedScheduler.getLoadingCount() != 2;
+
+    // priorities that dropped without notice are caught when they reach the top
+    ResourceRequestScheduler droppedScheduler;
+    for (Key key = 0; key < 3; key++) {
+        droppedScheduler.addPending(key, "host", "type", (float)key);
+    }
+    QList<Key> keys = takeAll(droppedScheduler, [](Key key) { return (key == 2) ? -FLT_MAX : (float)key; });
+    fail = fail || keys != (QList<Key>() << 1 << 0 << 2);
+
+    // many updates don't leave the heap growing
+    ResourceRequestScheduler churnedScheduler;
+    for (int i = 0; i < 10000; i++) {
+        churnedScheduler.addPending(i % 10, "host", "type", (float)i);
+    }
+    fail = fail || takeAll(churnedScheduler) != (QList<Key>() << 9 << 8 << 7 << 6 << 5 << 4 << 3 << 2 << 1 << 0);
+
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+void ResourceRequestSchedulerTests::requestLimitTest() {
+    qDebug() << "testing requests respect host and type limits...";
+    bool fail = false;
+
+    ResourceRequestScheduler scheduler;
+    scheduler.setHostRequestLimit(1);
+    scheduler.addPending(0, "a", "type", 3.0f);
+    scheduler.addPending(1, "a", "type", 2.0f);
+    scheduler.addPending(2, "b", "type", 1.0f);
+    fail = fail || takeAll(scheduler) != (QList<Key>() << 0 << 2);
+    scheduler.completed(0, 100);
+    fail = fail || takeAll(scheduler) != (QList<Key>() << 1);
+
+    // the requests waiting on a host at its limit don't hide those of another host
+    ResourceRequestScheduler busyScheduler;
+    busyScheduler.setHostRequestLimit(1);
+    for (Key key = 0; key < 1000; key++) {
+        busyScheduler.addPending(key, "busy", "type", 10.0f);
+    }
+    Key key;
+    fail = fail || !busyScheduler.takeNext(key) || key != 0;
+    fail = fail || busyScheduler.takeNext(key);
+    busyScheduler.addPending(1000, "idle", "type", 1.0f);
+    fail = fail || takeAll(busyScheduler) != (QList<Key>() << 1000);
+    busyScheduler.completed(0, 100);
+    fail = fail || takeAll(busyScheduler) != (QList<Key>() << 1);
+
+    ResourceRequestScheduler typeScheduler;
+    typeScheduler.setTypeRequestLimit("texture", 2);
+    for (Key key = 0; key < 3; key++) {
+        typeScheduler.addPending(key, "host", "texture", 10.0f);
+    }
+    typeScheduler.addPending(3, "host", "model", 1.0f);
+    fail = fail || takeAll(typeScheduler) != (QList<Key>() << 0 << 1 << 3);
+    typeScheduler.completed(1, 100);
+    fail = fail || takeAll(typeScheduler) != (QList<Key>() << 2);
+
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+void ResourceRequestSchedulerTests::fairnessTest() {
+    qDebug() << "testing types are served in weighted shares...";
+    bool fail = false;
+
+    // a type that got ahead is passed over for a lower priority of another type, but still starts when nothing else can
+    ResourceRequestScheduler scheduler;
+    scheduler.setFairnessQuantum(1000);
+    scheduler.addPending(0, "host", "texture", 10.0f);
+    scheduler.addPending(1, "host", "model", 1.0f);
+    Key key;
+    fail = fail || !scheduler.takeNext(key) || key != 0;
+    scheduler.completed(0, 10000);
+    scheduler.addPending(2, "host", "texture", 10.0f);
+    fail = fail || takeAll(scheduler) != (QList<Key>() << 1 << 2);
+
+    // a heavier weight buys a bigger share
+    ResourceRequestScheduler weightedScheduler;
+    weightedScheduler.setFairnessQuantum(1000);
+    weightedScheduler.setTypeWeight("texture", 100.0f);
+    weightedScheduler.addPending(0, "host", "texture", 10.0f);
+    weightedScheduler.addPending(1, "host", "model", 1.0f);
+    fail = fail || !weightedScheduler.takeNext(key) || key != 0;
+    weightedScheduler.completed(0, 10000);
+    weightedScheduler.addPending(2, "host", "texture", 10.0f);
+    fail = fail || takeAll(weightedScheduler) != (QList<Key>() << 2 << 1);
+
+    // a type that had nothing waiting doesn't get to catch up on the share it didn't use
+    ResourceRequestScheduler idleScheduler;
+    idleScheduler.setFairnessQuantum(1000);
+    idleScheduler.addPending(0, "host", "texture", 10.0f);
+    idleScheduler.addPending(1, "host", "texture", 10.0f);
+    fail = fail || !idleScheduler.takeNext(key) || key != 0;
+    idleScheduler.completed(0, 10000);
+    idleScheduler.addPending(2, "host", "model", 1.0f);
+    fail = fail || takeAll(idleScheduler) != (QList<Key>() << 1 << 2);
+
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+/// One request in the arrival trace.
+class TraceRequest {
+public:
+    QString host;
+    QString type;
+    qint64 size;
+    float priority;
+    int parent; ///< the model whose completion brings this texture in, or -1
+    double arrivalTime;
+    bool visible;
+};
+
+/// Picks the next request to start, by one policy or the other.
+class RequestPolicy {
+public:
+    virtual ~RequestPolicy() { }
+    virtual void add(int index) = 0;
+    virtual bool takeNext(int& index) = 0;
+    virtual void completed(int index, qint64 bytes) = 0;
+};
+
+/// The former policy: a single list scanned for the highest priority, the last of equals winning.
+class ScanPolicy : public RequestPolicy {
+public:
+    ScanPolicy(const QVector<TraceRequest>& trace) : _trace(trace) { }
+
+    virtual void add(int index) { _pending.append(index); }
+
+    virtual bool takeNext(int& index) {
+        int highestIndex = -1;
+        float highestPriority = -FLT_MAX;
+        for (int i = 0; i < _pending.size(); i++) {
+            float priority = _trace.at(_pending.at(i)).priority;
+            if (priority >= highestPriority) {
+                highestPriority = priority;
+                highestIndex = i;
+            }
+        }
+        if (highestIndex == -1) {
+            return false;
+        }
+        index = _pending.takeAt(highestIndex);
+        return true;
+    }
+
+    virtual void completed(int index, qint64 bytes) { }
+
+private:
+    const QVector<TraceRequest>& _trace;
+    QList<int> _pending;
+};
+
+/// The scheduler, set up as the interface sets it up.
+class SchedulerPolicy : public RequestPolicy {
+public:
+    SchedulerPolicy(const QVector<TraceRequest>& trace) : _trace(trace) {
+        _scheduler.setTypeWeight("GeometryCache", 2.0f);
+    }
+
+    virtual void add(int index) {
+        const TraceRequest& request = _trace.at(index);
+        _scheduler.addPending(index, request.host, request.type, request.priority);
+    }
+
+    virtual bool takeNext(int& index) {
+        Key key;
+        if (!_scheduler.takeNext(key)) {
+            return false;
+        }
+        index = (int)key;
+        return true;
+    }
+
+    virtual void completed(int index, qint64 bytes) { _scheduler.completed(index, bytes); }
+
+private:
+    const QVector<TraceRequest>& _trace;
+    ResourceRequestScheduler _scheduler;
+};
+
+class SimulationResult {
+public:
+    double firstVisibleFrameTime = 0.0;
+    double allLoadedTime = 0.0;
+    bool complete = false;
+};
+
+/// Builds a trace like that of arriving in a crowded domain: entities trickle in over the first half second, each
+/// model bringing in its textures once it has loaded, while scripts fetch sounds from a host of their own.
+static QVector<TraceRequest> createDomainArrivalTrace() {
+    quint32 seed = 12345;
+    auto random = [&seed](int range) {
+        seed = seed * 1664525 + 1013904223;
+        return (int)((seed >> 8) % range);
+    };
+    const int KILOBYTE = 1024;
+
+    QVector<TraceRequest> trace;
+    const char* MODEL_HOSTS[] = { "assets-a", "assets-b", "assets-c" };
+    const int NUM_MODELS = 80;
+    const double MODEL_ARRIVAL_INTERVAL = 0.005;
+    const float VISIBLE_DISTANCE = 25.0f;
+    for (int i = 0; i < NUM_MODELS; i++) {
+        TraceRequest model;
+        model.host = MODEL_HOSTS[random(3)];
+        model.type = "GeometryCache";
+        model.size = (40 + random(360)) * KILOBYTE;
+        float distance = 2.0f + random(1500) / 10.0f;
+        model.priority = -distance;
+        model.parent = -1;
+        model.arrivalTime = i * MODEL_ARRIVAL_INTERVAL;
+        model.visible = distance < VISIBLE_DISTANCE;
+        int modelIndex = trace.size();
+        trace.append(model);
+
+        int numTextures = 1 + random(4);
+        for (int j = 0; j < numTextures; j++) {
+            TraceRequest texture = model;
+            texture.type = "TextureCache";
+            texture.size = (256 + random(1792)) * KILOBYTE;
+            texture.parent = modelIndex;
+            trace.append(texture);
+        }
+    }
+    const int NUM_SOUNDS = 30;
+    for (int i = 0; i < NUM_SOUNDS; i++) {
+        TraceRequest sound;
+        sound.host = "sounds";
+        sound.type = "SoundCache";
+        sound.size = (20 + random(280)) * KILOBYTE;
+        sound.priority = -FLT_MAX; // nothing sets the priority of sounds
+        sound.parent = -1;
+        sound.arrivalTime = random(200) / 1000.0;
+        sound.visible = false;
+        trace.append(sound);
+    }
+    return trace;
+}
+
+/// Replays the trace over links with a fixed latency per request, a bandwidth per host shared by its requests, and a
+/// downlink shared by all requests, starting no more than three requests at once as the interface does.
+static SimulationResult simulateDomainArrival(const QVector<TraceRequest>& trace, RequestPolicy& policy) {
+    const double TIME_STEP = 0.001;
+    const double MAX_TIME = 600.0;
+    const double LATENCY = 0.08;
+    const double HOST_BANDWIDTH = 1.5 * 1024 * 1024;
+    const double DOWNLINK_BANDWIDTH = 4.0 * 1024 * 1024;
+    const int REQUEST_LIMIT = 3;
+
+    QVector<bool> arrived(trace.size(), false);
+    QVector<double> completionTimes(trace.size(), -1.0);
+    QVector<double> startTimes(trace.size());
+    QVector<double> remaining(trace.size());
+    QList<int> loading;
+    int numCompleted = 0;
+
+    double time = 0.0;
+    for (; numCompleted < trace.size() && time < MAX_TIME; time += TIME_STEP) {
+        for (int i = 0; i < trace.size(); i++) {
+            const TraceRequest& request = trace.at(i);
+            if (!arrived.at(i) && (request.parent == -1 ? request.arrivalTime <= time :
+                    completionTimes.at(request.parent) >= 0.0)) {
+                arrived[i] = true;
+                policy.add(i);
+            }
+        }
+        int index;
+        while (loading.size() < REQUEST_LIMIT && policy.takeNext(index)) {
+            loading.append(index);
+            startTimes[index] = time;
+            remaining[index] = trace.at(index).size;
+        }
+
+        QHash<QString, int> transferringPerHost;
+        int numTransferring = 0;
+        foreach (int loadingIndex, loading) {
+            if (time - startTimes.at(loadingIndex) >= LATENCY) {
+                transferringPerHost[trace.at(loadingIndex).host]++;
+                numTransferring++;
+            }
+        }
+        for (int i = 0; i < loading.size(); ) {
+            index = loading.at(i);
+            if (time - startTimes.at(index) >= LATENCY) {
+                double bandwidth = qMin(HOST_BANDWIDTH / transferringPerHost.value(trace.at(index).host),
+                    DOWNLINK_BANDWIDTH / numTransferring);
+                remaining[index] -= bandwidth * TIME_STEP;
+                if (remaining.at(index) <= 0.0) {
+                    completionTimes[index] = time;
+                    numCompleted++;
+                    policy.completed(index, trace.at(index).size);
+                    loading.removeAt(i);
+                    continue;
+                }
+            }
+            i++;
+        }
+    }
+
+    SimulationResult result;
+    result.complete = (numCompleted == trace.size());
+    result.allLoadedTime = time;
+    for (int i = 0; i < trace.size(); i++) {
+        if (trace.at(i).visible) {
+            result.firstVisibleFrameTime = qMax(result.firstVisibleFrameTime, completionTimes.at(i));
+        }
+    }
+    return result;
+}
+
+void ResourceRequestSchedulerTests::domainArrivalBenchmark() {
+    QVector<TraceRequest> trace = createDomainArrivalTrace();
+    int numVisible = 0;
+    qint64 totalSize = 0;
+    foreach (const TraceRequest& request, trace) {
+        numVisible += request.visible ? 1 : 0;
+        totalSize += request.size;
+    }
+    qDebug() << "replaying domain arrival," << trace.size() << "requests," << numVisible << "visible,"
+        << totalSize / 1024 << "kilobytes";
+
+    ScanPolicy scanPolicy(trace);
+    SimulationResult scanResult = simulateDomainArrival(trace, scanPolicy);
+    SchedulerPolicy schedulerPolicy(trace);
+    SimulationResult schedulerResult = simulateDomainArrival(trace, schedulerPolicy);
+
+    if (!(scanResult.complete && schedulerResult.complete)) {
+        qDebug() << "\t requests left unfinished";
+        qDebug() << "\t\t FAIL";
+        return;
+    }
+    qDebug() << "\t pending list scan: first visible frame" << scanResult.firstVisibleFrameTime << "secs, all loaded"
+        << scanResult.allLoadedTime << "secs";
+    qDebug() << "\t request scheduler: first visible frame" << schedulerResult.firstVisibleFrameTime << "secs, all loaded"
+        << schedulerResult.allLoadedTime << "secs";
+}
@@ -0,0 +1,25 @@
+//
+//  ResourceRequestSchedulerTests.h
+//  tests/networking/src
+//
+//  Created on 2015-06-20.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceRequestSchedulerTests_h
+#define hifi_ResourceRequestSchedulerTests_h
+
+namespace ResourceRequestSchedulerTests {
+
+    void runAllTests();
+
+    void priorityOrderTest();
+    void requestLimitTest();
+    void fairnessTest();
+    void domainArrivalBenchmark();
+};
+
+#endif // hifi_ResourceRequestSchedulerTests_h
@@ -8,11 +8,15 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include "PacketHashTests.h"
+#include "ResourceRequestSchedulerTests.h"
 #include "SequenceNumberStatsTests.h"
 #include <stdio.h>
 
 int main(int argc, char** argv) {
     SequenceNumberStatsTests::runAllTests();
+    PacketHashTests::runAllTests();
+    ResourceRequestSchedulerTests::runAllTests();
     printf("tests passed! press enter to exit");
     getchar();
     return 0;
@@ -0,0 +1,257 @@
+//
+//  EntitySimulationTests.cpp
+//  tests/octree/src
+//
+//  Created on 2015-06-19.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <memory>
+#include <random>
+
+#include <QDebug>
+#include <QSet>
+#include <QVector>
+
+#include <EntityItem.h>
+#include <EntityItemPropertiesDefaults.h>
+#include <EntityTree.h>
+#include <KinematicStateTable.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <SimpleEntitySimulation.h>
+#include <StreamUtils.h>
+
+#include "EntitySimulationTests.h"
+
+// an entity that wants a given number of updates
+class TestEntityItem : public EntityItem {
+public:
+    TestEntityItem() : EntityItem(EntityItemID(QUuid::createUuid())) { }
+
+    virtual void pureVirtualFunctionPlaceHolder() { }
+
+    virtual bool needsToCallUpdate() const { return updatesWanted > 0; }
+    virtual void update(const quint64& now) {
+        EntityItem::update(now);
+        updatesWanted--;
+        numUpdates++;
+    }
+
+    int updatesWanted = 0;
+    int numUpdates = 0;
+};
+
+static std::shared_ptr<TestEntityItem> mortalEntity(quint64 created, float lifetime) {
+    std::shared_ptr<TestEntityItem> entity(new TestEntityItem());
+    entity->setCreated(created);
+    entity->setLifetime(lifetime);
+    return entity;
+}
+
+static QSet<EntityItemID> takeEntitiesToDelete(EntitySimulation& simulation) {
+    VectorOfEntities entitiesToDelete;
+    simulation.getEntitiesToDelete(entitiesToDelete);
+    QSet<EntityItemID> entityIDs;
+    foreach (EntityItemPointer entity, entitiesToDelete) {
+        entityIDs.insert(entity->getEntityItemID());
+    }
+    return entityIDs;
+}
+
+void EntitySimulationTests::expiresOnlyDueEntities(bool verbose) {
+    qDebug() << "testing mortal entities expire when due and only then...";
+    bool fail = false;
+
+    EntityTree tree;
+    SimpleEntitySimulation simulation;
+    simulation.setEntityTree(&tree);
+
+    quint64 now = usecTimestampNow();
+    quint64 tenSecondsAgo = now - 10 * USECS_PER_SECOND;
+
+    auto expired = mortalEntity(tenSecondsAgo, 1.0f);
+    auto alsoExpired = mortalEntity(tenSecondsAgo, 5.0f);
+    auto notYetDue = mortalEntity(tenSecondsAgo, 100.0f);
+    auto dueSoon = mortalEntity(now, 0.2f);
+    auto rescheduled = mortalEntity(tenSecondsAgo, 2.0f);
+    auto madeImmortal = mortalEntity(tenSecondsAgo, 3.0f);
+    auto removed = mortalEntity(tenSecondsAgo, 4.0f);
+    std::shared_ptr<TestEntityItem> entities[] = { dueSoon, notYetDue, rescheduled, alsoExpired, madeImmortal, expired };
+    for (auto entity : entities) {
+        simulation.addEntity(entity);
+    }
+    simulation.addEntity(removed);
+
+    // these leave stale entries behind in the expiry queue
+    rescheduled->updateLifetime(1000.0f);
+    simulation.changeEntity(rescheduled);
+    madeImmortal->updateLifetime(ENTITY_ITEM_IMMORTAL_LIFETIME);
+    simulation.changeEntity(madeImmortal);
+    simulation.removeEntity(removed);
+
+    simulation.updateEntities();
+    QSet<EntityItemID> expectedIDs;
+    expectedIDs << expired->getEntityItemID() << alsoExpired->getEntityItemID();
+    QSet<EntityItemID> expiredIDs = takeEntitiesToDelete(simulation);
+    if (expiredIDs != expectedIDs) {
+        qDebug() << "\t\t expected" << expectedIDs.size() << "expired entities, got" << expiredIDs.size();
+        fail = true;
+    }
+
+    // the entity due soon goes once its time has come, and nothing else does
+    const int WAIT_FOR_DUE_USECS = 300 * USECS_PER_MSEC;
+    usleep(WAIT_FOR_DUE_USECS);
+    simulation.updateEntities();
+    expiredIDs = takeEntitiesToDelete(simulation);
+    if (expiredIDs != (QSet<EntityItemID>() << dueSoon->getEntityItemID())) {
+        qDebug() << "\t\t the entity due soon didn't expire alone";
+        fail = true;
+    }
+
+    // the stale entry of the removed entity doesn't keep it alive
+    std::weak_ptr<TestEntityItem> removedEntity = removed;
+    removed.reset();
+    if (!removedEntity.expired()) {
+        qDebug() << "\t\t the removed entity is still referenced";
+        fail = true;
+    }
+
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+void EntitySimulationTests::updatesOnlyEntitiesThatNeedIt(bool verbose) {
+    qDebug() << "testing entities are updated only while they need it...";
+    bool fail = false;
+
+    EntityTree tree;
+    SimpleEntitySimulation simulation;
+    simulation.setEntityTree(&tree);
+
+    // stops needing updates through its own update()
+    std::shared_ptr<TestEntityItem> selfStopping(new TestEntityItem());
+    selfStopping->updatesWanted = 2;
+    simulation.addEntity(selfStopping);
+
+    // stops needing updates from outside, without telling the simulation
+    std::shared_ptr<TestEntityItem> stoppedOutside(new TestEntityItem());
+    stoppedOutside->updatesWanted = 5;
+    simulation.addEntity(stoppedOutside);
+
+    // starts needing updates through a change
+    std::shared_ptr<TestEntityItem> startedLater(new TestEntityItem());
+    simulation.addEntity(startedLater);
+
+    simulation.updateEntities();
+    stoppedOutside->updatesWanted = 0;
+    startedLater->updatesWanted = 1;
+    simulation.changeEntity(startedLater);
+    for (int i = 0; i < 3; i++) {
+        simulation.updateEntities();
+    }
+
+    if (selfStopping->numUpdates != 2) {
+        qDebug() << "\t\t entity wanting 2 updates got" << selfStopping->numUpdates;
+        fail = true;
+    }
+    if (stoppedOutside->numUpdates != 1) {
+        qDebug() << "\t\t entity that stopped needing updates got" << stoppedOutside->numUpdates << "instead of 1";
+        fail = true;
+    }
+    if (startedLater->numUpdates != 1) {
+        qDebug() << "\t\t entity that started needing updates got" << startedLater->numUpdates << "instead of 1";
+        fail = true;
+    }
+
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+static bool closeEnough(const glm::vec3& actual, const glm::vec3& expected) {
+    // float rounding may differ between the table and glm, positions are within 100m and velocities within 10m/s
+    const float TOLERANCE = 0.0001f;
+    return glm::length(actual - expected) <= TOLERANCE * (1.0f + glm::length(expected));
+}
+
+void EntitySimulationTests::integratesLikeSimulateKinematicMotion(bool verbose) {
+    qDebug() << "testing the kinematic state table moves entities like EntityItem::simulateKinematicMotion()...";
+    bool fail = false;
+
+    const int NUM_ENTITIES = 200;
+    const int NUM_STEPS = 120;
+    const quint64 STEP_USECS = USECS_PER_SECOND / 60;
+    std::mt19937 generator(15);
+    std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> velocityDistribution(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> gravityDistribution(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> dampingDistribution(0.0f, 0.99f);
+
+    quint64 now = usecTimestampNow();
+    KinematicStateTable table;
+    QVector<EntityItemPointer> entities;
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        EntityItemPointer entity(new TestEntityItem());
+        glm::vec3 gravity(gravityDistribution(generator), gravityDistribution(generator), gravityDistribution(generator));
+        entity->setPosition(glm::vec3(positionDistribution(generator), positionDistribution(generator),
+                                      positionDistribution(generator)));
+        entity->setVelocity(glm::vec3(velocityDistribution(generator), velocityDistribution(generator),
+                                      velocityDistribution(generator)));
+        entity->setGravity(gravity);
+        entity->setAcceleration(gravity);
+        // a quarter of the entities are undamped, the table skips powf() for those
+        entity->setDamping(i % 4 == 0 ? 0.0f : dampingDistribution(generator));
+        entity->setLastSimulated(now);
+        table.insert(entity);
+        entities.append(entity);
+    }
+
+    int numStopped = 0;
+    for (int step = 0; step < NUM_STEPS && !fail; step++) {
+        now += STEP_USECS;
+        table.integrate(now);
+        foreach (EntityItemPointer entity, entities) {
+            entity->simulateKinematicMotion((float)STEP_USECS / (float)USECS_PER_SECOND, false);
+        }
+
+        // rows move when others are removed, so find each entity's row again
+        for (int row = table.getNumRows() - 1; row >= 0; row--) {
+            EntityItemPointer entity = table.getEntity(row);
+            if (!closeEnough(table.getPosition(row), entity->getPosition())
+                || !closeEnough(table.getVelocity(row), entity->getVelocity())) {
+                if (verbose) {
+                    qDebug() << "\t\t step" << step << "position" << table.getPosition(row) << "expected"
+                        << entity->getPosition() << "velocity" << table.getVelocity(row) << "expected"
+                        << entity->getVelocity();
+                }
+                fail = true;
+            }
+            if (table.hasStopped(row) != !entity->hasVelocity()) {
+                if (verbose) {
+                    qDebug() << "\t\t step" << step << "row stopped" << table.hasStopped(row)
+                        << "but entity velocity is" << entity->getVelocity();
+                }
+                fail = true;
+            }
+
+            // the simulation drops rows that came to rest, and a resting entity doesn't move anymore
+            if (table.hasStopped(row)) {
+                table.remove(entity);
+                entities.removeOne(entity);
+                numStopped++;
+            }
+        }
+    }
+
+    if (verbose) {
+        qDebug() << "\t\t" << numStopped << "of" << NUM_ENTITIES << "entities came to rest";
+    }
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+}
+
+void EntitySimulationTests::runAllTests(bool verbose) {
+    expiresOnlyDueEntities(verbose);
+    updatesOnlyEntitiesThatNeedIt(verbose);
+    integratesLikeSimulateKinematicMotion(verbose);
+}
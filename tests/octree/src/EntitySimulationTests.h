@@ -0,0 +1,22 @@
+//
+//  EntitySimulationTests.h
+//  tests/octree/src
+//
+//  Created on 2015-06-19.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySimulationTests_h
+#define hifi_EntitySimulationTests_h
+
+namespace EntitySimulationTests {
+    void expiresOnlyDueEntities(bool verbose);
+    void updatesOnlyEntitiesThatNeedIt(bool verbose);
+    void integratesLikeSimulateKinematicMotion(bool verbose);
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_EntitySimulationTests_h
@@ -0,0 +1,120 @@
+//
+//  ItemSpatialTreeTests.cpp
+//  tests/octree/src
+//
+//  Created on 2015-06-17.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <vector>
+
+#include <QDebug>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <render/ItemSpatialTree.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+#include "ItemSpatialTreeTests.h"
+
+static AABox randomBox() {
+    glm::vec3 corner(randFloatInRange(-500.0f, 700.0f), randFloatInRange(-500.0f, 600.0f),
+                     randFloatInRange(-500.0f, 700.0f));
+    float size = randFloatInRange(0.01f, 1.0f) * (randIntInRange(0, 2) == 0 ? 200.0f : 2.0f);
+    return AABox(corner, glm::vec3(size * randFloatInRange(0.5f, 1.0f), size, size * randFloatInRange(0.2f, 1.0f)));
+}
+
+// counts the items that aren't outside the frustum but weren't selected, and the items that were left out
+static void checkSelection(const ViewFrustum& frustum, const render::ItemSpatialTree& tree,
+                           const std::vector<AABox>& boxes, const std::vector<bool>& inTree,
+                           int& numMissed, int& numLeftOut, bool verbose) {
+    std::vector<render::ItemSpatialTree::ItemID> selectedItems;
+    tree.selectItems(frustum, selectedItems);
+    std::vector<bool> selected(boxes.size(), false);
+    for (auto id : selectedItems) {
+        selected[id] = true;
+    }
+
+    numMissed = 0;
+    numLeftOut = 0;
+    for (size_t id = 0; id < boxes.size(); id++) {
+        if (!inTree[id]) {
+            if (selected[id]) {
+                numMissed++; // removed items must never come back
+            }
+            continue;
+        }
+        if (!selected[id]) {
+            numLeftOut++;
+            if (frustum.boxInFrustum(boxes[id]) != ViewFrustum::OUTSIDE) {
+                if (verbose) {
+                    qDebug() << "visible item" << id << boxes[id] << "was not selected";
+                }
+                numMissed++;
+            }
+        }
+    }
+}
+
+void ItemSpatialTreeTests::selectsEveryVisibleItem(bool verbose) {
+    qDebug() << "******************************************************************************************";
+    qDebug() << "ItemSpatialTreeTests::selectsEveryVisibleItem()";
+
+    // the default keyhole too, the tree has to keep whatever boxInFrustum() keeps
+    ViewFrustum frustum;
+    frustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                           DEFAULT_NEAR_CLIP, 1000.0f));
+    frustum.setPosition(glm::vec3(100.0f, 50.0f, 100.0f));
+    frustum.setOrientation(glm::angleAxis(0.7f, glm::normalize(glm::vec3(0.2f, 1.0f, 0.1f))));
+    frustum.calculate();
+
+    const int NUM_ITEMS = 10000;
+    render::ItemSpatialTree tree;
+    std::vector<AABox> boxes;
+    std::vector<bool> inTree(NUM_ITEMS, true);
+    for (int id = 0; id < NUM_ITEMS; id++) {
+        boxes.push_back(randomBox());
+        tree.insert(id, boxes[id]);
+    }
+
+    int numMissed, numLeftOut;
+    checkSelection(frustum, tree, boxes, inTree, numMissed, numLeftOut, verbose);
+    bool passed = numMissed == 0 && numLeftOut > 0 && tree.getNumItems() == NUM_ITEMS;
+    if (verbose || !passed) {
+        qDebug() << "after inserts: missed=" << numMissed << "left out=" << numLeftOut << "of" << NUM_ITEMS;
+    }
+
+    // move a third of the items and remove a tenth, the tree has to follow
+    int numRemoved = 0;
+    for (int id = 0; id < NUM_ITEMS; id++) {
+        if (id % 10 == 0) {
+            tree.remove(id);
+            inTree[id] = false;
+            numRemoved++;
+        } else if (id % 3 == 0) {
+            boxes[id] = randomBox();
+            tree.update(id, boxes[id]);
+        }
+    }
+
+    checkSelection(frustum, tree, boxes, inTree, numMissed, numLeftOut, verbose);
+    passed = passed && numMissed == 0 && numLeftOut > 0 && tree.getNumItems() == NUM_ITEMS - numRemoved;
+    if (verbose || !passed) {
+        qDebug() << "after updates: missed=" << numMissed << "left out=" << numLeftOut
+            << "of" << tree.getNumItems();
+    }
+
+    if (passed) {
+        qDebug() << "selectsEveryVisibleItem: PASSED";
+    } else {
+        qDebug() << "selectsEveryVisibleItem: FAILED";
+    }
+}
+
+void ItemSpatialTreeTests::runAllTests(bool verbose) {
+    selectsEveryVisibleItem(verbose);
+}
@@ -0,0 +1,20 @@
+//
+//  ItemSpatialTreeTests.h
+//  tests/octree/src
+//
+//  Created on 2015-06-17.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ItemSpatialTreeTests_h
+#define hifi_ItemSpatialTreeTests_h
+
+namespace ItemSpatialTreeTests {
+    void selectsEveryVisibleItem(bool verbose);
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_ItemSpatialTreeTests_h
@@ -0,0 +1,150 @@
+//
+//  JSONPersistBenchmarks.cpp
+//  tests/octree/src
+//
+//  Created on 2015-06-14.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Compares saving and loading entities as JSON a few at a time with building the whole QJsonDocument
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+
+#ifndef Q_OS_WIN
+#include <sys/resource.h>
+#endif
+
+#include <EntityTree.h>
+#include <SharedUtil.h>
+
+#include "JSONPersistBenchmarks.h"
+
+static QString benchmarkFilename() {
+    return QDir::temp().filePath("JSONPersistBenchmarks.json");
+}
+
+// the high water mark of the process in KB, it only ever goes up so the benchmarks run from the lightest to the heaviest
+static long peakResidentKB() {
+#ifdef Q_OS_WIN
+    return 0;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef Q_OS_MAC
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static void addBenchmarkEntities(EntityTree& tree, int numEntities) {
+    tree.setIsServer(true);
+    tree.lockForWrite();
+    for (int i = 0; i < numEntities; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setName(QString("benchmark box %1").arg(i));
+        properties.setPosition(glm::vec3(randFloatInRange(0.0f, 1000.0f), randFloatInRange(0.0f, 100.0f),
+                                         randFloatInRange(0.0f, 1000.0f)));
+        properties.setDimensions(glm::vec3(randFloatInRange(0.1f, 2.0f)));
+        xColor color = { (unsigned char)(i % 256), 128, 255 };
+        properties.setColor(color);
+        tree.addEntity(EntityItemID(QUuid::createUuid()), properties);
+    }
+    tree.unlock();
+}
+
+static void reportBenchmark(const char* name, int numEntities, quint64 saveUsecs, quint64 loadUsecs, int numLoaded,
+                            long peakBeforeKB) {
+    long peakAfterKB = peakResidentKB();
+    qDebug() << "TIME -" << name << numEntities << "entities: save" << saveUsecs / USECS_PER_MSEC << "msecs, load"
+        << loadUsecs / USECS_PER_MSEC << "msecs, peak RSS" << peakAfterKB << "KB (+" << (peakAfterKB - peakBeforeKB)
+        << "KB)";
+    if (numLoaded != numEntities) {
+        qDebug() << "FAILED -" << name << "loaded" << numLoaded << "of" << numEntities << "entities";
+    }
+}
+
+void JSONPersistBenchmarks::streamingSaveAndLoad(int numEntities, bool verbose) {
+    long peakBeforeKB;
+    quint64 saveUsecs;
+    {
+        EntityTree tree;
+        addBenchmarkEntities(tree, numEntities);
+
+        peakBeforeKB = peakResidentKB();
+        quint64 start = usecTimestampNow();
+        tree.writeToJSONFile(qPrintable(benchmarkFilename()));
+        saveUsecs = usecTimestampNow() - start;
+    }
+
+    EntityTree loadedTree;
+    loadedTree.setIsServer(true);
+    quint64 start = usecTimestampNow();
+    loadedTree.lockForWrite();
+    loadedTree.readFromFile(qPrintable(benchmarkFilename()));
+    loadedTree.unlock();
+    quint64 loadUsecs = usecTimestampNow() - start;
+
+    int numLoaded = 0;
+    loadedTree.writeToVariants(NULL, true, [&](const QVariantList& items) { numLoaded += items.size(); });
+
+    reportBenchmark("streaming JSON", numEntities, saveUsecs, loadUsecs, numLoaded, peakBeforeKB);
+    QFile::remove(benchmarkFilename());
+}
+
+void JSONPersistBenchmarks::documentSaveAndLoad(int numEntities, bool verbose) {
+    long peakBeforeKB;
+    quint64 saveUsecs;
+    {
+        EntityTree tree;
+        addBenchmarkEntities(tree, numEntities);
+
+        // what Octree::writeToJSONFile() did before it streamed
+        peakBeforeKB = peakResidentKB();
+        quint64 start = usecTimestampNow();
+        QVariantMap entityDescription;
+        entityDescription["Version"] = 0;
+        tree.writeToMap(entityDescription, tree.getRoot(), true);
+        QFile file(benchmarkFilename());
+        file.open(QIODevice::WriteOnly);
+        file.write(QJsonDocument::fromVariant(entityDescription).toJson());
+        file.close();
+        saveUsecs = usecTimestampNow() - start;
+    }
+
+    // and what Octree::readJSONFromStream() did
+    EntityTree loadedTree;
+    loadedTree.setIsServer(true);
+    quint64 start = usecTimestampNow();
+    QFile file(benchmarkFilename());
+    file.open(QIODevice::ReadOnly);
+    QVariantMap asMap = QJsonDocument::fromJson(file.readAll()).toVariant().toMap();
+    loadedTree.lockForWrite();
+    loadedTree.readFromMap(asMap);
+    loadedTree.unlock();
+    quint64 loadUsecs = usecTimestampNow() - start;
+
+    int numLoaded = 0;
+    loadedTree.writeToVariants(NULL, true, [&](const QVariantList& items) { numLoaded += items.size(); });
+
+    reportBenchmark("QJsonDocument", numEntities, saveUsecs, loadUsecs, numLoaded, peakBeforeKB);
+    QFile::remove(benchmarkFilename());
+}
+
+void JSONPersistBenchmarks::runAllTests(bool verbose) {
+    qDebug() << "******************************************************************************************";
+    qDebug() << "JSONPersistBenchmarks::runAllTests()";
+
+    streamingSaveAndLoad(10000, verbose);
+    streamingSaveAndLoad(100000, verbose);
+    documentSaveAndLoad(10000, verbose);
+    documentSaveAndLoad(100000, verbose);
+}
@@ -0,0 +1,21 @@
+//
+//  JSONPersistBenchmarks.h
+//  tests/octree/src
+//
+//  Created on 2015-06-14.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JSONPersistBenchmarks_h
+#define hifi_JSONPersistBenchmarks_h
+
+namespace JSONPersistBenchmarks {
+    void streamingSaveAndLoad(int numEntities, bool verbose);
+    void documentSaveAndLoad(int numEntities, bool verbose);
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_JSONPersistBenchmarks_h
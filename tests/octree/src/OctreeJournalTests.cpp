@@ -0,0 +1,126 @@
+//
+//  OctreeJournalTests.cpp
+//  tests/octree/src
+//
+//  Created on 2015-06-13.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#include <OctreeJournal.h>
+
+#include "OctreeJournalTests.h"
+
+static QString testJournalFilename() {
+    return QDir::temp().filePath("OctreeJournalTests.journal");
+}
+
+static void removeTestJournals() {
+    QFile::remove(testJournalFilename());
+    QFile::remove(testJournalFilename() + ".rolled");
+}
+
+void OctreeJournalTests::appendAndRead(bool verbose) {
+    qDebug() << "******************************************************************************************";
+    qDebug() << "OctreeJournalTests::appendAndRead()";
+
+    removeTestJournals();
+    QUuid changedID = QUuid::createUuid();
+    QUuid deletedID = QUuid::createUuid();
+    {
+        OctreeJournal journal;
+        journal.open(testJournalFilename());
+        journal.append(OctreeJournal::RECORD_CHANGED, changedID, "{\"type\":\"Box\"}");
+        journal.append(OctreeJournal::RECORD_DELETED, deletedID);
+        journal.sync();
+    }
+    {
+        // reopening appends after what is already there
+        OctreeJournal journal;
+        journal.open(testJournalFilename());
+        journal.append(OctreeJournal::RECORD_CHANGED, changedID, "{\"type\":\"Sphere\"}");
+    }
+
+    QVector<OctreeJournal::Record> records;
+    bool read = OctreeJournal::readRecords(testJournalFilename(), records);
+    if (read && records.size() == 3
+            && records[0].type == OctreeJournal::RECORD_CHANGED && records[0].id == changedID
+            && records[0].data == "{\"type\":\"Box\"}"
+            && records[1].type == OctreeJournal::RECORD_DELETED && records[1].id == deletedID && records[1].data.isEmpty()
+            && records[2].id == changedID && records[2].data == "{\"type\":\"Sphere\"}") {
+        qDebug() << "appendAndRead: PASSED";
+    } else {
+        qDebug() << "appendAndRead: FAILED read=" << read << "records=" << records.size();
+    }
+    removeTestJournals();
+}
+
+void OctreeJournalTests::tornRecord(bool verbose) {
+    qDebug() << "******************************************************************************************";
+    qDebug() << "OctreeJournalTests::tornRecord()";
+
+    removeTestJournals();
+    {
+        OctreeJournal journal;
+        journal.open(testJournalFilename());
+        journal.append(OctreeJournal::RECORD_CHANGED, QUuid::createUuid(), "{\"type\":\"Box\"}");
+        journal.append(OctreeJournal::RECORD_CHANGED, QUuid::createUuid(), "{\"type\":\"Sphere\"}");
+    }
+
+    // cut the last record short, like a crash in the middle of a write would
+    QFile file(testJournalFilename());
+    file.resize(file.size() - 3);
+
+    QVector<OctreeJournal::Record> records;
+    bool read = OctreeJournal::readRecords(testJournalFilename(), records);
+    if (read && records.size() == 1 && records[0].data == "{\"type\":\"Box\"}") {
+        qDebug() << "tornRecord: PASSED";
+    } else {
+        qDebug() << "tornRecord: FAILED read=" << read << "records=" << records.size();
+    }
+    removeTestJournals();
+}
+
+void OctreeJournalTests::rollAndRemove(bool verbose) {
+    qDebug() << "******************************************************************************************";
+    qDebug() << "OctreeJournalTests::rollAndRemove()";
+
+    removeTestJournals();
+    OctreeJournal journal;
+    journal.open(testJournalFilename());
+    journal.append(OctreeJournal::RECORD_DELETED, QUuid::createUuid());
+    journal.roll();
+    journal.append(OctreeJournal::RECORD_DELETED, QUuid::createUuid());
+
+    // a second roll before the rolled journal is removed keeps appending to the current one
+    journal.roll();
+    journal.append(OctreeJournal::RECORD_DELETED, QUuid::createUuid());
+    journal.sync();
+
+    QVector<OctreeJournal::Record> rolledRecords;
+    QVector<OctreeJournal::Record> currentRecords;
+    OctreeJournal::readRecords(journal.getRolledFilename(), rolledRecords);
+    OctreeJournal::readRecords(journal.getFilename(), currentRecords);
+    bool removed = journal.removeRolled() && !QFile::exists(journal.getRolledFilename());
+
+    if (rolledRecords.size() == 1 && currentRecords.size() == 2 && journal.getNumRecords() == 2 && removed) {
+        qDebug() << "rollAndRemove: PASSED";
+    } else {
+        qDebug() << "rollAndRemove: FAILED rolled=" << rolledRecords.size() << "current=" << currentRecords.size()
+            << "removed=" << removed;
+    }
+    journal.close();
+    removeTestJournals();
+}
+
+void OctreeJournalTests::runAllTests(bool verbose) {
+    appendAndRead(verbose);
+    tornRecord(verbose);
+    rollAndRemove(verbose);
+}
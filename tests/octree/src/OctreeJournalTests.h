@@ -0,0 +1,22 @@
+//
+//  OctreeJournalTests.h
+//  tests/octree/src
+//
+//  Created on 2015-06-13.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournalTests_h
+#define hifi_OctreeJournalTests_h
+
+namespace OctreeJournalTests {
+    void appendAndRead(bool verbose);
+    void tornRecord(bool verbose);
+    void rollAndRemove(bool verbose);
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_OctreeJournalTests_h
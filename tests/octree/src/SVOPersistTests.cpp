@@ -0,0 +1,173 @@
+//
+//  SVOPersistTests.cpp
+//  tests/octree/src
+//
+//  Created on 2015-06-20.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QThread>
+
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <SharedUtil.h>
+
+#include "SVOPersistTests.h"
+
+static QString testSVOFilename() {
+    return QDir::temp().filePath("SVOPersistTests.svo");
+}
+
+// splits the data section of an SVO file into its chunks, the way Octree::readSVOFromStream() does
+static bool chunksFromSVOFile(const QByteArray& fileData, const EntityTree& tree, PacketVersion& version,
+                              QVector<BitstreamChunk>& chunks) {
+    const int HEADER_LENGTH = sizeof(PacketType) + sizeof(PacketVersion);
+    if (fileData.size() < HEADER_LENGTH) {
+        return false;
+    }
+    PacketType type;
+    memcpy(&type, fileData.constData(), sizeof(type));
+    version = fileData.at(sizeof(type));
+    if (type != tree.expectedDataPacketType() || !tree.versionHasSVOfileBreaks(version)) {
+        return false;
+    }
+
+    const unsigned char* dataAt = reinterpret_cast<const unsigned char*>(fileData.constData()) + HEADER_LENGTH;
+    unsigned long remainingLength = fileData.size() - HEADER_LENGTH;
+    while (remainingLength > 0) {
+        quint16 chunkLength = 0;
+        if (remainingLength < sizeof(chunkLength)) {
+            return false;
+        }
+        memcpy(&chunkLength, dataAt, sizeof(chunkLength));
+        dataAt += sizeof(chunkLength);
+        remainingLength -= sizeof(chunkLength);
+        if (chunkLength > remainingLength) {
+            return false;
+        }
+        BitstreamChunk chunk = { dataAt, chunkLength };
+        chunks.append(chunk);
+        dataAt += chunkLength;
+        remainingLength -= chunkLength;
+    }
+    return true;
+}
+
+// the properties of every entity in the tree by ID, along with the cube of the element it ended up in
+static QMap<QString, QVariantMap> describeEntities(EntityTree& tree) {
+    QMap<QString, QVariantMap> descriptions;
+    tree.writeToVariants(NULL, false, [&](const QVariantList& items) {
+        foreach (const QVariant& item, items) {
+            QVariantMap description = item.toMap();
+            // the age is measured when the entity is described, not when it was decoded
+            description.remove("age");
+            description.remove("ageAsText");
+            descriptions.insert(description["id"].toString(), description);
+        }
+    });
+
+    for (auto iterator = descriptions.begin(); iterator != descriptions.end(); ++iterator) {
+        EntityTreeElement* element = tree.getContainingElement(EntityItemID(QUuid(iterator.key())));
+        if (element) {
+            const AACube& cube = element->getAACube();
+            iterator.value()["elementCorner"] = QVariantList() << cube.getCorner().x << cube.getCorner().y
+                << cube.getCorner().z;
+            iterator.value()["elementScale"] = cube.getScale();
+        }
+    }
+    return descriptions;
+}
+
+void SVOPersistTests::parallelChunkDecodeMatchesSerial(bool verbose) {
+    qDebug() << "testing SVO chunks decoded in parallel give the same entities as decoded one after another...";
+    bool fail = false;
+
+    const int NUM_ENTITIES = 2000;
+    int numChunks = 0;
+    {
+        EntityTree tree;
+        tree.setIsServer(true);
+        tree.lockForWrite();
+        for (int i = 0; i < NUM_ENTITIES; i++) {
+            EntityItemProperties properties;
+            properties.setType(i % 2 ? EntityTypes::Box : EntityTypes::Sphere);
+            properties.setName(QString("chunked entity %1").arg(i));
+            properties.setPosition(glm::vec3(randFloatInRange(0.0f, 1000.0f), randFloatInRange(0.0f, 100.0f),
+                                             randFloatInRange(0.0f, 1000.0f)));
+            properties.setDimensions(glm::vec3(randFloatInRange(0.1f, 20.0f)));
+            xColor color = { (unsigned char)(i % 256), 128, 255 };
+            properties.setColor(color);
+            tree.addEntity(EntityItemID(QUuid::createUuid()), properties);
+        }
+        tree.unlock();
+        tree.writeToSVOFile(qPrintable(testSVOFilename()));
+    }
+
+    QFile file(testSVOFilename());
+    file.open(QIODevice::ReadOnly);
+    QByteArray fileData = file.readAll();
+    file.close();
+
+    EntityTree parallelTree;
+    EntityTree serialTree;
+    PacketVersion version;
+    QVector<BitstreamChunk> chunks;
+    if (!chunksFromSVOFile(fileData, parallelTree, version, chunks)) {
+        qDebug() << "\t\t couldn't split the saved file into chunks";
+        fail = true;
+    }
+    numChunks = chunks.size();
+    if (numChunks < 2) {
+        qDebug() << "\t\t the saved file has" << numChunks << "chunks, the parallel decode needs at least 2";
+        fail = true;
+    }
+    if (QThread::idealThreadCount() < 2) {
+        qDebug() << "\t\t only one core, both trees are decoded serially";
+    }
+
+    parallelTree.setIsServer(true);
+    parallelTree.lockForWrite();
+    ReadBitstreamToTreeParams parallelArgs(WANT_COLOR, NO_EXISTS_BITS, NULL, 0, SharedNodePointer(), false, version);
+    parallelTree.readBitstreamChunksToTree(chunks, parallelArgs);
+    parallelTree.unlock();
+
+    serialTree.setIsServer(true);
+    serialTree.lockForWrite();
+    ReadBitstreamToTreeParams serialArgs(WANT_COLOR, NO_EXISTS_BITS, NULL, 0, SharedNodePointer(), false, version);
+    serialTree.Octree::readBitstreamChunksToTree(chunks, serialArgs);
+    serialTree.unlock();
+
+    QMap<QString, QVariantMap> parallelEntities = describeEntities(parallelTree);
+    QMap<QString, QVariantMap> serialEntities = describeEntities(serialTree);
+    if (serialEntities.size() != NUM_ENTITIES || parallelEntities.size() != NUM_ENTITIES) {
+        qDebug() << "\t\t decoded" << parallelEntities.size() << "entities in parallel and" << serialEntities.size()
+            << "serially out of" << NUM_ENTITIES;
+        fail = true;
+    }
+    for (auto iterator = serialEntities.constBegin(); iterator != serialEntities.constEnd(); ++iterator) {
+        if (parallelEntities.value(iterator.key()) != iterator.value()) {
+            if (verbose) {
+                qDebug() << "\t\t entity" << iterator.key() << "differs:" << parallelEntities.value(iterator.key())
+                    << "decoded in parallel," << iterator.value() << "decoded serially";
+            }
+            fail = true;
+        }
+    }
+
+    if (verbose) {
+        qDebug() << "\t\t" << NUM_ENTITIES << "entities in" << numChunks << "chunks";
+    }
+    qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+    QFile::remove(testSVOFilename());
+}
+
+void SVOPersistTests::runAllTests(bool verbose) {
+    parallelChunkDecodeMatchesSerial(verbose);
+}
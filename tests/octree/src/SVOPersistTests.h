@@ -0,0 +1,20 @@
+//
+//  SVOPersistTests.h
+//  tests/octree/src
+//
+//  Created on 2015-06-20.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SVOPersistTests_h
+#define hifi_SVOPersistTests_h
+
+namespace SVOPersistTests {
+    void parallelChunkDecodeMatchesSerial(bool verbose);
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_SVOPersistTests_h
@@ -0,0 +1,110 @@
+//
+//  ViewFrustumTests.cpp
+//  tests/octree/src
+//
+//  Created on 2015-06-16.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <vector>
+
+#include <QDebug>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+#include "ViewFrustumTests.h"
+
+static void checkBoxesOutsidePlanes(float keyholeRadius, bool verbose) {
+    ViewFrustum frustum;
+    frustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                           DEFAULT_NEAR_CLIP, 1000.0f));
+    glm::vec3 position(100.0f, 50.0f, 100.0f);
+    frustum.setPosition(position);
+    frustum.setOrientation(glm::angleAxis(0.7f, glm::normalize(glm::vec3(0.2f, 1.0f, 0.1f))));
+    frustum.setKeyholeRadius(keyholeRadius);
+    frustum.calculate();
+
+    // boxes of all sizes all around the camera, so that plenty land inside, outside and across the planes, and some
+    // right next to the camera, where the keyhole is
+    const int NUM_BOXES = 10000;
+    std::vector<float> cornerX(NUM_BOXES), cornerY(NUM_BOXES), cornerZ(NUM_BOXES);
+    std::vector<float> scaleX(NUM_BOXES), scaleY(NUM_BOXES), scaleZ(NUM_BOXES);
+    std::vector<AABox> boxes;
+    for (int i = 0; i < NUM_BOXES; i++) {
+        glm::vec3 corner;
+        float size;
+        if (i % 10 == 0) {
+            corner = position + glm::vec3(randFloatInRange(-5.0f, 5.0f), randFloatInRange(-5.0f, 5.0f),
+                                          randFloatInRange(-5.0f, 5.0f));
+            size = randFloatInRange(0.01f, 2.0f);
+        } else {
+            corner = glm::vec3(randFloatInRange(-500.0f, 700.0f), randFloatInRange(-500.0f, 600.0f),
+                               randFloatInRange(-500.0f, 700.0f));
+            size = randFloatInRange(0.01f, 1.0f) * (i % 3 == 0 ? 200.0f : 2.0f);
+        }
+        glm::vec3 scale(size * randFloatInRange(0.5f, 1.0f), size, size * randFloatInRange(0.2f, 1.0f));
+        cornerX[i] = corner.x;
+        cornerY[i] = corner.y;
+        cornerZ[i] = corner.z;
+        scaleX[i] = scale.x;
+        scaleY[i] = scale.y;
+        scaleZ[i] = scale.z;
+        boxes.push_back(AABox(corner, scale));
+    }
+
+    std::vector<unsigned char> outside(NUM_BOXES);
+    frustum.boxesOutsidePlanes(NUM_BOXES, cornerX.data(), cornerY.data(), cornerZ.data(),
+                               scaleX.data(), scaleY.data(), scaleZ.data(), outside.data());
+
+    // what the render cull does, the boxes outside of the planes may still be in the keyhole
+    int numInKeyhole = 0;
+    if (keyholeRadius >= 0.0f) {
+        for (int i = 0; i < NUM_BOXES; i++) {
+            if (outside[i] && frustum.boxInKeyhole(boxes[i]) != ViewFrustum::OUTSIDE) {
+                outside[i] = 0;
+                numInKeyhole++;
+            }
+        }
+    }
+
+    int mismatches = 0;
+    int numOutside = 0;
+    for (int i = 0; i < NUM_BOXES; i++) {
+        bool expectedOutside = frustum.boxInFrustum(boxes[i]) == ViewFrustum::OUTSIDE;
+        numOutside += expectedOutside ? 1 : 0;
+        if ((outside[i] != 0) != expectedOutside) {
+            if (verbose) {
+                qDebug() << "mismatch at box" << i << boxes[i] << "expected outside:" << expectedOutside;
+            }
+            mismatches++;
+        }
+    }
+
+    bool keyholeTested = keyholeRadius < 0.0f || numInKeyhole > 0;
+    if (mismatches == 0 && numOutside > 0 && numOutside < NUM_BOXES && keyholeTested) {
+        qDebug() << "boxesOutsidePlanesMatchesBoxInFrustum: PASSED keyholeRadius=" << keyholeRadius
+            << numOutside << "of" << NUM_BOXES << "outside," << numInKeyhole << "saved by the keyhole";
+    } else {
+        qDebug() << "boxesOutsidePlanesMatchesBoxInFrustum: FAILED keyholeRadius=" << keyholeRadius
+            << "mismatches=" << mismatches << "outside=" << numOutside << "of" << NUM_BOXES
+            << "in keyhole=" << numInKeyhole;
+    }
+}
+
+void ViewFrustumTests::boxesOutsidePlanesMatchesBoxInFrustum(bool verbose) {
+    qDebug() << "******************************************************************************************";
+    qDebug() << "ViewFrustumTests::boxesOutsidePlanesMatchesBoxInFrustum()";
+
+    checkBoxesOutsidePlanes(-1.0f, verbose); // the planes alone
+    checkBoxesOutsidePlanes(DEFAULT_KEYHOLE_RADIUS, verbose); // what the interface uses
+}
+
+void ViewFrustumTests::runAllTests(bool verbose) {
+    boxesOutsidePlanesMatchesBoxInFrustum(verbose);
+}
@@ -0,0 +1,20 @@
+//
+//  ViewFrustumTests.h
+//  tests/octree/src
+//
+//  Created on 2015-06-16.
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ViewFrustumTests_h
+#define hifi_ViewFrustumTests_h
+
+namespace ViewFrustumTests {
+    void boxesOutsidePlanesMatchesBoxInFrustum(bool verbose);
+    void runAllTests(bool verbose);
+}
+
+#endif // hifi_ViewFrustumTests_h
@@ -9,9 +9,15 @@
 //
 
 #include "AABoxCubeTests.h"
+#include "EntitySimulationTests.h"
+#include "ItemSpatialTreeTests.h"
+#include "JSONPersistBenchmarks.h"
 #include "ModelTests.h" // needs to be EntityTests.h soon
+#include "OctreeJournalTests.h"
 #include "OctreeTests.h"
 #include "SharedUtil.h"
+#include "SVOPersistTests.h"
+#include "ViewFrustumTests.h"
 
 int main(int argc, const char* argv[]) {
     const char* VERBOSE = "--verbose";
@@ -20,5 +26,11 @@ int main(int argc, const char* argv[]) {
     //OctreeTests::runAllTests(verbose);
     //AABoxCubeTests::runAllTests(verbose);
     EntityTests::runAllTests(verbose);
+    EntitySimulationTests::runAllTests(verbose);
+    OctreeJournalTests::runAllTests(verbose);
+    SVOPersistTests::runAllTests(verbose);
+    JSONPersistBenchmarks::runAllTests(verbose);
+    ViewFrustumTests::runAllTests(verbose);
+    ItemSpatialTreeTests::runAllTests(verbose);
     return 0;
 }
@@ -0,0 +1,97 @@
+//
+//  GLMHelpersTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QDebug>
+#include <QVector>
+
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
+#include "GLMHelpersTests.h"
+
+static glm::mat4 randMatrix() {
+    glm::mat4 matrix;
+    for (int i = 0; i < 4; i++) {
+        matrix[i] = glm::vec4(randFloatInRange(-10.0f, 10.0f), randFloatInRange(-10.0f, 10.0f),
+                              randFloatInRange(-10.0f, 10.0f), randFloatInRange(-10.0f, 10.0f));
+    }
+    return matrix;
+}
+
+static void testPaletteMultiply() {
+    qDebug() << "testing palette matrix multiply...";
+
+    const int NUM_PALETTE_MATRICES = 16;
+    const int NUM_MATRICES = 1000;
+
+    QVector<glm::mat4> palette;
+    for (int i = 0; i < NUM_PALETTE_MATRICES; i++) {
+        palette.append(randMatrix());
+    }
+    QVector<int> paletteIndices;
+    QVector<glm::mat4> matrices;
+    for (int i = 0; i < NUM_MATRICES; i++) {
+        paletteIndices.append(randIntInRange(0, NUM_PALETTE_MATRICES - 1));
+        matrices.append(randMatrix());
+    }
+    QVector<glm::mat4> results(NUM_MATRICES);
+    multiplyPaletteMatrices(palette.constData(), paletteIndices.constData(), matrices.constData(), results.data(),
+                            NUM_MATRICES);
+
+    // the products must match glm's to the bit, so skinning looks the same whichever path computed it
+    for (int i = 0; i < NUM_MATRICES; i++) {
+        if (results.at(i) != palette.at(paletteIndices.at(i)) * matrices.at(i)) {
+            qDebug() << "\t\t FAIL for product" << i;
+            return;
+        }
+    }
+    qDebug() << "\t\t PASS";
+}
+
+void GLMHelpersTests::runAllTests() {
+    testPaletteMultiply();
+
+    qDebug() << "testing smallest three quaternion packing...";
+
+    // 15 bits over +/- 1/sqrt(2) is good to well under a tenth of a degree
+    const float MAX_ANGLE_ERROR = 0.002f;
+    const int NUM_QUATS = 10000;
+
+    bool fail = false;
+    for (int i = 0; i < NUM_QUATS && !fail; i++) {
+        glm::quat original;
+        if (i < 4) {
+            // make sure each component gets a turn at being the largest, with both signs
+            float components[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            components[i] = (i % 2 == 0) ? 1.0f : -1.0f;
+            original = glm::quat(components[3], components[0], components[1], components[2]);
+        } else {
+            original = glm::normalize(glm::quat(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f),
+                                                randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f)));
+        }
+
+        unsigned char buffer[SMALLEST_THREE_QUAT_BYTES];
+        glm::quat unpacked;
+        int bytesPacked = packOrientationQuatToSixBytes(buffer, original);
+        int bytesUnpacked = unpackOrientationQuatFromSixBytes(buffer, unpacked);
+
+        float angle = 2.0f * acosf(glm::min(1.0f, fabsf(glm::dot(original, unpacked))));
+        if (bytesPacked != SMALLEST_THREE_QUAT_BYTES || bytesUnpacked != SMALLEST_THREE_QUAT_BYTES
+            || angle > MAX_ANGLE_ERROR) {
+            qDebug() << "\t\t FAIL for quat" << original.w << original.x << original.y << original.z
+                << "which came back off by" << angle << "radians";
+            fail = true;
+        }
+    }
+
+    if (!fail) {
+        qDebug() << "\t\t PASS";
+    }
+}
@@ -0,0 +1,19 @@
+//
+//  GLMHelpersTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_GLMHelpersTests_h
+#define hifi_GLMHelpersTests_h
+
+namespace GLMHelpersTests {
+
+    void runAllTests();
+}
+
+#endif // hifi_GLMHelpersTests_h
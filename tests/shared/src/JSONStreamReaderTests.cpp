@@ -0,0 +1,102 @@
+//
+//  JSONStreamReaderTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QBuffer>
+#include <QDebug>
+#include <QJsonDocument>
+
+#include <JSONStreamReader.h>
+
+#include "JSONStreamReaderTests.h"
+
+static bool readsLikeQJsonDocument(const QByteArray& json) {
+    QBuffer buffer;
+    buffer.setData(json);
+    buffer.open(QIODevice::ReadOnly);
+    JSONStreamReader reader(buffer);
+
+    QVariant value;
+    bool read = reader.readValue(value);
+    if (!read) {
+        qDebug() << reader.getError();
+    }
+    return read && value == QJsonDocument::fromJson(json).toVariant();
+}
+
+void JSONStreamReaderTests::runAllTests() {
+    {
+        qDebug() << "testing JSON stream reader against QJsonDocument...";
+
+        bool fail = !readsLikeQJsonDocument("{ \"a\": [1, -2.5, 3e2, true, false, null], \"b\": { \"c\": \"d\" }, \"e\": [] }")
+            || !readsLikeQJsonDocument("[\"tab\\there\", \"quote\\\"\", \"slash\\/\", \"\\u00e9\\u4e2d\", \"\\ud83d\\ude00\"]")
+            || !readsLikeQJsonDocument(QString::fromUtf8("{\"utf8\": \"\xc3\xa9\xe4\xb8\xad\"}").toUtf8())
+            || !readsLikeQJsonDocument("  {\n\t\"nested\": [[[{}]], {\"x\": [0.125]}]\r\n}  ");
+
+        // big enough that strings and numbers straddle the reads from the device
+        QByteArray big = "[";
+        for (int i = 0; i < 20000; i++) {
+            big += QString("%1{\"name\": \"entity number %2 \\u00e9\", \"position\": [%3, %4]}")
+                .arg(i == 0 ? "" : ",").arg(i).arg(i * 0.5).arg(-i).toUtf8();
+        }
+        big += "]";
+        fail = fail || !readsLikeQJsonDocument(big);
+
+        qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+    }
+
+    {
+        qDebug() << "testing JSON stream reader stepping through a document...";
+
+        QBuffer buffer;
+        buffer.setData("{\"Version\": 3, \"Skipped\": {\"deep\": [1, 2, {\"x\": \"y\"}]}, \"Entities\": [{\"id\": 1}, {\"id\": 2}]}");
+        buffer.open(QIODevice::ReadOnly);
+        JSONStreamReader reader(buffer);
+
+        QString key;
+        QVariant value;
+        QVariantList entities;
+        int version = 0;
+        reader.beginObject();
+        while (reader.nextKey(key)) {
+            if (key == "Entities" && reader.beginArray()) {
+                while (reader.nextElement() && reader.readValue(value)) {
+                    entities << value;
+                }
+            } else if (key == "Version" && reader.readValue(value)) {
+                version = value.toInt();
+            } else {
+                reader.skipValue();
+            }
+        }
+
+        bool fail = reader.hasError() || version != 3 || entities.size() != 2
+            || entities[1].toMap()["id"].toInt() != 2;
+        qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+    }
+
+    {
+        qDebug() << "testing JSON stream reader on broken documents...";
+
+        const char* brokenDocuments[] = { "{\"a\": [1, 2", "{\"a\" 1}", "[1,, 2]", "\"unterminated", "[tru]", "{\"a\": \"\\x\"}" };
+        bool fail = false;
+        for (const char* document : brokenDocuments) {
+            QBuffer buffer;
+            buffer.setData(document);
+            buffer.open(QIODevice::ReadOnly);
+            JSONStreamReader reader(buffer);
+            QVariant value;
+            if (reader.readValue(value) || !reader.hasError()) {
+                qDebug() << "read broken document:" << document;
+                fail = true;
+            }
+        }
+        qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+    }
+}
@@ -0,0 +1,113 @@
+//
+//  MPSCRingBufferTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <thread>
+#include <vector>
+
+#include <QDebug>
+
+#include <MPSCRingBuffer.h>
+
+#include "MPSCRingBufferTests.h"
+
+void MPSCRingBufferTests::runAllTests() {
+    {
+        qDebug() << "testing MPSC ring buffer with a single thread...";
+
+        bool fail = false;
+        MPSCRingBuffer<int> ring(5);
+        if (ring.getCapacity() != 8) {
+            fail = true;
+        }
+
+        // go around the ring a few times, filling it each lap
+        int nextPushed = 0;
+        int nextPopped = 0;
+        for (int lap = 0; lap < 4 && !fail; lap++) {
+            while (ring.push([&](int& value) { value = nextPushed; })) {
+                nextPushed++;
+            }
+            if (ring.size() != ring.getCapacity()) {
+                fail = true;
+            }
+            while (ring.pop([&](int& value) {
+                if (value != nextPopped) {
+                    fail = true;
+                }
+                nextPopped++;
+            })) {
+            }
+            if (!ring.isEmpty()) {
+                fail = true;
+            }
+        }
+
+        if (nextPushed != nextPopped || nextPushed != 4 * ring.getCapacity()) {
+            fail = true;
+        }
+
+        qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+    }
+
+    {
+        qDebug() << "testing MPSC ring buffer with several producer threads...";
+
+        const int NUM_PRODUCERS = 4;
+        const int VALUES_PER_PRODUCER = 100000;
+
+        struct Entry {
+            int producer;
+            int value;
+        };
+        MPSCRingBuffer<Entry> ring(64);
+
+        std::vector<std::thread> producers;
+        for (int producer = 0; producer < NUM_PRODUCERS; producer++) {
+            producers.push_back(std::thread([&ring, producer]() {
+                for (int value = 0; value < VALUES_PER_PRODUCER; value++) {
+                    while (!ring.push([&](Entry& entry) {
+                        entry.producer = producer;
+                        entry.value = value;
+                    })) {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+        }
+
+        // every producer's values have to come out in the order it pushed them
+        bool fail = false;
+        std::vector<int> nextValues(NUM_PRODUCERS, 0);
+        int numPopped = 0;
+        while (numPopped < NUM_PRODUCERS * VALUES_PER_PRODUCER) {
+            bool popped = ring.pop([&](Entry& entry) {
+                if (entry.value != nextValues[entry.producer]) {
+                    fail = true;
+                }
+                nextValues[entry.producer] = entry.value + 1;
+            });
+            if (popped) {
+                numPopped++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        for (size_t i = 0; i < producers.size(); i++) {
+            producers[i].join();
+        }
+
+        if (!ring.isEmpty()) {
+            fail = true;
+        }
+
+        qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+    }
+}
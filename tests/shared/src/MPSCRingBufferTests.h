@@ -0,0 +1,19 @@
+//
+//  MPSCRingBufferTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MPSCRingBufferTests_h
+#define hifi_MPSCRingBufferTests_h
+
+namespace MPSCRingBufferTests {
+
+    void runAllTests();
+}
+
+#endif // hifi_MPSCRingBufferTests_h
@@ -0,0 +1,110 @@
+//
+//  SpatialHashGridTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cfloat>
+
+#include <QDebug>
+#include <QVector>
+
+#include <SpatialHashGrid.h>
+#include <SharedUtil.h>
+
+#include "SpatialHashGridTests.h"
+
+void SpatialHashGridTests::runAllTests() {
+    const int NUM_POSITIONS = 1000;
+    const float WORLD_SIZE = 200.0f;
+    const float CELL_SIZE = 8.0f;
+
+    QVector<glm::vec3> positions;
+    SpatialHashGrid<int> grid(CELL_SIZE);
+
+    for (int i = 0; i < NUM_POSITIONS; i++) {
+        glm::vec3 position = glm::vec3(randFloat(), randFloat(), randFloat()) * WORLD_SIZE - glm::vec3(WORLD_SIZE / 2.0f);
+        positions.append(position);
+        grid.insert(position, i);
+    }
+
+    QVector<float> radii;
+    radii.append(0.0f);
+    radii.append(1.0f);
+    radii.append(CELL_SIZE);
+    radii.append(30.0f);
+    radii.append(WORLD_SIZE);
+    radii.append(FLT_MAX);
+
+    foreach (float radius, radii) {
+        qDebug() << "testing spatial hash grid query with radius" << radius << "...";
+
+        bool fail = false;
+
+        for (int query = 0; query < 20 && !fail; query++) {
+            glm::vec3 center = positions[query];
+
+            QVector<bool> found(NUM_POSITIONS, false);
+            grid.eachWithinRadius(center, radius, [&](const int& value, const glm::vec3& position, float distance) {
+                found[value] = true;
+            });
+
+            for (int i = 0; i < NUM_POSITIONS; i++) {
+                bool shouldBeFound = glm::length(positions[i] - center) <= radius;
+                if (found[i] != shouldBeFound) {
+                    qDebug() << "\t\t FAIL for position" << i << "around query" << query;
+                    fail = true;
+                    break;
+                }
+            }
+        }
+
+        if (!fail) {
+            qDebug() << "\t\t PASS";
+        }
+    }
+
+    {
+        qDebug() << "testing spatial hash grid cell bookkeeping...";
+
+        int numEntries = 0;
+        bool fail = false;
+        grid.eachCell([&](const SpatialHashGrid<int>::Cell& cell) {
+            numEntries += cell.numEntries;
+            grid.eachEntryInCell(cell, [&](const int& value, const glm::vec3& position)->bool {
+                if (grid.getMinDistanceToCell(position, cell) != 0.0f) {
+                    fail = true;
+                }
+                return true;
+            });
+        });
+
+        if (numEntries != grid.getNumEntries()) {
+            fail = true;
+        }
+
+        // a sample of every entry from the middle wraps around and sees each one once, along with its own cell
+        QVector<int> timesSampled(NUM_POSITIONS, 0);
+        grid.eachEntryFrom(NUM_POSITIONS / 2, NUM_POSITIONS,
+                           [&](const int& value, const glm::vec3& position, const SpatialHashGrid<int>::Cell& cell) {
+            timesSampled[value]++;
+            if (position != positions[value] || grid.getMinDistanceToCell(position, cell) != 0.0f) {
+                fail = true;
+            }
+        });
+        if (timesSampled != QVector<int>(NUM_POSITIONS, 1)) {
+            fail = true;
+        }
+
+        grid.clear();
+        if (grid.getNumEntries() != 0 || grid.getNumCells() != 0) {
+            fail = true;
+        }
+
+        qDebug() << (fail ? "\t\t FAIL" : "\t\t PASS");
+    }
+}
@@ -0,0 +1,19 @@
+//
+//  SpatialHashGridTests.h
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SpatialHashGridTests_h
+#define hifi_SpatialHashGridTests_h
+
+namespace SpatialHashGridTests {
+
+    void runAllTests();
+}
+
+#endif // hifi_SpatialHashGridTests_h
@@ -9,13 +9,21 @@
 //
 
 #include "AngularConstraintTests.h"
+#include "GLMHelpersTests.h"
+#include "JSONStreamReaderTests.h"
 #include "MovingPercentileTests.h"
+#include "MPSCRingBufferTests.h"
 #include "MovingMinMaxAvgTests.h"
+#include "SpatialHashGridTests.h"
 
 int main(int argc, char** argv) {
     MovingMinMaxAvgTests::runAllTests();
     MovingPercentileTests::runAllTests();
     AngularConstraintTests::runAllTests();
+    SpatialHashGridTests::runAllTests();
+    MPSCRingBufferTests::runAllTests();
+    GLMHelpersTests::runAllTests();
+    JSONStreamReaderTests::runAllTests();
     printf("tests complete, press enter to exit\n");
     getchar();
     return 0;